@@ -0,0 +1,63 @@
+///
+///     @file BenchmarkUtilities.h
+///     @brief Timing helpers shared by the micro-benchmarks.
+///     @date October 18, 2026
+///
+///     Each measurement runs its body a few times and keeps the fastest
+///     run, which takes out most of the noise from the rest of the system.
+///     Results go through keepResult() so the compiler can't drop the work
+///     that produced them.
+///
+///     Numbers are only meaningful in a release build, on a quiet machine
+///     with frequency scaling fixed.
+///
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+
+
+namespace benchmark
+{
+    constexpr int NUM_RUNS = 7;
+
+    // Stops the compiler from optimising away the computation of value
+    template<typename T>
+    inline void keepResult(const T& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "g"(&value) : "memory");
+#else
+        static volatile const T* sink;
+        sink = &value;
+#endif
+    }
+
+    // Run body() NUM_RUNS times and return the fastest run's time in
+    // nanoseconds per item, for body() doing numItems of work
+    template<typename Body>
+    double measureNsPerItem(long long numItems, Body&& body)
+    {
+        double fastest = std::numeric_limits<double>::max();
+
+        for (int run = 0; run < NUM_RUNS; run++)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            body();
+            const std::chrono::duration<double, std::nano> elapsed
+                                            = std::chrono::steady_clock::now() - start;
+
+            fastest = std::min(fastest, elapsed.count());
+        }
+
+        return fastest / static_cast<double>(numItems);
+    }
+
+    inline void printRow(const char* name, double nsPerItem, const char* unit)
+    {
+        std::printf("  %-44s %9.2f ns %s\n", name, nsPerItem, unit);
+    }
+}
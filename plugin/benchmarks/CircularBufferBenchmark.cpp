@@ -0,0 +1,146 @@
+///
+///     @file CircularBufferBenchmark.cpp
+///     @brief CircularBuffer's mirrored backend against the masked one.
+///     @date October 18, 2026
+///
+///     The masked backend splits a block at the wrap point and masks both
+///     neighbours of an interpolated read; the mirrored backend does
+///     neither. Each backend is timed on:
+///
+///     - pushBlock() then readBlock() at a fixed delay, as a delay line
+///       does each block (ns per sample),
+///     - interpolate() at several slowly moving fractional delays, as a
+///       multi-tap or modulated read does (ns per tap).
+///
+///     Options:
+///
+///         --size N        buffer size in samples, a power of 2 (default 65536)
+///         --block-size B  samples per block (default 128)
+///         --taps T        interpolated taps per sample (default 8)
+///
+///     If the mirrored buffer can't be mapped (another platform, or a size
+///     that isn't a whole number of pages) its rows are skipped.
+///
+
+#include "BenchmarkUtilities.h"
+#include "DelayPlugin/DSP/CircularBuffer.h"
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+    // Samples pushed per measured run
+    constexpr long long SAMPLES_PER_RUN = 1 << 22;
+
+    struct Options
+    {
+        size_t size = 65536;
+        size_t blockSize = 128;
+        size_t numTaps = 8;
+    };
+
+    double measureBlocks(CircularBuffer<float>& buffer, const Options& options)
+    {
+        std::vector<float> input(options.blockSize), output(options.blockSize);
+
+        for (size_t i = 0; i < input.size(); i++)
+            input[i] = static_cast<float>(i) * 1.0e-3f;
+
+        // The oldest block that still fits, so reads wrap as often as writes
+        const size_t readIndex = 0;
+        const long long numBlocks = SAMPLES_PER_RUN / static_cast<long long>(options.blockSize);
+
+        return benchmark::measureNsPerItem(numBlocks * static_cast<long long>(options.blockSize), [&]
+        {
+            for (long long block = 0; block < numBlocks; block++)
+            {
+                buffer.pushBlock(input.data(), input.size());
+                buffer.readBlock(readIndex, output.data(), output.size());
+                benchmark::keepResult(output[0]);
+            }
+        });
+    }
+
+    double measureTaps(CircularBuffer<float>& buffer, const Options& options)
+    {
+        // Taps spread over the buffer, each drifting by a fraction of a
+        // sample per sample, so they cross the wrap point now and then
+        std::vector<float> delays(options.numTaps);
+        const float maxDelay = static_cast<float>(buffer.getSize() - 2);
+
+        for (size_t tap = 0; tap < delays.size(); tap++)
+            delays[tap] = maxDelay * static_cast<float>(tap + 1) / static_cast<float>(delays.size() + 1);
+
+        const long long numSamples = SAMPLES_PER_RUN / static_cast<long long>(options.numTaps);
+
+        return benchmark::measureNsPerItem(numSamples * static_cast<long long>(options.numTaps), [&]
+        {
+            float sum = 0.0f;
+
+            for (long long i = 0; i < numSamples; i++)
+            {
+                for (auto& delay : delays)
+                {
+                    sum += buffer.interpolate(delay);
+                    delay += 0.37f;
+
+                    if (delay >= maxDelay)
+                        delay -= maxDelay;
+                }
+
+                buffer.push(sum * 1.0e-6f);
+            }
+
+            benchmark::keepResult(sum);
+        });
+    }
+}
+
+
+int main(int argc, char* argv[])
+{
+    Options options;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string option(argv[i]);
+        const std::string value(argv[i + 1]);
+
+        if (option == "--size")
+            options.size = static_cast<size_t>(juce::nextPowerOfTwo(std::max(std::stoi(value), 16)));
+        else if (option == "--block-size")
+            options.blockSize = static_cast<size_t>(std::max(std::stoi(value), 1));
+        else if (option == "--taps")
+            options.numTaps = static_cast<size_t>(std::max(std::stoi(value), 1));
+        else
+        {
+            std::fprintf(stderr, "Unknown option %s\n", option.c_str());
+            return 1;
+        }
+    }
+
+    options.blockSize = std::min(options.blockSize, options.size);
+
+    CircularBuffer<float> masked(options.size);
+    CircularBuffer<float> mirrored(options.size, 0.0f, true);
+
+    std::printf("CircularBuffer<float>, %zu samples, blocks of %zu, %zu taps\n\n",
+                options.size, options.blockSize, options.numTaps);
+
+    benchmark::printRow("pushBlock + readBlock, masked", measureBlocks(masked, options), "per sample");
+
+    if (mirrored.isMirrored())
+        benchmark::printRow("pushBlock + readBlock, mirrored", measureBlocks(mirrored, options), "per sample");
+
+    benchmark::printRow("interpolate, masked", measureTaps(masked, options), "per tap");
+
+    if (mirrored.isMirrored())
+        benchmark::printRow("interpolate, mirrored", measureTaps(mirrored, options), "per tap");
+    else
+        std::printf("\n  (no mirrored rows: the buffer couldn't be mirrored)\n");
+
+    return 0;
+}
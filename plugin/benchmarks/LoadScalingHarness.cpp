@@ -0,0 +1,493 @@
+///
+///     @file LoadScalingHarness.cpp
+///     @brief How many plugin instances fit in a buffer period.
+///     @date October 18, 2026
+///
+///     Runs N AudioPluginAudioProcessor instances side by side, the way a
+///     host runs many sends, and finds the largest N whose processing still
+///     meets the block deadline (blockSize / sampleRate) at the 99.9th
+///     percentile. Each instance gets its own audio (noise hits over a
+///     drifting tone) and randomized automation of time, feedback, mix
+///     and cutoff.
+///
+///     The instances are split over M threads. Each block, all threads
+///     start together, process their instances, and the block is done when
+///     the last one finishes; that whole cycle is what has to fit in the
+///     period. Blocks are run back to back, as fast as they go, and each
+///     cycle is registered with a BlockLoadMeter, whose 99.9th percentile
+///     load (to its 5% resolution) must be at most 1.0.
+///
+///     For each parameter preset, sample rate and block size, N is found
+///     with a search starting from what the one-instance cost predicts, and
+///     the table gives the largest N that passed. The full table takes a
+///     while; the options narrow it down:
+///
+///         --threads M         worker threads (default 1)
+///         --blocks B          measured blocks per run (default 5000)
+///         --rates 44100,...   sample rates
+///         --block-sizes 32,...
+///         --presets plain,filter,ping-pong,diffusion
+///         --max-instances N   stop searching at N (default 1024)
+///
+///     Numbers are only meaningful on a quiet machine with frequency
+///     scaling fixed. Threads are not pinned or given realtime priority.
+///
+
+#include "DelayPlugin/PluginProcessor.h"
+#include <juce_events/juce_events.h>
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+    constexpr int WARM_UP_BLOCKS = 100;
+
+    // Blocks between automation moves
+    constexpr int AUTOMATION_INTERVAL_BLOCKS = 16;
+
+    struct ParameterValue
+    {
+        const char* parameterID;
+        float value;
+    };
+
+    struct Preset
+    {
+        const char* name;
+        std::vector<ParameterValue> parameters;
+    };
+
+    const std::vector<Preset> ALL_PRESETS {
+        { "plain", { { "LOOP_FILTER_TYPE", 2.0f } } },
+        { "filter", { { "LOOP_FILTER_TYPE", 0.0f } } },
+        { "ping-pong", { { "LOOP_FILTER_TYPE", 2.0f }, { "IS_PING_PONG_ON", 1.0f } } },
+        { "diffusion", { { "LOOP_FILTER_TYPE", 2.0f }, { "DIFFUSION", 0.7f } } }
+    };
+
+    struct Options
+    {
+        int numThreads = 1;
+        int numBlocks = 5000;
+        int maxInstances = 1024;
+        std::vector<int> sampleRates { 44100, 48000, 96000, 192000 };
+        std::vector<int> blockSizes { 32, 64, 128, 256, 512, 1024, 2048 };
+        std::vector<Preset> presets = ALL_PRESETS;
+    };
+
+    struct RunResult
+    {
+        double p999Load;
+        double meanLoad;
+    };
+
+    void setParameter(juce::AudioProcessorValueTreeState& apvts,
+                      const juce::String& parameterID, float value)
+    {
+        auto* parameter = apvts.getParameter(parameterID);
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+
+    std::vector<int> parseList(const std::string& text)
+    {
+        std::vector<int> values;
+        size_t start = 0;
+
+        while (start < text.size())
+        {
+            size_t end = text.find(',', start);
+
+            if (end == std::string::npos)
+                end = text.size();
+
+            values.push_back(std::stoi(text.substr(start, end - start)));
+            start = end + 1;
+        }
+
+        return values;
+    }
+}
+
+
+/**
+ * One plugin instance with its own input and automation.
+ */
+class Instance
+{
+public:
+    Instance(const Preset& preset, double sampleRate, int blockSize, unsigned int seed)
+        : m_buffer(2, blockSize), m_random(seed), m_blockCount{0}
+    {
+        auto& apvts = m_processor.getAPVTS();
+
+        setParameter(apvts, "DELAY_TIME", 300.0f);
+        setParameter(apvts, "FEEDBACK", 0.6f);
+        setParameter(apvts, "MIX", 0.4f);
+        setParameter(apvts, "LOOP_FILTER_CUTOFF", 3000.0f);
+
+        for (const auto& parameter : preset.parameters)
+            setParameter(apvts, parameter.parameterID, parameter.value);
+
+        m_processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+        m_processor.prepareToPlay(sampleRate, blockSize);
+
+        // Each instance starts at its own point in the signal
+        m_phase = std::uniform_real_distribution<float>(0.0f, 1.0f)(m_random);
+        m_phaseStep = std::uniform_real_distribution<float>(100.0f, 400.0f)(m_random)
+                        / static_cast<float>(sampleRate);
+        m_hitSamples = static_cast<int>(sampleRate / 4.0);
+        m_hitPosition = std::uniform_int_distribution<int>(0, m_hitSamples - 1)(m_random);
+    }
+
+    void processBlock()
+    {
+        if (m_blockCount++ % AUTOMATION_INTERVAL_BLOCKS == 0)
+            moveAutomation();
+
+        fillInput();
+        m_processor.processBlock(m_buffer, m_midi);
+    }
+
+    size_t getMemoryUsageBytes() const
+    {
+        return m_processor.getMemoryUsageBytes();
+    }
+
+private:
+    AudioPluginAudioProcessor m_processor;
+    juce::AudioBuffer<float> m_buffer;
+    juce::MidiBuffer m_midi;
+    std::minstd_rand m_random;
+    int m_blockCount;
+
+    float m_phase;
+    float m_phaseStep;
+    int m_hitSamples;
+    int m_hitPosition;
+    float m_hitLevel = 0.0f;
+
+    // A tone with a noise hit every quarter second
+    void fillInput()
+    {
+        std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+        auto* left = m_buffer.getWritePointer(0);
+        auto* right = m_buffer.getWritePointer(1);
+
+        for (int i = 0; i < m_buffer.getNumSamples(); i++)
+        {
+            if (++m_hitPosition >= m_hitSamples)
+            {
+                m_hitPosition = 0;
+                m_hitLevel = 0.5f;
+            }
+
+            m_phase += m_phaseStep;
+            m_phase -= std::floor(m_phase);
+            m_hitLevel *= 0.9995f;
+
+            const float tone = 0.2f * std::sin(6.2831853f * m_phase);
+            left[i] = tone + m_hitLevel * noise(m_random);
+            right[i] = tone + m_hitLevel * noise(m_random);
+        }
+    }
+
+    // Random jumps, as from a host's automation lanes
+    void moveAutomation()
+    {
+        auto& apvts = m_processor.getAPVTS();
+        auto uniform = [this](float low, float high)
+        {
+            return std::uniform_real_distribution<float>(low, high)(m_random);
+        };
+
+        setParameter(apvts, "DELAY_TIME", uniform(100.0f, 600.0f));
+        setParameter(apvts, "FEEDBACK", uniform(0.2f, 0.9f));
+        setParameter(apvts, "MIX", uniform(0.1f, 0.9f));
+        setParameter(apvts, "LOOP_FILTER_CUTOFF", uniform(200.0f, 12000.0f));
+    }
+};
+
+
+/**
+ * Runs a set of instances over a pool of threads, a block at a time.
+ */
+class InstanceRunner
+{
+public:
+    InstanceRunner(std::vector<std::unique_ptr<Instance>>& instances, int numThreads)
+        : m_instances(instances), m_numThreads{numThreads},
+          m_startBarrier(numThreads), m_endBarrier(numThreads), m_shouldStop{false}
+    {
+        // The calling thread is worker 0
+        for (int worker = 1; worker < numThreads; worker++)
+            m_workers.emplace_back([this, worker] { runWorker(worker); });
+    }
+
+    ~InstanceRunner()
+    {
+        m_shouldStop = true;
+        m_startBarrier.arrive_and_wait();
+
+        for (auto& worker : m_workers)
+            worker.join();
+    }
+
+    // Process one block on every instance. Returns how long it took in ms.
+    double processBlock()
+    {
+        const double start = juce::Time::getMillisecondCounterHiRes();
+
+        m_startBarrier.arrive_and_wait();
+        processShare(0);
+        m_endBarrier.arrive_and_wait();
+
+        return juce::Time::getMillisecondCounterHiRes() - start;
+    }
+
+private:
+    std::vector<std::unique_ptr<Instance>>& m_instances;
+    int m_numThreads;
+    std::barrier<> m_startBarrier;
+    std::barrier<> m_endBarrier;
+    std::atomic<bool> m_shouldStop;
+    std::vector<std::thread> m_workers;
+
+    void runWorker(int worker)
+    {
+        while (true)
+        {
+            m_startBarrier.arrive_and_wait();
+
+            if (m_shouldStop)
+                return;
+
+            processShare(worker);
+            m_endBarrier.arrive_and_wait();
+        }
+    }
+
+    // Instances are dealt out to the workers in turn
+    void processShare(int worker)
+    {
+        for (size_t i = static_cast<size_t>(worker); i < m_instances.size();
+                i += static_cast<size_t>(m_numThreads))
+            m_instances[i]->processBlock();
+    }
+};
+
+
+/**
+ * Finds the most instances that meet the deadline for one configuration.
+ */
+class ScalingSearch
+{
+public:
+    ScalingSearch(const Preset& preset, double sampleRate, int blockSize,
+                  const Options& options)
+        : m_preset(preset), m_sampleRate{sampleRate}, m_blockSize{blockSize},
+          m_options(options)
+    {
+    }
+
+    void run()
+    {
+        // Start from what one instance's cost predicts, then narrow down
+        const auto single = measure(1);
+        m_best = single.p999Load <= 1.0 ? 1 : 0;
+        m_bestResult = single;
+
+        if (m_best == 0)
+            return;
+
+        int low = 1;
+        int high = std::clamp(static_cast<int>(2.0 * m_options.numThreads
+                                                / std::max(single.meanLoad, 1.0e-6)),
+                              2, m_options.maxInstances);
+
+        // Grow until a run fails (or the cap is reached)
+        while (high < m_options.maxInstances)
+        {
+            const auto result = measure(high);
+
+            if (result.p999Load > 1.0)
+                break;
+
+            low = high;
+            record(high, result);
+            high = std::min(high * 2, m_options.maxInstances);
+        }
+
+        if (high == m_options.maxInstances)
+        {
+            const auto result = measure(high);
+
+            if (result.p999Load <= 1.0)
+            {
+                record(high, result);
+                return;
+            }
+        }
+
+        // Largest passing N is in [low, high)
+        while (high - low > 1)
+        {
+            const int mid = low + (high - low) / 2;
+            const auto result = measure(mid);
+
+            if (result.p999Load <= 1.0)
+            {
+                low = mid;
+                record(mid, result);
+            }
+            else
+            {
+                high = mid;
+            }
+        }
+    }
+
+    void printRow() const
+    {
+        const double memoryMiB = static_cast<double>(m_memoryPerInstance) / (1024.0 * 1024.0);
+        const bool isCapped = m_best == m_options.maxInstances;
+
+        const std::string instances = (isCapped ? ">=" : "") + std::to_string(m_best);
+
+        std::printf("%-10s %7d %6d %8d %12s %11.2f %10.2f %11.2f\n",
+                    m_preset.name, static_cast<int>(m_sampleRate), m_blockSize,
+                    m_options.numThreads, instances.c_str(),
+                    m_bestResult.p999Load, m_bestResult.meanLoad, memoryMiB);
+        std::fflush(stdout);
+    }
+
+private:
+    const Preset& m_preset;
+    double m_sampleRate;
+    int m_blockSize;
+    const Options& m_options;
+    std::vector<std::unique_ptr<Instance>> m_instances;
+    int m_best = 0;
+    RunResult m_bestResult {};
+    size_t m_memoryPerInstance = 0;
+
+    void record(int numInstances, RunResult result)
+    {
+        if (numInstances > m_best)
+        {
+            m_best = numInstances;
+            m_bestResult = result;
+        }
+    }
+
+    // Run numInstances instances and measure the load of the whole cycle
+    RunResult measure(int numInstances)
+    {
+        // Instances are kept between runs; new ones are created as needed
+        while (static_cast<int>(m_instances.size()) < numInstances)
+            m_instances.push_back(std::make_unique<Instance>(m_preset, m_sampleRate,
+                                    m_blockSize, static_cast<unsigned int>(m_instances.size() + 1)));
+
+        std::vector<std::unique_ptr<Instance>> running;
+
+        for (int i = 0; i < numInstances; i++)
+            running.push_back(std::move(m_instances[static_cast<size_t>(i)]));
+
+        BlockLoadMeter meter;
+        meter.reset(m_sampleRate, m_blockSize);
+
+        {
+            InstanceRunner runner(running, m_options.numThreads);
+
+            for (int block = 0; block < WARM_UP_BLOCKS; block++)
+                runner.processBlock();
+
+            for (int block = 0; block < m_options.numBlocks; block++)
+                meter.registerBlock(runner.processBlock(), m_blockSize);
+        }
+
+        m_memoryPerInstance = running.front()->getMemoryUsageBytes();
+
+        for (int i = 0; i < numInstances; i++)
+            m_instances[static_cast<size_t>(i)] = std::move(running[static_cast<size_t>(i)]);
+
+        // The smoothed load lags; the mean over the run is worked out from
+        // the histogram's bucket centres
+        const auto histogram = meter.getHistogram();
+        double sum = 0.0;
+        std::uint64_t count = 0;
+
+        for (int bucket = 0; bucket < BlockLoadMeter::NUM_BUCKETS; bucket++)
+        {
+            sum += (bucket + 0.5) * BlockLoadMeter::BUCKET_WIDTH * static_cast<double>(histogram[static_cast<size_t>(bucket)]);
+            count += histogram[static_cast<size_t>(bucket)];
+        }
+
+        return { meter.getLoadPercentile(99.9), count > 0 ? sum / static_cast<double>(count) : 0.0 };
+    }
+};
+
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    Options options;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string option(argv[i]);
+        const std::string value(argv[i + 1]);
+
+        if (option == "--threads")
+            options.numThreads = std::max(std::stoi(value), 1);
+        else if (option == "--blocks")
+            options.numBlocks = std::max(std::stoi(value), 1000);
+        else if (option == "--max-instances")
+            options.maxInstances = std::max(std::stoi(value), 1);
+        else if (option == "--rates")
+            options.sampleRates = parseList(value);
+        else if (option == "--block-sizes")
+            options.blockSizes = parseList(value);
+        else if (option == "--presets")
+        {
+            options.presets.clear();
+
+            for (const auto& preset : ALL_PRESETS)
+                if (("," + value + ",").find("," + std::string(preset.name) + ",") != std::string::npos)
+                    options.presets.push_back(preset);
+        }
+        else
+        {
+            std::fprintf(stderr, "Unknown option %s\n", option.c_str());
+            return 1;
+        }
+    }
+
+    std::printf("Max instances meeting the block deadline at the 99.9th percentile "
+                "(%d blocks per run)\n\n", options.numBlocks);
+    std::printf("%-10s %7s %6s %8s %12s %11s %10s %11s\n", "Preset", "Rate", "Block",
+                "Threads", "Instances", "p99.9 load", "Mean load", "MiB/inst");
+
+    for (const auto& preset : options.presets)
+    {
+        for (int sampleRate : options.sampleRates)
+        {
+            for (int blockSize : options.blockSizes)
+            {
+                ScalingSearch search(preset, sampleRate, blockSize, options);
+                search.run();
+                search.printRow();
+            }
+        }
+    }
+
+    return 0;
+}
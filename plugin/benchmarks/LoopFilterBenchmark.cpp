@@ -0,0 +1,300 @@
+///
+///     @file LoopFilterBenchmark.cpp
+///     @brief Cost of the loop filters, and of OnePole's coefficients.
+///     @date October 18, 2026
+///
+///     Times each filter on noise, in ns per sample:
+///
+///     - at a fixed cutoff,
+///     - with setCutoff() called every sample, as DelayEffect does for the
+///       SVF types when it ramps the cutoff across a block.
+///
+///     Then, for OnePole's feedback coefficient a1 over LOOP_FILTER_CUTOFF's
+///     range (0-20 kHz, centre 500 Hz):
+///
+///     - the cost of an update at random positions, from Hz with the
+///       approximation or with exp, or from the position with OnePoleTable
+///       (each update is followed by one sample, timed on its own too),
+///     - the largest a1 error of the table and of the approximation
+///       against the exact value, and the table's largest cutoff error in
+///       cents above 20 Hz, at 44.1, 48, 96 and 192 kHz.
+///
+///     Options:
+///
+///         --rate R        sample rate (default 48000)
+///         --samples N     samples per measured run (default 4194304)
+///
+///     For the cost inside DelayEffect, see ProcessorBenchmark.
+///
+
+#include "BenchmarkUtilities.h"
+#include "DelayPlugin/DSP/OnePole.h"
+#include "DelayPlugin/DSP/OnePoleTable.h"
+#include "DelayPlugin/DSP/StateVariableFilter.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+    constexpr float CUTOFF = 3000.0f;
+    constexpr float RESONANCE = 0.5f;
+
+    // The swept cutoff moves over this range
+    constexpr float MIN_SWEEP_CUTOFF = 100.0f;
+    constexpr float MAX_SWEEP_CUTOFF = 10000.0f;
+
+    // LOOP_FILTER_CUTOFF's range, as DelayEffect builds its table
+    constexpr double MAX_CUTOFF = 20000.0;
+    constexpr double CENTRE_CUTOFF = 500.0;
+
+    // Positions checked for coefficient errors, and cutoffs below this are
+    // left out of the error in cents
+    constexpr int NUM_ERROR_POSITIONS = 200000;
+    constexpr double MIN_CENTS_CUTOFF = 20.0;
+
+    constexpr double TWO_PI = 6.283185307179586;
+
+    struct Options
+    {
+        float sampleRate = 48000.0f;
+        size_t numSamples = 1 << 22;
+    };
+
+    std::vector<float> makeNoise(size_t numSamples)
+    {
+        std::vector<float> noise(numSamples);
+        std::uint32_t state = 1;
+
+        for (auto& sample : noise)
+        {
+            state = state * 1664525u + 1013904223u;
+            sample = static_cast<float>(state >> 8) / 8388608.0f - 1.0f;
+        }
+
+        return noise;
+    }
+
+    // A cutoff for every sample, sweeping up and down the range
+    std::vector<float> makeSweep(size_t numSamples)
+    {
+        std::vector<float> cutoffs(numSamples);
+        const float step = 2.0f * (MAX_SWEEP_CUTOFF - MIN_SWEEP_CUTOFF) / static_cast<float>(numSamples);
+        float cutoff = MIN_SWEEP_CUTOFF;
+
+        for (auto& value : cutoffs)
+        {
+            value = cutoff;
+            cutoff += step;
+
+            if (cutoff > MAX_SWEEP_CUTOFF)
+                cutoff = 2.0f * MAX_SWEEP_CUTOFF - cutoff;
+        }
+
+        return cutoffs;
+    }
+
+    // Random positions in the cutoff range
+    std::vector<float> makePositions(size_t numSamples)
+    {
+        std::vector<float> positions(numSamples);
+        std::uint32_t state = 2;
+
+        for (auto& position : positions)
+        {
+            state = state * 1664525u + 1013904223u;
+            position = static_cast<float>(state >> 8) / 16777216.0f;
+        }
+
+        return positions;
+    }
+
+    // The cutoff at a position, as NormalisableRange::setSkewForCentre()
+    // maps it, worked out in double
+    double getExactCutoff(double position, double sampleRate)
+    {
+        const double skew = std::log(0.5) / std::log(CENTRE_CUTOFF / MAX_CUTOFF);
+        const double cutoff = MAX_CUTOFF * std::pow(position, 1.0 / skew);
+
+        return std::clamp(cutoff, 1.0, sampleRate / 2.0);
+    }
+
+    struct CoefficientErrors
+    {
+        double maxTableError;
+        double maxTableCents;
+        double maxApproxError;
+    };
+
+    CoefficientErrors measureErrors(double sampleRate)
+    {
+        OnePoleTable<float> table;
+        table.build(static_cast<float>(sampleRate), static_cast<float>(MAX_CUTOFF),
+                    static_cast<float>(CENTRE_CUTOFF));
+
+        CoefficientErrors errors {};
+
+        for (int i = 0; i <= NUM_ERROR_POSITIONS; i++)
+        {
+            const double position = static_cast<double>(i) / NUM_ERROR_POSITIONS;
+            const double cutoff = getExactCutoff(position, sampleRate);
+            const double exact = -std::exp(-TWO_PI * cutoff / sampleRate);
+            const double fromTable = static_cast<double>(table.getFeedback(static_cast<float>(position)));
+            const double approx = std::clamp(TWO_PI * cutoff / sampleRate - 1.0, -1.0, 0.0);
+
+            errors.maxTableError = std::max(errors.maxTableError, std::abs(fromTable - exact));
+            errors.maxApproxError = std::max(errors.maxApproxError, std::abs(approx - exact));
+
+            // The cutoff the table's a1 really gives
+            if (cutoff >= MIN_CENTS_CUTOFF)
+            {
+                const double tableCutoff = -sampleRate * std::log(-fromTable) / TWO_PI;
+                const double cents = 1200.0 * std::abs(std::log2(tableCutoff / cutoff));
+                errors.maxTableCents = std::max(errors.maxTableCents, cents);
+            }
+        }
+
+        return errors;
+    }
+
+    template<typename Filter>
+    double measureFixed(Filter& filter, const std::vector<float>& input)
+    {
+        return benchmark::measureNsPerItem(static_cast<long long>(input.size()), [&]
+        {
+            float sum = 0.0f;
+
+            for (float x : input)
+                sum += filter.getNextSample(x);
+
+            benchmark::keepResult(sum);
+        });
+    }
+
+    template<typename Filter>
+    double measureSwept(Filter& filter, const std::vector<float>& input,
+                        const std::vector<float>& cutoffs)
+    {
+        return benchmark::measureNsPerItem(static_cast<long long>(input.size()), [&]
+        {
+            float sum = 0.0f;
+
+            for (size_t i = 0; i < input.size(); i++)
+            {
+                filter.setCutoff(cutoffs[i]);
+                sum += filter.getNextSample(input[i]);
+            }
+
+            benchmark::keepResult(sum);
+        });
+    }
+
+    // One update then one sample per input sample, at random positions
+    template<typename Update>
+    double measureUpdates(OnePole<float>& filter, const std::vector<float>& input, Update&& update)
+    {
+        return benchmark::measureNsPerItem(static_cast<long long>(input.size()), [&]
+        {
+            float sum = 0.0f;
+
+            for (size_t i = 0; i < input.size(); i++)
+            {
+                update(filter, i);
+                sum += filter.getNextSample(input[i]);
+            }
+
+            benchmark::keepResult(sum);
+        });
+    }
+}
+
+
+int main(int argc, char* argv[])
+{
+    Options options;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string option(argv[i]);
+        const std::string value(argv[i + 1]);
+
+        if (option == "--rate")
+            options.sampleRate = static_cast<float>(std::max(std::stoi(value), 8000));
+        else if (option == "--samples")
+            options.numSamples = static_cast<size_t>(std::max(std::stoi(value), 1024));
+        else
+        {
+            std::fprintf(stderr, "Unknown option %s\n", option.c_str());
+            return 1;
+        }
+    }
+
+    const auto input = makeNoise(options.numSamples);
+    const auto cutoffs = makeSweep(options.numSamples);
+
+    OnePole<float> onePole(FilterType::lowPass, options.sampleRate, CUTOFF);
+    StateVariableFilter<float> svf(SvfType::lowPass, options.sampleRate, CUTOFF, RESONANCE);
+
+    std::printf("Loop filters at %.0f Hz, %zu samples per run\n\n", options.sampleRate,
+                options.numSamples);
+
+    benchmark::printRow("OnePole, fixed cutoff", measureFixed(onePole, input), "per sample");
+    benchmark::printRow("StateVariableFilter, fixed cutoff", measureFixed(svf, input), "per sample");
+    benchmark::printRow("OnePole, cutoff every sample", measureSwept(onePole, input, cutoffs),
+                        "per sample");
+    benchmark::printRow("StateVariableFilter, cutoff every sample", measureSwept(svf, input, cutoffs),
+                        "per sample");
+
+    // The cutoffs in Hz are worked out before timing, as the parameter
+    // holds them
+    OnePoleTable<float> table;
+    table.build(options.sampleRate, static_cast<float>(MAX_CUTOFF), static_cast<float>(CENTRE_CUTOFF));
+
+    const auto positions = makePositions(options.numSamples);
+    std::vector<float> positionCutoffs(options.numSamples);
+
+    for (size_t i = 0; i < positions.size(); i++)
+        positionCutoffs[i] = table.getCutoff(positions[i]);
+
+    OnePole<float> approxFilter(FilterType::lowPass, options.sampleRate, CUTOFF);
+    OnePole<float> exactFilter(FilterType::lowPass, options.sampleRate, CUTOFF);
+    OnePole<float> tableFilter(FilterType::lowPass, options.sampleRate, CUTOFF);
+    exactFilter.useApproxCutoff(false);
+
+    std::printf("\nOnePole coefficient updates at random positions, one sample each\n\n");
+
+    benchmark::printRow("No update", measureFixed(onePole, input), "per update");
+    benchmark::printRow("setCutoff(Hz), approximation",
+                        measureUpdates(approxFilter, input, [&](auto& filter, size_t i)
+                        {
+                            filter.setCutoff(positionCutoffs[i]);
+                        }), "per update");
+    benchmark::printRow("setCutoff(Hz), exp",
+                        measureUpdates(exactFilter, input, [&](auto& filter, size_t i)
+                        {
+                            filter.setCutoff(positionCutoffs[i]);
+                        }), "per update");
+    benchmark::printRow("setCutoff(table, position)",
+                        measureUpdates(tableFilter, input, [&](auto& filter, size_t i)
+                        {
+                            filter.setCutoff(table, positions[i]);
+                        }), "per update");
+
+    std::printf("\nOnePole a1 errors over %d positions\n\n", NUM_ERROR_POSITIONS);
+    std::printf("  %-10s %16s %20s %20s\n", "Rate", "Table |a1 error|", "Table cents (>= 20)",
+                "Approx |a1 error|");
+
+    for (double sampleRate : { 44100.0, 48000.0, 96000.0, 192000.0 })
+    {
+        const auto errors = measureErrors(sampleRate);
+
+        std::printf("  %-10.0f %16.2e %20.2f %20.2f\n", sampleRate, errors.maxTableError,
+                    errors.maxTableCents, errors.maxApproxError);
+    }
+
+    return 0;
+}
@@ -0,0 +1,250 @@
+///
+///     @file ProcessorBenchmark.cpp
+///     @brief Cost of the whole plugin per stereo sample, by preset.
+///     @date October 18, 2026
+///
+///     Runs one AudioPluginAudioProcessor on stereo noise for each preset
+///     and prints the time spent in processBlock() in ns per stereo sample
+///     and per block (and as a share of one core at the sample rate). Each
+///     preset starts from 300 ms, feedback 0.99 and mix 0.5, and runs long
+///     enough to fill the delay lines, or for "bypassed" to finish its fade,
+///     before it is timed. Presets marked "swept" move the loop filter
+///     cutoff every block, as automation would; the parameter change
+///     itself is not timed. Per-block figures include the two clock reads
+///     around processBlock(), which matter only for "bypassed".
+///
+///     Options:
+///
+///         --rate R                sample rate (default 48000)
+///         --block-size B          (default 256)
+///         --blocks N              timed blocks per run (default 2000)
+///         --presets a,b,...       (default all)
+///
+///     Numbers are only meaningful in a release build, on a quiet machine
+///     with frequency scaling fixed.
+///
+
+#include "BenchmarkUtilities.h"
+#include "DelayPlugin/PluginProcessor.h"
+#include <juce_events/juce_events.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+    // Enough for the longest delay to have gone round a few times
+    constexpr double WARM_UP_SECONDS = 1.5;
+
+    // The swept cutoff moves over this range, one step per block
+    constexpr float MIN_SWEEP_CUTOFF = 200.0f;
+    constexpr float MAX_SWEEP_CUTOFF = 8000.0f;
+    constexpr float SWEEP_STEP = 1.02f;
+
+    struct ParameterValue
+    {
+        const char* parameterID;
+        float value;
+    };
+
+    struct Preset
+    {
+        const char* name;
+        std::vector<ParameterValue> parameters;
+        bool isCutoffSwept;
+    };
+
+    const std::vector<Preset> ALL_PRESETS {
+        { "plain",          { { "LOOP_FILTER_TYPE", 2.0f } }, false },
+        { "one-pole-lp",    { { "LOOP_FILTER_TYPE", 0.0f } }, true },
+        { "one-pole-hp",    { { "LOOP_FILTER_TYPE", 1.0f } }, true },
+        { "svf-lp",         { { "LOOP_FILTER_TYPE", 3.0f }, { "LOOP_FILTER_RESONANCE", 0.5f } }, true },
+        { "svf-hp",         { { "LOOP_FILTER_TYPE", 4.0f }, { "LOOP_FILTER_RESONANCE", 0.5f } }, true },
+        { "svf-bp",         { { "LOOP_FILTER_TYPE", 5.0f }, { "LOOP_FILTER_RESONANCE", 0.5f } }, true },
+        { "svf-notch",      { { "LOOP_FILTER_TYPE", 6.0f }, { "LOOP_FILTER_RESONANCE", 0.5f } }, true },
+        { "soft-clip",      { { "LOOP_FILTER_TYPE", 2.0f }, { "SATURATION_TYPE", 1.0f },
+                              { "SATURATION_DRIVE", 12.0f } }, false },
+        { "tape",           { { "LOOP_FILTER_TYPE", 2.0f }, { "SATURATION_TYPE", 2.0f },
+                              { "SATURATION_DRIVE", 12.0f } }, false },
+        { "tube",           { { "LOOP_FILTER_TYPE", 2.0f }, { "SATURATION_TYPE", 3.0f },
+                              { "SATURATION_DRIVE", 12.0f } }, false },
+        { "spectral",       { { "LOOP_FILTER_TYPE", 2.0f }, { "IS_SPECTRAL_ON", 1.0f } }, false },
+        { "bypassed",       { { "LOOP_FILTER_TYPE", 2.0f }, { "IS_BYPASS_ON", 1.0f } }, false }
+    };
+
+    struct Options
+    {
+        double sampleRate = 48000.0;
+        int blockSize = 256;
+        int numBlocks = 2000;
+        std::vector<Preset> presets = ALL_PRESETS;
+    };
+
+    void setParameter(juce::AudioProcessorValueTreeState& apvts,
+                      const juce::String& parameterID, float value)
+    {
+        auto* parameter = apvts.getParameter(parameterID);
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+
+    void fillNoise(juce::AudioBuffer<float>& buffer, std::minstd_rand& random)
+    {
+        std::uniform_real_distribution<float> noise(-0.25f, 0.25f);
+
+        for (int channel = 0; channel < buffer.getNumChannels(); channel++)
+        {
+            auto* samples = buffer.getWritePointer(channel);
+
+            for (int i = 0; i < buffer.getNumSamples(); i++)
+                samples[i] = noise(random);
+        }
+    }
+
+    /**
+     * One preset on one processor: warm up, then time runs of blocks.
+     */
+    class PresetRun
+    {
+    public:
+        PresetRun(const Preset& preset, const Options& options)
+            : m_preset(preset), m_options(options), m_buffer(2, options.blockSize),
+              m_random(1), m_cutoff{MIN_SWEEP_CUTOFF}, m_cutoffStep{SWEEP_STEP}
+        {
+            auto& apvts = m_processor.getAPVTS();
+
+            setParameter(apvts, "DELAY_TIME", 300.0f);
+            setParameter(apvts, "FEEDBACK", 0.99f);
+            setParameter(apvts, "MIX", 0.5f);
+            setParameter(apvts, "LOOP_FILTER_CUTOFF", 3000.0f);
+
+            for (const auto& parameter : preset.parameters)
+                setParameter(apvts, parameter.parameterID, parameter.value);
+
+            m_processor.setPlayConfigDetails(2, 2, options.sampleRate, options.blockSize);
+            m_processor.prepareToPlay(options.sampleRate, options.blockSize);
+
+            const int warmUpBlocks = static_cast<int>(WARM_UP_SECONDS * options.sampleRate)
+                                        / options.blockSize;
+
+            for (int block = 0; block < warmUpBlocks; block++)
+                processBlock();
+        }
+
+        // Fastest run's time in processBlock(), in ns per stereo sample
+        double measure()
+        {
+            double fastest = std::numeric_limits<double>::max();
+
+            for (int run = 0; run < benchmark::NUM_RUNS; run++)
+            {
+                double total = 0.0;
+
+                for (int block = 0; block < m_options.numBlocks; block++)
+                    total += processBlock();
+
+                fastest = std::min(fastest, total);
+            }
+
+            return fastest / (static_cast<double>(m_options.numBlocks) * m_options.blockSize);
+        }
+
+    private:
+        const Preset& m_preset;
+        const Options& m_options;
+        AudioPluginAudioProcessor m_processor;
+        juce::AudioBuffer<float> m_buffer;
+        juce::MidiBuffer m_midi;
+        std::minstd_rand m_random;
+        float m_cutoff;
+        float m_cutoffStep;
+
+        // Process one block, and return how long processBlock() took in ns
+        double processBlock()
+        {
+            if (m_preset.isCutoffSwept)
+                moveCutoff();
+
+            fillNoise(m_buffer, m_random);
+
+            const auto start = std::chrono::steady_clock::now();
+            m_processor.processBlock(m_buffer, m_midi);
+            const std::chrono::duration<double, std::nano> elapsed
+                                            = std::chrono::steady_clock::now() - start;
+
+            benchmark::keepResult(m_buffer.getSample(0, 0));
+
+            return elapsed.count();
+        }
+
+        // Exponential sweep up and down the range
+        void moveCutoff()
+        {
+            m_cutoff *= m_cutoffStep;
+
+            if (m_cutoff > MAX_SWEEP_CUTOFF || m_cutoff < MIN_SWEEP_CUTOFF)
+            {
+                m_cutoffStep = 1.0f / m_cutoffStep;
+                m_cutoff = std::clamp(m_cutoff, MIN_SWEEP_CUTOFF, MAX_SWEEP_CUTOFF);
+            }
+
+            setParameter(m_processor.getAPVTS(), "LOOP_FILTER_CUTOFF", m_cutoff);
+        }
+    };
+}
+
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    Options options;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string option(argv[i]);
+        const std::string value(argv[i + 1]);
+
+        if (option == "--rate")
+            options.sampleRate = std::max(std::stod(value), 8000.0);
+        else if (option == "--block-size")
+            options.blockSize = std::max(std::stoi(value), 1);
+        else if (option == "--blocks")
+            options.numBlocks = std::max(std::stoi(value), 10);
+        else if (option == "--presets")
+        {
+            options.presets.clear();
+
+            for (const auto& preset : ALL_PRESETS)
+                if (("," + value + ",").find("," + std::string(preset.name) + ",") != std::string::npos)
+                    options.presets.push_back(preset);
+        }
+        else
+        {
+            std::fprintf(stderr, "Unknown option %s\n", option.c_str());
+            return 1;
+        }
+    }
+
+    std::printf("Plugin cost at %.0f Hz in blocks of %d (%d blocks per run)\n\n",
+                options.sampleRate, options.blockSize, options.numBlocks);
+    std::printf("  %-16s %7s %24s %14s %10s\n", "Preset", "Swept", "ns per stereo sample",
+                "ns per block", "% of core");
+
+    for (const auto& preset : options.presets)
+    {
+        PresetRun run(preset, options);
+        const double nsPerSample = run.measure();
+        const double coreShare = 100.0 * nsPerSample * options.sampleRate * 1.0e-9;
+
+        std::printf("  %-16s %7s %24.1f %14.1f %10.2f\n", preset.name,
+                    preset.isCutoffSwept ? "yes" : "no", nsPerSample,
+                    nsPerSample * options.blockSize, coreShare);
+    }
+
+    return 0;
+}
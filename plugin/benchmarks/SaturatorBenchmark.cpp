@@ -0,0 +1,250 @@
+///
+///     @file SaturatorBenchmark.cpp
+///     @brief Aliasing and cost of the feedback saturator.
+///     @date October 18, 2026
+///
+///     Aliasing: a 0.9 amplitude sine near 5 kHz at 48 kHz (exactly on an
+///     FFT bin, so nothing leaks) is shaped at several drives, and the
+///     spectrum is split into the harmonics that fall below Nyquist and
+///     everything else. The table gives the power of everything else (the
+///     aliases) relative to the harmonics, fundamental included. Shapers:
+///
+///     - Saturator, each curve, with its residual ADAA,
+///     - the same curve applied sample by sample with no anti-aliasing,
+///     - std::tanh applied sample by sample, for reference.
+///
+///     Cost: ns per sample for each shaper on noise at 12 dB drive, plus
+///     first-order ADAA of tanh through log(cosh()), the usual way to
+///     anti-alias tanh, which Saturator's polynomial curves avoid.
+///
+///     Options:
+///
+///         --samples N     samples per measured cost run (default 4194304)
+///
+
+#include "BenchmarkUtilities.h"
+#include "DelayPlugin/DSP/Fft.h"
+#include "DelayPlugin/DSP/Saturator.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+    constexpr double SAMPLE_RATE = 48000.0;
+    constexpr double AMPLITUDE = 0.9;
+
+    // 65536-point spectrum; the sine sits on bin 6813 (4990.1 Hz)
+    constexpr size_t FFT_SIZE = 1 << 16;
+    constexpr size_t SINE_BIN = 6813;
+
+    // Shaped before the analysed part, so the tube's DC blocker settles
+    constexpr size_t SETTLE_SAMPLES = 1 << 15;
+
+    constexpr float COST_DRIVE = 3.981f;    // 12 dB
+
+    // Turns one input sample into one output sample, keeping any state
+    using Shaper = std::function<float(float)>;
+
+    struct Curve
+    {
+        const char* name;
+        SaturationCurve curve;
+    };
+
+    const std::vector<Curve> CURVES {
+        { "soft clip", SaturationCurve::softClip },
+        { "tape", SaturationCurve::tape },
+        { "tube", SaturationCurve::tube }
+    };
+
+    // Apply the curve with no anti-aliasing, with the same drive scaling
+    // as Saturator
+    float shapeNaive(SaturationCurve curve, float drive, float x)
+    {
+        return static_cast<float>(Saturator<float>::shape(curve, static_cast<double>(drive * x))
+                                  / static_cast<double>(drive));
+    }
+
+    // log(cosh(x)), without overflowing for large |x|
+    double logCosh(double x)
+    {
+        const double magnitude = std::abs(x);
+        return magnitude + std::log1p(std::exp(-2.0 * magnitude)) - std::log(2.0);
+    }
+
+    // First-order ADAA of tanh, the textbook way
+    class AdaaTanh
+    {
+    public:
+        explicit AdaaTanh(float drive) : m_drive{drive}, m_x1{0.0}, m_integral1{logCosh(0.0)}
+        {
+        }
+
+        float getNextSample(float x)
+        {
+            const double driven = static_cast<double>(m_drive * x);
+            const double integral = logCosh(driven);
+            const double step = driven - m_x1;
+            const double y = std::abs(step) > 1.0e-6 ? (integral - m_integral1) / step
+                                                     : std::tanh(0.5 * (driven + m_x1));
+
+            m_x1 = driven;
+            m_integral1 = integral;
+
+            return static_cast<float>(y) / m_drive;
+        }
+
+    private:
+        float m_drive;
+        double m_x1;
+        double m_integral1;
+    };
+
+    // Aliased power relative to the harmonics below Nyquist (fundamental
+    // included), in dB
+    double measureAliasing(const Shaper& shaper)
+    {
+        Fft<double> fft;
+        fft.prepare(FFT_SIZE);
+
+        std::vector<std::complex<double>> spectrum(FFT_SIZE);
+        const double phaseStep = 6.283185307179586 * static_cast<double>(SINE_BIN)
+                                    / static_cast<double>(FFT_SIZE);
+
+        for (size_t i = 0; i < SETTLE_SAMPLES + FFT_SIZE; i++)
+        {
+            const auto x = static_cast<float>(AMPLITUDE * std::sin(phaseStep * static_cast<double>(i)));
+            const float y = shaper(x);
+
+            if (i >= SETTLE_SAMPLES)
+                spectrum[i - SETTLE_SAMPLES] = static_cast<double>(y);
+        }
+
+        fft.forward(spectrum.data());
+
+        double harmonicPower = 0.0;
+        double aliasPower = 0.0;
+
+        // Bin 0 is DC (the tube's offset), not aliasing
+        for (size_t bin = 1; bin <= FFT_SIZE / 2; bin++)
+        {
+            const double power = std::norm(spectrum[bin]);
+
+            if (bin % SINE_BIN == 0)
+                harmonicPower += power;
+            else
+                aliasPower += power;
+        }
+
+        return 10.0 * std::log10(aliasPower / harmonicPower);
+    }
+
+    std::vector<float> makeNoise(size_t numSamples)
+    {
+        std::vector<float> noise(numSamples);
+        std::uint32_t state = 1;
+
+        for (auto& sample : noise)
+        {
+            state = state * 1664525u + 1013904223u;
+            sample = 0.5f * (static_cast<float>(state >> 8) / 8388608.0f - 1.0f);
+        }
+
+        return noise;
+    }
+
+    template<typename Function>
+    double measureCost(const std::vector<float>& input, Function&& function)
+    {
+        return benchmark::measureNsPerItem(static_cast<long long>(input.size()), [&]
+        {
+            float sum = 0.0f;
+
+            for (float x : input)
+                sum += function(x);
+
+            benchmark::keepResult(sum);
+        });
+    }
+}
+
+
+int main(int argc, char* argv[])
+{
+    size_t numSamples = 1 << 22;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string option(argv[i]);
+        const std::string value(argv[i + 1]);
+
+        if (option == "--samples")
+            numSamples = static_cast<size_t>(std::max(std::stoi(value), 1024));
+        else
+        {
+            std::fprintf(stderr, "Unknown option %s\n", option.c_str());
+            return 1;
+        }
+    }
+
+    std::printf("Aliased power relative to the harmonics, %.1f amplitude sine at %.1f Hz, %.0f Hz\n\n",
+                AMPLITUDE, static_cast<double>(SINE_BIN) * SAMPLE_RATE / static_cast<double>(FFT_SIZE),
+                SAMPLE_RATE);
+    std::printf("  %-12s %7s %12s %12s\n", "Curve", "Drive", "Naive (dB)", "ADAA (dB)");
+
+    for (float drive : { 4.0f, 16.0f })
+    {
+        for (const auto& curve : CURVES)
+        {
+            Saturator<float> saturator(curve.curve, drive, static_cast<float>(SAMPLE_RATE));
+
+            const double naive = measureAliasing([&](float x) { return shapeNaive(curve.curve, drive, x); });
+            const double adaa = measureAliasing([&](float x) { return saturator.getNextSample(x); });
+
+            std::printf("  %-12s %7.0f %12.1f %12.1f\n", curve.name, drive, naive, adaa);
+        }
+
+        AdaaTanh adaaTanh(drive);
+        const double naive = measureAliasing([&](float x) { return std::tanh(drive * x) / drive; });
+        const double adaa = measureAliasing([&](float x) { return adaaTanh.getNextSample(x); });
+
+        std::printf("  %-12s %7.0f %12.1f %12.1f\n", "std::tanh", drive, naive, adaa);
+    }
+
+    const auto input = makeNoise(numSamples);
+
+    std::printf("\nCost at 12 dB drive, %zu samples per run\n\n", numSamples);
+
+    for (const auto& curve : CURVES)
+    {
+        Saturator<float> saturator(curve.curve, COST_DRIVE, static_cast<float>(SAMPLE_RATE));
+
+        const std::string adaaName = std::string("Saturator, ") + curve.name;
+        const std::string naiveName = std::string("naive ") + curve.name;
+
+        benchmark::printRow(adaaName.c_str(),
+                            measureCost(input, [&](float x) { return saturator.getNextSample(x); }),
+                            "per sample");
+        benchmark::printRow(naiveName.c_str(),
+                            measureCost(input, [&](float x) { return shapeNaive(curve.curve, COST_DRIVE, x); }),
+                            "per sample");
+    }
+
+    AdaaTanh adaaTanh(COST_DRIVE);
+
+    benchmark::printRow("std::tanh",
+                        measureCost(input, [](float x) { return std::tanh(COST_DRIVE * x) / COST_DRIVE; }),
+                        "per sample");
+    benchmark::printRow("ADAA tanh via log(cosh)",
+                        measureCost(input, [&](float x) { return adaaTanh.getNextSample(x); }),
+                        "per sample");
+
+    return 0;
+}
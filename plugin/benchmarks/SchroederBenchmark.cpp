@@ -0,0 +1,109 @@
+///
+///     @file SchroederBenchmark.cpp
+///     @brief Fixed-capacity Schroeder stages against run-time sized ones.
+///     @date October 18, 2026
+///
+///     Runs the four Freeverb all-pass stages (225, 556, 441 and 341
+///     samples) in series, three ways:
+///
+///     - Schroeder<float>: each stage's buffer on the heap, with a run-time
+///       size and mask,
+///     - Schroeder<float, Capacity>: each buffer inline in its stage, with
+///       a constant mask (capacities 256, 1024, 512, 512),
+///     - FusedDiffuser<float>: all stages in one shared ring, which is what
+///       the plugin runs.
+///
+///     and prints the cost of the chain in ns per sample. Options:
+///
+///         --samples N     samples per measured run (default 4194304)
+///
+
+#include "BenchmarkUtilities.h"
+#include "DelayPlugin/DSP/FusedDiffuser.h"
+#include "DelayPlugin/DSP/Schroeder.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+    constexpr float GAIN = 0.5f;
+
+    std::vector<float> makeNoise(size_t numSamples)
+    {
+        std::vector<float> noise(numSamples);
+        std::uint32_t state = 1;
+
+        for (auto& sample : noise)
+        {
+            state = state * 1664525u + 1013904223u;
+            sample = static_cast<float>(state >> 8) / 8388608.0f - 1.0f;
+        }
+
+        return noise;
+    }
+
+    // Time one chain of filters (called in order on each sample)
+    template<typename... Filters>
+    double measureChain(const std::vector<float>& input, Filters&... filters)
+    {
+        return benchmark::measureNsPerItem(static_cast<long long>(input.size()), [&]
+        {
+            float sum = 0.0f;
+
+            for (float x : input)
+            {
+                ((x = filters.getNextSample(x)), ...);
+                sum += x;
+            }
+
+            benchmark::keepResult(sum);
+        });
+    }
+}
+
+
+int main(int argc, char* argv[])
+{
+    size_t numSamples = 1 << 22;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string option(argv[i]);
+        const std::string value(argv[i + 1]);
+
+        if (option == "--samples")
+            numSamples = static_cast<size_t>(std::max(std::stoi(value), 1024));
+        else
+        {
+            std::fprintf(stderr, "Unknown option %s\n", option.c_str());
+            return 1;
+        }
+    }
+
+    const auto input = makeNoise(numSamples);
+
+    Schroeder<float> sized1(225, GAIN), sized2(556, GAIN), sized3(441, GAIN), sized4(341, GAIN);
+    Schroeder<float, 256> fixed1(225, GAIN);
+    Schroeder<float, 1024> fixed2(556, GAIN);
+    Schroeder<float, 512> fixed3(441, GAIN);
+    Schroeder<float, 512> fixed4(341, GAIN);
+
+    const std::vector<unsigned int> lengths { 225, 556, 441, 341 };
+    const std::vector<float> gains(lengths.size(), GAIN);
+    FusedDiffuser<float> fused(lengths, gains);
+    fused.setSampleRate(44100.0f);
+
+    std::printf("Four Freeverb all-pass stages in series, %zu samples per run\n\n", numSamples);
+
+    benchmark::printRow("Schroeder<float>", measureChain(input, sized1, sized2, sized3, sized4),
+                        "per sample");
+    benchmark::printRow("Schroeder<float, Capacity>", measureChain(input, fixed1, fixed2, fixed3, fixed4),
+                        "per sample");
+    benchmark::printRow("FusedDiffuser<float>", measureChain(input, fused), "per sample");
+
+    return 0;
+}
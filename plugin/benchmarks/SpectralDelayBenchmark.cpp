@@ -0,0 +1,129 @@
+///
+///     @file SpectralDelayBenchmark.cpp
+///     @brief Cost and ring memory of the spectral delay.
+///     @date October 18, 2026
+///
+///     Runs SpectralDelay on stereo noise at 300 ms, feedback 0.9 and a
+///     delay and feedback tilt of 0.5, and prints the time per stereo
+///     sample (and as a share of one core at the sample rate) against the
+///     budget of 5% of a core in SpectralDelay.cpp. Also prints the FFT
+///     length and the bytes the rings take for the 2 s maximum delay.
+///
+///     Options:
+///
+///         --rate R        sample rate (default 48000)
+///         --block-size B  (default 256)
+///
+///     For the cost of spectral mode inside the plugin, see the "spectral"
+///     preset in ProcessorBenchmark.
+///
+
+#include "BenchmarkUtilities.h"
+#include "DelayPlugin/DSP/SpectralDelay.h"
+#include <algorithm>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+    // Stereo samples per measured run, about 21 s at 48 kHz
+    constexpr long long SAMPLES_PER_RUN = 1 << 20;
+
+    constexpr float DELAY_TIME_MS = 300.0f;
+    constexpr float FEEDBACK = 0.9f;
+    constexpr float TILT = 0.5f;
+    constexpr float MIX = 0.5f;
+
+    constexpr double CORE_BUDGET_PERCENT = 5.0;
+
+    std::vector<float> makeNoise(size_t numSamples, std::uint32_t seed)
+    {
+        std::vector<float> noise(numSamples);
+        std::uint32_t state = seed;
+
+        for (auto& sample : noise)
+        {
+            state = state * 1664525u + 1013904223u;
+            sample = 0.25f * (static_cast<float>(state >> 8) / 8388608.0f - 1.0f);
+        }
+
+        return noise;
+    }
+}
+
+
+int main(int argc, char* argv[])
+{
+    float sampleRate = 48000.0f;
+    int blockSize = 256;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string option(argv[i]);
+        const std::string value(argv[i + 1]);
+
+        if (option == "--rate")
+            sampleRate = static_cast<float>(std::max(std::stoi(value), 8000));
+        else if (option == "--block-size")
+            blockSize = std::max(std::stoi(value), 1);
+        else
+        {
+            std::fprintf(stderr, "Unknown option %s\n", option.c_str());
+            return 1;
+        }
+    }
+
+    SpectralDelay spectralDelay;
+    spectralDelay.prepare(sampleRate);
+
+    // Zeroed, and aligned by operator new
+    std::vector<std::complex<float>> ring(spectralDelay.getRingBytes() / sizeof(std::complex<float>));
+    spectralDelay.setRingMemory(reinterpret_cast<std::byte*>(ring.data()), spectralDelay.getRingBytes());
+    spectralDelay.setParameters(DELAY_TIME_MS, FEEDBACK, TILT, TILT);
+
+    const auto size = static_cast<size_t>(blockSize);
+    const std::vector<float> noise[SpectralDelay::NUM_CHANNELS] { makeNoise(size, 1), makeNoise(size, 2) };
+    std::vector<float> block[SpectralDelay::NUM_CHANNELS] { noise[0], noise[1] };
+    const long long numBlocks = std::max(SAMPLES_PER_RUN / blockSize, 1LL);
+
+    const auto processBlocks = [&](long long count)
+    {
+        for (long long i = 0; i < count; i++)
+        {
+            for (int channel = 0; channel < SpectralDelay::NUM_CHANNELS; channel++)
+            {
+                std::copy(noise[channel].begin(), noise[channel].end(), block[channel].begin());
+                spectralDelay.process(channel, block[channel].data(), blockSize, MIX);
+            }
+
+            benchmark::keepResult(block[0][0]);
+        }
+    };
+
+    // Fill the rings before timing
+    processBlocks(static_cast<long long>(2.0f * SpectralDelay::MAX_DELAY_SECONDS * sampleRate) / blockSize);
+
+    const double nsPerSample = benchmark::measureNsPerItem(numBlocks * blockSize, [&]
+    {
+        processBlocks(numBlocks);
+    });
+
+    const double coreShare = 100.0 * nsPerSample * static_cast<double>(sampleRate) * 1.0e-9;
+
+    // The latency is one frame
+    std::printf("SpectralDelay at %.0f Hz in blocks of %d: %d-point frames, hop %d\n\n",
+                static_cast<double>(sampleRate), blockSize, spectralDelay.getLatencySamples(),
+                spectralDelay.getHopSize());
+
+    benchmark::printRow("Stereo process()", nsPerSample, "per stereo sample");
+    std::printf("  %-44s %9.2f %% (budget %.0f %%)\n", "Share of one core", coreShare, CORE_BUDGET_PERCENT);
+    std::printf("  %-44s %9.2f MB\n", "Ring memory",
+                static_cast<double>(spectralDelay.getRingBytes()) * 1.0e-6);
+
+    return 0;
+}
@@ -0,0 +1,81 @@
+///
+///     @file BlockLoadMeter.h
+///     @brief Per-instance realtime CPU load and deadline-miss tracking.
+///     @date October 18, 2026
+///
+///     Each processBlock() call is timed and compared with its deadline,
+///     the audio duration of the block (numSamples / sampleRate). The
+///     ratio of the two is the block's load: 1.0 means the block used its
+///     whole budget, and anything over 1.0 is an overrun. On top of the
+///     smoothed load from juce::AudioProcessLoadMeasurer, the meter keeps
+///     a histogram of block loads, the peak, and the overrun count, so a
+///     slowly rising tail shows up well before the first dropout.
+///
+///     Note that the budget is the whole block period, shared with the
+///     host and every other plugin on the same thread, so a single
+///     instance getting anywhere near 1.0 is already a problem.
+///
+
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+
+class BlockLoadMeter
+{
+public:
+    // Histogram buckets are 5% of the budget wide. The last bucket holds
+    // everything from 195% up.
+    static constexpr int NUM_BUCKETS = 40;
+    static constexpr double BUCKET_WIDTH = 0.05;
+
+    struct Statistics
+    {
+        double load;                // smoothed proportion of the budget
+        double peakLoad;            // worst single block
+        double p99Load;             // upper edge of the p99 bucket
+        std::uint64_t numBlocks;
+        std::uint64_t numOverruns;  // blocks that took longer than their budget
+    };
+
+    using Histogram = std::array<std::uint64_t, NUM_BUCKETS>;
+
+    BlockLoadMeter();
+
+    void reset(double sampleRate, int maximumBlockSize);
+    void registerBlock(double milliseconds, int numSamples);
+
+    Statistics getStatistics() const;
+    Histogram getHistogram() const;
+    double getLoadPercentile(double percentile) const;
+    void clearStatistics();
+
+    // Times the scope it lives in and registers it as one block
+    class ScopedTimer
+    {
+    public:
+        ScopedTimer(BlockLoadMeter& meter, int numSamples);
+        ~ScopedTimer();
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        BlockLoadMeter& m_meter;
+        int m_numSamples;
+        double m_startMilliseconds;
+    };
+
+private:
+    juce::AudioProcessLoadMeasurer m_loadMeasurer;
+
+    std::atomic<double> m_msPerSample;
+
+    // Written by the audio thread only, read by anyone
+    std::atomic<std::uint64_t> m_numBlocks;
+    std::atomic<std::uint64_t> m_numOverruns;
+    std::atomic<double> m_peakLoad;
+    std::array<std::atomic<std::uint64_t>, NUM_BUCKETS> m_histogram;
+};
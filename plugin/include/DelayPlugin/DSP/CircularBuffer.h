@@ -4,32 +4,98 @@
 
 #ifndef SIMPLE_DELAY_CIRCULARBUFFER_H
 #define SIMPLE_DELAY_CIRCULARBUFFER_H
+#include <array>
 #include <type_traits>
 #include <vector>
 #include <cassert>
+#include <algorithm>
 #include <juce_core/juce_core.h>
+#include "MirroredMemory.h"
+#include "SampleStorage.h"
 
 
-template<typename FloatType>
+/*
+ * Tag for a CircularBuffer whose size is fixed at compile time, e.g.
+ * CircularBuffer<float, FixedCapacity<512>> (see the specialization below)
+ * Capacity must be a power of 2
+ */
+template<std::size_t Capacity>
+struct FixedCapacity
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of 2");
+};
+
+
+/*
+ * FloatType is the type samples are pushed and read as.
+ * StorageType is the type they are kept in; by default the same as FloatType,
+ * or one of the compact formats in SampleStorage.h (Fixed16, Half, BFloat16),
+ * or FixedCapacity<N> for a buffer of N FloatType samples held inline
+ */
+template<typename FloatType, typename StorageType = FloatType>
 class CircularBuffer
 {
     // make sure the wrong datatype is not used
     static_assert(std::is_floating_point_v<FloatType> == true, "template type must be float or double");
 
+    using Codec = SampleCodec<FloatType, StorageType>;
+
 public:
 
+    /*
+    * creates an empty CircularBuffer (size 0, no memory). It must be given
+    * memory with resize() or setExternalStorage() before use
+    */
+    CircularBuffer() :
+        size(0), samples(nullptr), mirroringRequested(false), firstElement(0), storageScale(1)
+    {
+    }
+
     /*
     * creates CircularBuffer of size n
     * @param n: The buffer size, must be power of 2.
     * @param value: Value to fill the buffer with
+    * @param useMirroring: Store the samples in a double-mapped (mirrored)
+    *   region so block reads/writes never have to split at the wrap point.
+    *   Falls back to a std::vector if the region can't be mapped
+    *   (unsupported platform, or n * sizeof(StorageType) isn't a whole number of pages)
     */
-    explicit CircularBuffer(std::size_t n, FloatType value = FloatType()) :
-        size(n), data(n, value), firstElement(0)
+    explicit CircularBuffer(std::size_t n, FloatType value = FloatType(), bool useMirroring = false) :
+        size(0), samples(nullptr), mirroringRequested(useMirroring), firstElement(0), storageScale(1)
     {
-        // ensure buffer size is power of 2:
-        assert(static_cast<int>(n) == juce::nextPowerOfTwo(static_cast<int>(n)));
+        allocate(n);
+        fill(value);
     }
 
+    /*
+    * Copies make their own storage (with the same backend, if possible)
+    * instead of sharing the other buffer's memory
+    */
+    CircularBuffer(const CircularBuffer& other) :
+        size(0), samples(nullptr), mirroringRequested(other.mirroringRequested), firstElement(other.firstElement),
+        storageScale(other.storageScale)
+    {
+        allocate(other.size);
+        std::copy(other.samples, other.samples + size, samples);
+    }
+
+    CircularBuffer& operator=(const CircularBuffer& other)
+    {
+        if (this != &other)
+        {
+            mirroringRequested = other.mirroringRequested;
+            allocate(other.size);
+            std::copy(other.samples, other.samples + size, samples);
+            firstElement = other.firstElement;
+            storageScale = other.storageScale;
+        }
+        return *this;
+    }
+
+    // Moving keeps the sample pointer valid: neither backend relocates its memory on move
+    CircularBuffer(CircularBuffer&& other) noexcept = default;
+    CircularBuffer& operator=(CircularBuffer&& other) noexcept = default;
+
 
     /*
     * Returns a copy of element at a given index
@@ -38,22 +104,10 @@ public:
     */
     FloatType operator()(size_t x) const
     {
-        assert(x >= 0 && x < size);
-        return data[mask(firstElement + x)];
+        assert(x < size);
+        return Codec::decode(samples[mask(firstElement + x)], storageScale);
     }
 
-    /*
-     * Returns reference to buffer element at the given index
-     * starting from the end of the buffer
-     * @param x: the index
-     * @return a reference to the buffer element
-    */
-    // FloatType &operator[](size_t x)
-    // {
-    //     assert(x >= 0 && x < size);
-    //     return data[mask(firstElement + x)];
-    // }
-
     /*
      * Returns a copy of the buffer element at the given index
      * @param x: the index
@@ -63,11 +117,45 @@ public:
     {
         return operator()(size - x - 1);
     }
+
+    /*
+     * Returns the value `delay` samples in the past, linearly interpolated
+     * between the two neighbouring elements (same indexing as operator[])
+     * @param delay: fractional delay, 0 <= delay < size - 1
+     */
+    FloatType interpolate(FloatType delay) const
+    {
+        assert(delay >= FloatType(0) && delay < static_cast<FloatType>(size - 1));
+
+        auto whole = static_cast<size_t>(delay);
+        FloatType frac = delay - static_cast<FloatType>(whole);
+
+        // the newer of the two neighbours comes second in memory
+        size_t x = size - whole - 2;
+        FloatType older, newer;
+
+        if (isMirrored())
+        {
+            // one mask, then both neighbours are adjacent even across the wrap point
+            const StorageType* p = samples + mask(firstElement + x);
+            older = Codec::decode(p[0], storageScale);
+            newer = Codec::decode(p[1], storageScale);
+        }
+        else
+        {
+            older = operator()(x);
+            newer = operator()(x + 1);
+        }
+
+        return newer + frac * (older - newer);
+    }
+
     /*
     * Insert element at front of buffer, shifting out last element
-    * Return last element to send to audio output
+    * @param element: element to push into buffer
+    * @return the element shifted out (the oldest), to send to audio output
     */
-    void shift(FloatType element)
+    FloatType shift(FloatType element)
     {
         auto pushed = operator()(0);
         push(element);
@@ -80,7 +168,71 @@ public:
     */
     void push(FloatType element)
     {
-        data[mask(firstElement++)] = element;
+        samples[mask(firstElement++)] = Codec::encode(element, storageScale);
+    }
+
+    /*
+    * Push n elements at once (equivalent to calling push() on each in order)
+    * @param src: elements to push, oldest first
+    * @param n: number of elements, n <= size
+    */
+    void pushBlock(const FloatType* src, size_t n)
+    {
+        assert(n <= size);
+        size_t start = mask(firstElement);
+
+        if (isMirrored())
+        {
+            encodeBlock(src, samples + start, n);
+        }
+        else
+        {
+            size_t firstPart = std::min(n, size - start);
+            encodeBlock(src, samples + start, firstPart);
+            encodeBlock(src + firstPart, samples, n - firstPart);
+        }
+
+        firstElement += n;
+    }
+
+    /*
+    * Copy n elements starting at index x (same indexing as operator()) into dest
+    * @param x: index of the first element to copy
+    * @param dest: destination, must hold n elements
+    * @param n: number of elements, x + n <= size
+    */
+    void readBlock(size_t x, FloatType* dest, size_t n) const
+    {
+        assert(x + n <= size);
+        size_t start = mask(firstElement + x);
+
+        if (isMirrored())
+        {
+            decodeBlock(samples + start, dest, n);
+        }
+        else
+        {
+            size_t firstPart = std::min(n, size - start);
+            decodeBlock(samples + start, dest, firstPart);
+            decodeBlock(samples, dest + firstPart, n - firstPart);
+        }
+    }
+
+    /*
+    * Returns a pointer to n contiguous elements starting at index x
+    * (same indexing as operator()), or nullptr if the range wraps around the
+    * end of the storage. Never returns nullptr for a mirrored buffer.
+    * Elements are in StorageType, so decode them if it differs from FloatType
+    */
+    const StorageType* getContiguousRange(size_t x, size_t n) const
+    {
+        assert(x + n <= size);
+        size_t start = mask(firstElement + x);
+
+        if (! isMirrored() && start + n > size)
+            return nullptr;
+
+        return samples + start;
     }
 
     // Replace every element in buffer with default value
@@ -92,36 +244,155 @@ public:
     // Replace every element in buffer with given value
     void fill(FloatType value)
     {
-        std::fill(data.begin(), data.end(), value);
+        std::fill(samples, samples + size, Codec::encode(value, storageScale));
     }
 
 
     // Return the size of the buffer
-    size_t getSize()
+    size_t getSize() const
     {
         return size;
     }
 
+    // Return the number of bytes of sample memory owned by the buffer
+    // (a mirrored region is counted once, since both halves are the same pages;
+    // external storage is not owned, so it counts as 0)
+    size_t getMemoryBytes() const
+    {
+        return usesExternalStorage() ? 0 : size * sizeof(StorageType);
+    }
+
+    /*
+    * Set the full-scale value of a fixed point StorageType (ignored by
+    * floating point formats). Stored samples are not rescaled, so call this
+    * before pushing, or clear() afterwards
+    */
+    void setStorageScale(FloatType scale)
+    {
+        assert(scale > FloatType(0));
+        storageScale = scale;
+    }
+
+    // Return true if the buffer's memory was provided by setExternalStorage()
+    bool usesExternalStorage() const
+    {
+        return samples != nullptr && data.empty() && ! mirror.isAllocated();
+    }
+
+    // Return true if the buffer is backed by mirrored memory
+    bool isMirrored() const
+    {
+        return mirror.isAllocated();
+    }
+
 
     // Resize the buffer (buffer size must be a power of 2)
     void resize(size_t n)
     {
-        // ensure buffer size is power of 2:
+        if (n == size && ! usesExternalStorage())
+            return;
+
+        allocate(n);
+        clear();
+    }
+
+    /*
+    * Use memory owned by someone else (e.g. a pool block) instead of the
+    * buffer's own. Any owned memory is freed. The buffer is cleared.
+    * A later resize() switches back to owned memory
+    * @param memory: at least n elements, must outlive the buffer's use of it
+    * @param n: The buffer size, must be power of 2.
+    * @param clearContents: pass false if the memory is already zeroed
+    */
+    void setExternalStorage(StorageType* memory, size_t n, bool clearContents = true)
+    {
         assert(static_cast<int>(n) == juce::nextPowerOfTwo(static_cast<int>(n)));
+        mirror.release();
+        data = std::vector<StorageType>();
+        samples = memory;
         size = n;
-        data.resize(n);
+        firstElement = 0;
+
+        if (clearContents)
+            clear();
+    }
+
+    /*
+    * Push the n most recent elements of another buffer, oldest first, so they
+    * become this buffer's n most recent elements. Used to carry a delay line's
+    * contents over when its memory is replaced. Does not allocate
+    * @param other: buffer to copy from
+    * @param n: number of elements, n <= size and n <= other.getSize()
+    */
+    void pushRecent(const CircularBuffer& other, size_t n)
+    {
+        assert(n <= size && n <= other.size);
+
+        constexpr size_t chunkSize = 256;
+        FloatType chunk[chunkSize];
+
+        for (size_t done = 0; done < n; done += chunkSize)
+        {
+            size_t count = std::min(n - done, chunkSize);
+            other.readBlock(other.size - n + done, chunk, count);
+            pushBlock(chunk, count);
+        }
     }
 
 private:
      // size of buffer
     size_t size;
-   
-    // vector containing underlying data
-    std::vector<FloatType> data;
+
+    // fallback storage, used when the buffer is not mirrored
+    std::vector<StorageType> data;
+
+    // mirrored storage: samples[i] and samples[i + size] are the same element
+    MirroredMemory mirror;
+
+    // points into whichever of the two backends is in use
+    StorageType* samples;
+
+    // whether the mirrored backend should be tried when (re)allocating
+    bool mirroringRequested;
 
     // index of current first element of buffer
     std::size_t firstElement;
 
+    // full-scale value for fixed point storage
+    FloatType storageScale;
+
+    void allocate(size_t n)
+    {
+        // ensure buffer size is power of 2:
+        assert(static_cast<int>(n) == juce::nextPowerOfTwo(static_cast<int>(n)));
+        size = n;
+
+        if (mirroringRequested && mirror.allocate(n * sizeof(StorageType)))
+        {
+            data = std::vector<StorageType>();
+            samples = static_cast<StorageType*>(mirror.getData());
+        }
+        else
+        {
+            mirror.release();
+            data.resize(n);
+            samples = data.data();
+        }
+    }
+
+    // Plain loops over independent elements, so the compiler can vectorize the conversion
+    void encodeBlock(const FloatType* src, StorageType* dest, size_t n) const
+    {
+        for (size_t i = 0; i < n; i++)
+            dest[i] = Codec::encode(src[i], storageScale);
+    }
+
+    void decodeBlock(const StorageType* src, FloatType* dest, size_t n) const
+    {
+        for (size_t i = 0; i < n; i++)
+            dest[i] = Codec::decode(src[i], storageScale);
+    }
+
     size_t mask(size_t val) const
     {
         /*
@@ -135,4 +406,162 @@ private:
         return val & (size - 1);
     }
 };
+
+
+/*
+ * CircularBuffer with a size fixed at compile time, for short delays whose
+ * length is known up front (e.g. all-pass stages). The samples live in a
+ * std::array inside the buffer, so they sit inline in the owning object
+ * (no heap memory, no pointer to follow) and the wrap mask is a constant.
+ * Same indexing as the run-time sized buffer; it can't be resized,
+ * mirrored or given external storage. Samples are stored as FloatType
+ */
+template<typename FloatType, std::size_t Capacity>
+class CircularBuffer<FloatType, FixedCapacity<Capacity>>
+{
+    static_assert(std::is_floating_point_v<FloatType> == true, "template type must be float or double");
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of 2");
+
+public:
+
+    /*
+    * creates a CircularBuffer of Capacity elements
+    * @param value: Value to fill the buffer with
+    */
+    explicit CircularBuffer(FloatType value = FloatType()) :
+        firstElement(0)
+    {
+        fill(value);
+    }
+
+    /*
+    * Returns a copy of element at a given index
+    * @param x: The index
+    * @return Copy of the buffer element
+    */
+    FloatType operator()(size_t x) const
+    {
+        assert(x < Capacity);
+        return samples[mask(firstElement + x)];
+    }
+
+    /*
+     * Returns a copy of the buffer element at the given index
+     * starting from the end of the buffer
+     * @param x: the index
+     * @return a copy of a buffer element
+     */
+    FloatType operator[](size_t x) const
+    {
+        return operator()(Capacity - x - 1);
+    }
+
+    /*
+     * Returns the value `delay` samples in the past, linearly interpolated
+     * between the two neighbouring elements (same indexing as operator[])
+     * @param delay: fractional delay, 0 <= delay < Capacity - 1
+     */
+    FloatType interpolate(FloatType delay) const
+    {
+        assert(delay >= FloatType(0) && delay < static_cast<FloatType>(Capacity - 1));
+
+        auto whole = static_cast<size_t>(delay);
+        FloatType frac = delay - static_cast<FloatType>(whole);
+        FloatType older = operator[](whole + 1);
+        FloatType newer = operator[](whole);
+
+        return newer + frac * (older - newer);
+    }
+
+    /*
+    * Insert element at front of buffer, shifting out last element
+    * @param element: element to push into buffer
+    * @return the element shifted out (the oldest)
+    */
+    FloatType shift(FloatType element)
+    {
+        auto pushed = operator()(0);
+        push(element);
+        return pushed;
+    }
+
+    /*
+    * Insert element at front of buffer, shifting out last element
+    * @param element: element to push into buffer
+    */
+    void push(FloatType element)
+    {
+        samples[mask(firstElement++)] = element;
+    }
+
+    /*
+    * Push n elements at once (equivalent to calling push() on each in order)
+    * @param src: elements to push, oldest first
+    * @param n: number of elements, n <= Capacity
+    */
+    void pushBlock(const FloatType* src, size_t n)
+    {
+        assert(n <= Capacity);
+        size_t start = mask(firstElement);
+        size_t firstPart = std::min(n, Capacity - start);
+
+        std::copy(src, src + firstPart, samples.begin() + start);
+        std::copy(src + firstPart, src + n, samples.begin());
+        firstElement += n;
+    }
+
+    /*
+    * Copy n elements starting at index x (same indexing as operator()) into dest
+    * @param x: index of the first element to copy
+    * @param dest: destination, must hold n elements
+    * @param n: number of elements, x + n <= Capacity
+    */
+    void readBlock(size_t x, FloatType* dest, size_t n) const
+    {
+        assert(x + n <= Capacity);
+        size_t start = mask(firstElement + x);
+        size_t firstPart = std::min(n, Capacity - start);
+
+        std::copy(samples.begin() + start, samples.begin() + start + firstPart, dest);
+        std::copy(samples.begin(), samples.begin() + (n - firstPart), dest + firstPart);
+    }
+
+    // Replace every element in buffer with default value
+    void clear()
+    {
+        fill(FloatType());
+    }
+
+    // Replace every element in buffer with given value
+    void fill(FloatType value)
+    {
+        samples.fill(value);
+    }
+
+    // Return the size of the buffer
+    static constexpr size_t getSize()
+    {
+        return Capacity;
+    }
+
+    // Return the number of bytes of sample memory held by the buffer
+    // (inline, so part of the size of the owning object)
+    static constexpr size_t getMemoryBytes()
+    {
+        return Capacity * sizeof(FloatType);
+    }
+
+private:
+    std::array<FloatType, Capacity> samples;
+
+    // index of current first element of buffer
+    std::size_t firstElement;
+
+    // The wrapping function, as in the run-time sized buffer, with a
+    // constant mask
+    static constexpr size_t mask(size_t val)
+    {
+        return val & (Capacity - 1);
+    }
+};
 #endif //SIMPLE_DELAY_CIRCULARBUFFER_H
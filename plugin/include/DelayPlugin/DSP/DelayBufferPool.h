@@ -0,0 +1,179 @@
+///
+///     @file DelayBufferPool.h
+///     @brief Process-wide pool of delay line memory.
+///     @date October 18, 2026
+///
+///     Every plugin instance in the process draws its delay line memory
+///     from one shared pool, sized to the delay time actually in use rather
+///     than to the maximum delay. Memory released by one instance (because
+///     its delay got shorter, it was bypassed, or it was destroyed) is kept
+///     and handed to the next instance that needs a block of that size.
+///
+///     The audio thread never allocates or frees. Each delay line holds a
+///     DelayBufferLease: the audio thread posts the size it needs, the
+///     pool's service thread acquires a block and publishes it through the
+///     lease, and the audio thread picks it up at the start of a later
+///     block and hands the old one back. All of that goes through one
+///     atomic state per lease, with no locks on the audio side.
+///
+///     Blocks are power-of-two sized and zeroed before they are published.
+///     Zeroing (and allocating) happens outside the pool's lock, so one
+///     instance's large block doesn't hold up everyone else's requests. If
+///     an allocation fails, the lease keeps the block it has and the size
+///     is not tried again until the lease asks for a different one.
+///
+
+#ifndef DELAY_BUFFER_POOL_H
+#define DELAY_BUFFER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class DelayBufferLease;
+
+
+/**
+ * @class DelayBufferPool
+ *
+ * @brief Process-wide pool of delay line memory. All public methods are
+ *        thread safe, but none of them may be called from the audio thread.
+ */
+class DelayBufferPool
+{
+public:
+    struct Block
+    {
+        std::byte* data = nullptr;
+        std::size_t numBytes = 0;
+    };
+
+    struct Statistics
+    {
+        std::size_t pooledBytes;    // held by the pool, waiting to be reused
+        std::size_t inUseBytes;     // handed out to delay lines
+        std::size_t pooledBlocks;
+        std::size_t inUseBlocks;
+    };
+
+    static DelayBufferPool& getInstance();
+
+    Block acquire(std::size_t numBytes);
+    void release(Block block);
+    void trim(std::size_t maxPooledBytes);
+    void setMaxPooledBytes(std::size_t maxPooledBytes);
+    Statistics getStatistics() const;
+
+    static std::size_t getBlockSize(std::size_t numBytes);
+
+private:
+    friend class DelayBufferLease;
+
+    // The audio thread only sets m_hasWork (notifying a condition variable
+    // can take a lock or make a system call), and the service thread looks
+    // at it this often. Other threads notify m_wakeUp to stop it.
+    static constexpr int SERVICE_POLL_MS = 2;
+    static constexpr std::size_t ALIGNMENT = 64;
+
+    mutable std::mutex m_lock;
+    std::map<std::size_t, std::vector<std::byte*>> m_freeBlocks;
+    std::vector<DelayBufferLease*> m_leases;
+    std::size_t m_maxPooledBytes;
+
+    std::atomic<std::size_t> m_pooledBytes;
+    std::atomic<std::size_t> m_inUseBytes;
+    std::atomic<std::size_t> m_pooledBlocks;
+    std::atomic<std::size_t> m_inUseBlocks;
+
+    std::mutex m_threadLock;
+    std::thread m_serviceThread;
+    std::condition_variable m_wakeUp;
+    std::atomic<bool> m_hasWork;
+    bool m_shouldStop;
+
+    DelayBufferPool();
+    ~DelayBufferPool();
+    DelayBufferPool(const DelayBufferPool&) = delete;
+    DelayBufferPool& operator=(const DelayBufferPool&) = delete;
+
+    Block takeLocked(std::size_t numBytes);
+    static bool fillBlock(Block& block);
+    void untakeLocked(const Block& block);
+    void releaseLocked(Block block);
+    void trimLocked(std::size_t maxPooledBytes);
+
+    void addLease(DelayBufferLease* lease);
+    void removeLease(DelayBufferLease* lease);
+    void wakeServiceThread();
+    void serviceLoop();
+    void serviceLeases(std::unique_lock<std::mutex>& lock);
+};
+
+
+/**
+ * @class DelayBufferLease
+ *
+ * @brief One delay line's claim on pool memory, with a lock-free handoff
+ *        between the audio thread and the pool's service thread.
+ *
+ * Audio thread: request(), getCurrentBlock(), getPendingBlock(),
+ * acceptPendingBlock().
+ *
+ * Any other thread: the constructor and destructor, joinPool(),
+ * acquireNow(), releaseNow().
+ *
+ * Any thread at all: getCurrentBytes().
+ */
+class DelayBufferLease
+{
+public:
+    using Block = DelayBufferPool::Block;
+
+    DelayBufferLease();
+    ~DelayBufferLease();
+    DelayBufferLease(const DelayBufferLease&) = delete;
+    DelayBufferLease& operator=(const DelayBufferLease&) = delete;
+
+    void request(std::size_t numBytes);
+    const Block& getCurrentBlock() const { return m_current; }
+    std::size_t getCurrentBytes() const;
+    const Block* getPendingBlock() const;
+    void acceptPendingBlock();
+
+    void joinPool();
+    void acquireNow(std::size_t numBytes);
+    void releaseNow();
+
+private:
+    friend class DelayBufferPool;
+
+    // Handoff states. The service thread moves Idle -> Pending, the audio
+    // thread moves Pending -> Retired, the service thread moves
+    // Retired -> Idle. Whoever is allowed to make the next move owns
+    // m_pending and m_retired.
+    enum State { idle, pending, retired };
+
+    std::atomic<int> m_state;
+    std::atomic<std::size_t> m_requestedBytes;
+    std::atomic<std::size_t> m_currentBytes;
+
+    // A block size the pool couldn't allocate, not tried again until the 
+    // request changes. Pool lock.
+    std::size_t m_failedBytes;
+
+    Block m_current;
+    Block m_pending;
+    Block m_retired;
+
+    // Whether the pool knows about (and services) this lease yet
+    bool m_isRegistered;
+
+    bool service(DelayBufferPool& pool);
+    bool publish(Block block);
+};
+
+#endif // DELAY_BUFFER_POOL_H
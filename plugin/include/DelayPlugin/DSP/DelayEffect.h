@@ -14,20 +14,57 @@
 ///         DelayEffect::update();
 ///         DelayEffect::processAudioBuffer(buffer);
 ///
+///     While bypass is on and isFullyBypassed() returns true, all three can
+///     be skipped. In spectral mode that never happens: the latency stays
+///     the same while bypassed, so the dry signal still has to be delayed.
+///
 
 #ifndef DELAY_EFFECT_H
 #define DELAY_EFFECT_H
 
 #include "CircularBuffer.h"
+#include "DelayBufferPool.h"
 #include "OnePole.h"
-#include "Diffuser.h"
+#include "OnePoleTable.h"
+#include "StateVariableFilter.h"
+#include "FusedDiffuser.h"
+#include "Saturator.h"
+#include "SpectralDelay.h"
+#include "StageProfiler.h"
+#include "TraceRing.h"
+#include <array>
 #include <juce_audio_processors/juce_audio_processors.h>
 
+// Sample format of the main delay lines (float, Fixed16, Half or BFloat16).
+// Normally set from CMake; see SampleStorage.h for the trade-offs.
+#ifndef DELAY_LINE_STORAGE
+    #define DELAY_LINE_STORAGE float
+#endif
 
 class DelayEffect
 {
+public:
+    // Levels from the last processed block, for the editor's meters
+    struct BlockTelemetry
+    {
+        float feedbackRms;
+        float delayLineMin;     // range of the samples written into the
+        float delayLineMax;     // delay lines
+    };
+
 private:
     static constexpr float MAX_DELAY_SECONDS = 2.0f;
+
+    // Full-scale value when the delay lines use fixed point storage. Leaves
+    // +12 dB of headroom for the feedback loop to build up; anything louder
+    // is clamped to +/-4.0 as it is written.
+    static constexpr float DELAY_LINE_FIXED_SCALE = 4.0f;
+
+    using DelayLineStorage = DELAY_LINE_STORAGE;
+    using DelayLine = CircularBuffer<float, DelayLineStorage>;
+
+    // Nothing is allocated until the first prepareToPlay()
+    bool m_isPrepared;
     
     float m_sampleRate; 
     float m_delayTime;
@@ -35,22 +72,198 @@ private:
     float m_mix;
     bool m_isPingPongOn;
     bool m_lastIsPingPongOn;
+
+    // Bypass. Engaging or releasing it ramps between the processed and the 
+    // dry signal, a chunk at a time (see processBypassFade()). With trails, 
+    // the delay's input is ramped off instead, and what is already in the 
+    // delay plays out over the dry signal until it has died away. Once the 
+    // fade (and any tail) is over the delay is cleared, its memory goes 
+    // back to the pool, and nothing is processed until bypass is released.
+    // In spectral mode the dry signal is the spectral delay's delayed 
+    // input throughout, so bypassing doesn't change the latency.
+    static constexpr float BYPASS_FADE_SECONDS = 0.01f;
+    static constexpr float BYPASS_SILENCE_LEVEL = 1.0e-5f;     // -100 dB
+    static constexpr double TAIL_DECAY_DB = 60.0;   // reported tail length
+    static constexpr int BYPASS_CHUNK_SIZE = 256;
     bool m_isBypassOn;
     bool m_lastIsBypassOn;
+    bool m_isBypassTrailsOn;
+    bool m_isBypassTrailing;    // trails latched when bypass engaged
+    float m_bypassFadeStep;
+    float m_effectLevel;        // 1 while processing, 0 once bypassed
+    int m_silentTailSamples;
+    std::array<std::array<float, BYPASS_CHUNK_SIZE>, 2> m_bypassDry;
+
+    // LOOP_FILTER_TYPE choices from this index on use the state variable
+    // filters (low-pass, high-pass, band-pass, notch); below it the one-poles
+    static constexpr int FIRST_SVF_LOOP_FILTER_TYPE = 3;
+
+    // LOOP_FILTER_CUTOFF's range (see PluginProcessor's parameter layout). 
+    // The one-pole loop filters look their coefficients up by the 
+    // parameter's normalised value, in a table built for this range.
+    static constexpr float LOOP_FILTER_CUTOFF_MAX = 20000.0f;
+    static constexpr float LOOP_FILTER_CUTOFF_CENTRE = 500.0f;
 
     int m_loopFilterType;
     int m_lastLoopFilterType;
     float m_loopFilterCutoff;
+    float m_loopFilterPosition;     // LOOP_FILTER_CUTOFF, normalised
+    float m_loopFilterResonance;
+
+    // Cutoff the state variable filters are at. processAudioBuffer() ramps
+    // it to m_loopFilterCutoff over each block, a sample at a time.
+    float m_svfCutoff;
     
     float m_diffusion;
 
-    std::vector<CircularBuffer<float>> m_delayBuffers;
-    std::vector<OnePole<float>> m_loopFilters;
-    std::vector<Diffuser<float>> m_diffusers;
+    // Diffuser size. Changing it builds a second set of diffusers, with 
+    // the new stage lengths, in a second pool block, and crossfades the 
+    // diffuser output over to it (see updateDiffuserMemory()). The sets 
+    // and their leases take turns, and each set's rings (both channels') 
+    // live in its lease's block.
+    static constexpr float DIFFUSER_FADE_SECONDS = 0.05f;
+    float m_diffusionSize;
+    std::array<float, 2> m_diffuserSetSizes;    // size each set is laid out at
+    int m_activeDiffuserSet;
+    int m_diffuserFadeSamples;
+
+    // Samples into the crossfade to the other set. Fade position == 
+    // m_diffuserFadeSamples when no crossfade is running.
+    int m_diffuserFadePosition;
+
+    // SATURATION_TYPE: 0 is off, then the SaturationCurve values in order
+    int m_saturationType;
+    int m_lastSaturationType;
+    float m_saturationDrive;
+
+    // Spectral mode replaces the delay lines with SpectralDelay, whose 
+    // per-bin rings also come from the pool (and only while it is on)
+    bool m_isSpectralOn;
+    bool m_lastIsSpectralOn;
+    float m_spectralDelayTilt;
+    float m_spectralFeedbackTilt;
+
+    // Freeze. The last delay time's worth of each delay line is looped 
+    // as it is, with the loop filter, diffuser and delay line writes all 
+    // skipped. The loop point is crossfaded with the audio from just 
+    // before the loop, so the delay lines are sized with room for that.
+    static constexpr float FREEZE_FADE_SECONDS = 0.01f;
+    bool m_isFreezeOn;
+    bool m_lastIsFreezeOn;
+    int m_freezeFadeSamples;
+    int m_freezeLoopLength;     // the loop starts this many pushes back
+    int m_freezeLoopFadeLength;
+    float m_freezeLoopFadeStep;
+    int m_freezePosition;
+
+    // On release, the loop's next m_freezeFadeSamples samples, which fade 
+    // out under the restarted delay. Tail position == m_freezeFadeSamples 
+    // when there is nothing left to fade.
+    std::array<std::vector<float>, 2> m_freezeTails;
+    int m_freezeTailPosition;
+
+    // Reverse mode. Two voices take turns, half a segment apart, each 
+    // playing one delay time's worth of the delay line backwards under a 
+    // Hann window (overlapping windows sum to 1, so the segments crossfade). 
+    // Reading a segment backwards while the line moves forwards goes back 
+    // twice the delay time, so the delay lines are twice as long.
+    static constexpr int REVERSE_CHUNK_SIZE = 256;
+
+    struct ReverseVoice
+    {
+        int position;           // samples into the segment
+        int length;             // 0 while the voice is idle
+        double windowCos;       // cos(2 pi position / length)
+        double windowSin;
+        double stepCos;         // rotation by 2 pi / length
+        double stepSin;
+    };
+
+    bool m_isReverseOn;
+    bool m_lastIsReverseOn;
+    std::array<ReverseVoice, 2> m_reverseVoices;
+    int m_nextReverseVoice;
+    int m_reverseSamplesUntilSegment;
+    std::array<std::array<float, REVERSE_CHUNK_SIZE>, 2> m_reverseChunk;
+
+    // Smoothed delay time (ms) at the end of the last processed block
+    float m_smoothedDelayTime;
+
+    // Samples pushed into each delay line since the last clear() (see 
+    // getLiveDelaySamples()). clear() only resets these: zeroing the delay 
+    // lines themselves would take too long at high sample rates.
+    std::array<size_t, 2> m_liveDelaySamples;
+
+    // Per-channel DSP objects are held inline (hot, touched every sample).
+    // The delay lines' and diffusers' sample memory comes from the 
+    // process-wide DelayBufferPool, sized to the delay time and diffuser 
+    // size in use.
+    std::array<OnePole<float>, 2> m_loopFilters;
+    OnePoleTable<float> m_loopFilterTable;
+    std::array<StateVariableFilter<float>, 2> m_svfLoopFilters;
+    std::array<std::array<FusedDiffuser<float>, 2>, 2> m_diffuserSets;
+    std::array<Saturator<float>, 2> m_saturators;
+    std::array<DelayLine, 2> m_delayBuffers;
 
     OnePole<float> m_delayTimeLowPass; 
+
+    std::array<DelayBufferLease, 2> m_delayLeases;
+    std::array<DelayBufferLease, 2> m_diffuserLeases;
+
+    SpectralDelay m_spectralDelay;
+    DelayBufferLease m_spectralLease;
+
+#if DELAY_PLUGIN_PROFILING
+    StageProfiler m_profiler;
+#endif
+
+    // Timeline events go here when set (not owned)
+    TraceRing* m_traceRing;
+
+    // Dual-mono handling. While both inputs are bit-identical (and ping 
+    // pong is off) only the left path is run and its output is copied to 
+    // the right, which leaves the right channel's state stale until it is 
+    // needed again.
+    static constexpr float SYNC_CHECK_INTERVAL_SECONDS = 0.5f;
+    bool m_areChannelsInSync;
+    bool m_isRightChannelStale;
+    int m_samplesUntilSyncCheck;
+
+    // Checking whether the channels are back in sync is spread over blocks 
+    // (see continueSyncCheck()), comparing this many delay line samples per 
+    // sample processed. Age of the oldest delay line sample not compared 
+    // yet, or -1 while no check is running.
+    static constexpr int SYNC_CHECK_RATE = 8;
+    int m_syncCheckAge;
+
+    // Sum of squares of the feedback signal over the last block (both 
+    // channels), for metering
+    float m_feedbackSumSquares;
     
-    void clear();
+    void clear(bool shouldKeepSpectralInput = false);
+    bool isBypassSettled() const;
+    void processBypassFade(juce::AudioBuffer<float>& buffer);
+    void processEffect(juce::AudioBuffer<float>& buffer);
+    size_t getDelayBufferSize(float delayTimeMs) const;
+    void attachDelayMemory(int channel);
+    size_t getLiveDelaySamples(int channel) const;
+    void updateDelayMemory();
+    void attachSpectralMemory();
+    void updateSpectralMemory();
+    size_t getDiffuserRingBytes(float size) const;
+    void layOutDiffuserSet(int set, float size);
+    void updateDiffuserMemory();
+    bool isDiffuserFading() const;
+    void startFreeze();
+    void releaseFreeze();
+    float getFrozenSample(int channel, int position) const;
+    void processFrozen(juce::AudioBuffer<float>& buffer);
+    void resetReverse();
+    int fillReverseChunk(int numPaths, int maxSamples);
+    void readReversed(int channel, size_t firstIndex, float* dest, int n) const;
+    int selectNumPaths(const juce::AudioBuffer<float>& buffer);
+    void copyLeftChannelState();
+    bool continueSyncCheck(int numSamples);
     
 public:
     DelayEffect();
@@ -58,7 +271,20 @@ public:
     void prepareToPlay(float sampleRate);
     void releaseResources();
     void setParametersFromAPVTS(juce::AudioProcessorValueTreeState& apvts);
+    void forceBypass();
     void update();
     void processAudioBuffer(juce::AudioBuffer<float>& buffer);
+    bool isFullyBypassed() const;
+    size_t getMemoryUsageBytes() const;
+    int getLatencySamples() const;
+    double getTailLengthSeconds(const juce::AudioProcessorValueTreeState& apvts) const;
+    void setTraceRing(TraceRing* traceRing);
+    BlockTelemetry getBlockTelemetry(int numSamples) const;
+
+#if DELAY_PLUGIN_PROFILING
+    // Per-stage cycle statistics. Safe to read from any thread.
+    const StageProfiler& getProfiler() const { return m_profiler; }
+    void resetProfiler() { m_profiler.reset(); }
+#endif
 };
 #endif // DELAY_EFFECT_H
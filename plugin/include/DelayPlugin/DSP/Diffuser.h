@@ -42,6 +42,7 @@ public:
     void clear();
     void setDelayLengths(const std::vector<unsigned int>& delayLengths);
     void setGains(const std::vector<FloatType>& gains);
+    size_t getMemoryBytes() const;
 };
 
 
@@ -126,7 +127,7 @@ void Diffuser<FloatType>::setDelayLengths(const std::vector<unsigned int>& delay
         throw std::invalid_argument("delayLengths.size() must match numStages");
 
     for (size_t i = 0; i < m_allPassSections.size(); i++)
-        m_allPassSections[i].setDelayLength(delayLengths[i]);
+        m_allPassSections[i].setDelaySamples(delayLengths[i]);
 }
 
 
@@ -147,4 +148,20 @@ void Diffuser<FloatType>::setGains(const std::vector<FloatType>& gains)
 }
 
 
+/**
+ * Get the total size of the all-pass delay buffers in bytes.
+ */
+template<std::floating_point FloatType>
+size_t Diffuser<FloatType>::getMemoryBytes() const
+{
+    size_t bytes = 0;
+
+    for (const Schroeder<FloatType>& allPass : m_allPassSections)
+        bytes += allPass.getMemoryBytes();
+
+    return bytes;
+}
+
+
+
 #endif // DIFFUSER_H
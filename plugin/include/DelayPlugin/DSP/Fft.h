@@ -0,0 +1,173 @@
+///
+///     @file Fft.h
+///     @brief In-place radix-2 complex FFT with precomputed tables.
+///     @date October 18, 2026
+///
+///     Iterative decimation-in-time FFT. prepare() builds the bit reversal
+///     and twiddle tables (allocates); forward() and inverse() only read
+///     them, so they are safe on the audio thread. inverse() is unscaled:
+///     inverse(forward(x)) is N * x.
+///
+
+#ifndef FFT_H
+#define FFT_H
+
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <concepts>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * @class Fft
+ *
+ * @brief In-place radix-2 complex FFT with precomputed tables.
+ */
+template<std::floating_point FloatType>
+class Fft
+{
+public:
+    using Complex = std::complex<FloatType>;
+
+    Fft();
+    ~Fft();
+    void prepare(size_t size);
+    size_t getSize() const;
+    void forward(Complex* data) const;
+    void inverse(Complex* data) const;
+
+private:
+    size_t m_size;
+    std::vector<size_t> m_bitReversed;
+
+    // exp(-2 pi i k / N) for k < N / 2
+    std::vector<Complex> m_twiddles;
+
+    void transform(Complex* data, bool isInverse) const;
+};
+
+
+// Constructor
+template<std::floating_point FloatType>
+Fft<FloatType>::Fft() : m_size{0}
+{
+}
+
+
+// Destructor
+template<std::floating_point FloatType>
+Fft<FloatType>::~Fft()
+{
+}
+
+
+/**
+ * Build the tables for a transform size. Allocates.
+ *
+ * @param size  Transform length, a power of 2 of at least 2.
+ */
+template<std::floating_point FloatType>
+void Fft<FloatType>::prepare(size_t size)
+{
+    if (size < 2 || (size & (size - 1)) != 0)
+        throw std::invalid_argument("FFT size must be a power of 2");
+
+    m_size = size;
+    m_bitReversed.resize(size);
+    m_twiddles.resize(size / 2);
+
+    size_t numBits = 0;
+
+    while ((size_t(1) << numBits) < size)
+        numBits++;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        size_t reversed = 0;
+
+        for (size_t bit = 0; bit < numBits; bit++)
+            reversed |= ((i >> bit) & 1) << (numBits - 1 - bit);
+
+        m_bitReversed[i] = reversed;
+    }
+
+    const double TWO_PI = 6.283185307179586;
+
+    for (size_t k = 0; k < size / 2; k++)
+    {
+        double angle = -TWO_PI * static_cast<double>(k)
+                        / static_cast<double>(size);
+        m_twiddles[k] = Complex(static_cast<FloatType>(std::cos(angle)),
+                                static_cast<FloatType>(std::sin(angle)));
+    }
+}
+
+
+// Get the transform length (0 before prepare())
+template<std::floating_point FloatType>
+size_t Fft<FloatType>::getSize() const
+{
+    return m_size;
+}
+
+
+// Forward transform of getSize() values, in place
+template<std::floating_point FloatType>
+void Fft<FloatType>::forward(Complex* data) const
+{
+    transform(data, false);
+}
+
+
+// Unscaled inverse transform of getSize() values, in place
+template<std::floating_point FloatType>
+void Fft<FloatType>::inverse(Complex* data) const
+{
+    transform(data, true);
+}
+
+
+template<std::floating_point FloatType>
+void Fft<FloatType>::transform(Complex* data, bool isInverse) const
+{
+    assert(m_size != 0);
+
+    for (size_t i = 0; i < m_size; i++)
+    {
+        if (i < m_bitReversed[i])
+            std::swap(data[i], data[m_bitReversed[i]]);
+    }
+
+    // Butterflies, doubling the span each pass. The inverse uses the
+    // conjugate twiddles.
+    for (size_t span = 1; span < m_size; span *= 2)
+    {
+        size_t twiddleStride = m_size / (2 * span);
+
+        for (size_t start = 0; start < m_size; start += 2 * span)
+        {
+            for (size_t k = 0; k < span; k++)
+            {
+                Complex twiddle = m_twiddles[k * twiddleStride];
+
+                if (isInverse)
+                    twiddle = std::conj(twiddle);
+
+                // Multiplied out by hand: std::complex's operator* also
+                // handles inf/nan, and is far slower without -ffast-math
+                Complex even = data[start + k];
+                Complex x = data[start + k + span];
+                Complex odd(x.real() * twiddle.real() - x.imag() * twiddle.imag(),
+                            x.real() * twiddle.imag() + x.imag() * twiddle.real());
+
+                data[start + k] = even + odd;
+                data[start + k + span] = even - odd;
+            }
+        }
+    }
+}
+
+#endif // FFT_H
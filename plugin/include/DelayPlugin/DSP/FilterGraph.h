@@ -0,0 +1,645 @@
+///
+///     @file FilterGraph.h
+///     @brief Graph of IAudioFilter nodes compiled into a flat block schedule.
+///     @date October 18, 2026
+///
+///     Builds a signal chain out of nodes (inputs, outputs, mixers, delay
+///     lines, and any IAudioFilter) joined by edges, each with a gain. A
+///     node's input is the weighted sum of every edge that ends at it, so
+///     parallel paths are made by fanning out from one node and summing at
+///     another, and crossfades are two edges with gains (1 - a) and a.
+///
+///     Edges may form cycles, but every cycle must pass through a delay
+///     node. compile() splits each delay into a read (with no inputs) and a
+///     write (with no outputs), which breaks the cycles, and sorts the nodes
+///     topologically into a flat list of steps. Every intermediate buffer
+///     is allocated there, so process() never allocates.
+///
+///     process() runs the schedule a sub-block at a time. Each step is one
+///     pass over the sub-block: sum the step's input edges, then run the
+///     node. Filter nodes are run through a function pointer made for the
+///     filter's concrete type, which calls getNextSample() non-virtually, so
+///     the only indirect call is one per node per sub-block. Sub-blocks are
+///     no longer than the shortest delay, so a delay's read never needs a
+///     sample that the same sub-block has not written yet.
+///
+///     The hand-written chain in DelayEffect (one channel, no ping pong)
+///     is, as a graph:
+///
+///         in -> delay                         (gain 1)
+///         delay -> loopFilter                 (gain 1)
+///         loopFilter -> diffuser              (gain 1)
+///         loopFilter -> wet                   (gain 1 - diffusion)
+///         diffuser -> wet                     (gain diffusion)
+///         wet -> delay                        (gain feedback)
+///         in -> out                           (gain 1 - mix)
+///         wet -> out                          (gain mix)
+///
+///     with wet a mixer. Delays here are whole samples and fixed for a
+///     sub-block: a delay of d outputs its input from d samples ago, so
+///     DelayEffect's read-before-write of index k is a delay of k + 1.
+///
+///     The graph does not own its filters. They must outlive it, and must
+///     already be set up (sample rate, memory) before process() is called.
+///
+///     @see IAudioFilter
+///
+
+#ifndef FILTER_GRAPH_H
+#define FILTER_GRAPH_H
+
+#include "CircularBuffer.h"
+#include "IAudioFilter.h"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @class FilterGraph
+ *
+ * @brief Graph of IAudioFilter nodes compiled into a flat block schedule.
+ *
+ * Building (add*(), connect(), compile()) allocates and must happen off
+ * the audio thread. process(), setGain(), setDelay() and clear() are for
+ * the audio thread. Adding nodes or edges after compile() means compiling
+ * again before the next process().
+ */
+template<std::floating_point FloatType>
+class FilterGraph
+{
+public:
+    using NodeId = int;
+    using EdgeId = int;
+
+    FilterGraph();
+    ~FilterGraph();
+    FilterGraph(const FilterGraph&) = delete;
+    FilterGraph& operator=(const FilterGraph&) = delete;
+
+    NodeId addInput();
+    NodeId addOutput();
+    NodeId addMixer();
+    NodeId addDelay(size_t maxDelaySamples);
+
+    template<typename Filter>
+        requires std::derived_from<Filter, IAudioFilter<FloatType>>
+    NodeId addFilter(Filter& filter);
+
+    EdgeId connect(NodeId from, NodeId to, FloatType gain = FloatType(1));
+    void compile(size_t maxBlockSize);
+    bool isCompiled() const;
+
+    void process(const FloatType* const* inputs, FloatType* const* outputs,
+                    size_t numSamples);
+    void setGain(EdgeId edge, FloatType gain);
+    void setDelay(NodeId delay, size_t delaySamples);
+    void clear();
+
+    int getNumInputs() const;
+    int getNumOutputs() const;
+    size_t getNumSteps() const;
+
+private:
+    // Runs a filter over a block: out[i] = filter.getNextSample(in[i])
+    using Kernel = void (*)(void* filter, const FloatType* in, FloatType* out,
+                                size_t n);
+
+    enum class NodeType { input, output, mixer, delay, filter };
+
+    // What a step does with the sum of its inputs
+    enum class StepType { readInput, writeOutput, mix, readDelay, writeDelay,
+                            runFilter };
+
+    struct Node
+    {
+        NodeType type;
+        void* filter;
+        Kernel kernel;
+
+        // Input/output channel, or index into m_delayLines
+        int index;
+    };
+
+    struct Edge
+    {
+        NodeId from;
+        NodeId to;
+    };
+
+    struct DelayLine
+    {
+        CircularBuffer<FloatType> buffer;
+        size_t maxDelay;
+        size_t delay;
+    };
+
+    struct Step
+    {
+        StepType type;
+        void* filter;
+        Kernel kernel;
+        int index;
+        FloatType* output;
+        size_t firstInput;
+        size_t numInputs;
+    };
+
+    // One edge into a step: where to read from and which gain to use
+    struct StepInput
+    {
+        const FloatType* source;
+        EdgeId edge;
+    };
+
+    std::vector<Node> m_nodes;
+    std::vector<Edge> m_edges;
+    std::vector<FloatType> m_gains;
+    std::vector<DelayLine> m_delayLines;
+    int m_numInputs;
+    int m_numOutputs;
+
+    // Compiled schedule, and the buffers it reads and writes
+    std::vector<Step> m_schedule;
+    std::vector<StepInput> m_stepInputs;
+    std::vector<FloatType> m_bufferStorage;
+    FloatType* m_scratch;
+    size_t m_maxBlockSize;
+    bool m_isCompiled;
+
+    NodeId addNode(NodeType type, void* filter, Kernel kernel, int index);
+    size_t getMaxSubBlockSize() const;
+    void sumInputs(const Step& step, FloatType* dest, size_t n) const;
+    void runStep(const Step& step, const FloatType* const* inputs,
+                    FloatType* const* outputs, size_t offset, size_t n);
+
+    template<typename Filter>
+    static void runFilter(void* filter, const FloatType* in, FloatType* out,
+                            size_t n);
+};
+
+
+// Constructor
+template<std::floating_point FloatType>
+FilterGraph<FloatType>::FilterGraph() : m_numInputs{0}, m_numOutputs{0},
+    m_scratch{nullptr}, m_maxBlockSize{0}, m_isCompiled{false}
+{
+}
+
+
+// Destructor
+template<std::floating_point FloatType>
+FilterGraph<FloatType>::~FilterGraph()
+{
+}
+
+
+/**
+ * Add an external input. Inputs are numbered in the order they are added,
+ * which is the order of the channel pointers given to process().
+ */
+template<std::floating_point FloatType>
+typename FilterGraph<FloatType>::NodeId FilterGraph<FloatType>::addInput()
+{
+    return addNode(NodeType::input, nullptr, nullptr, m_numInputs++);
+}
+
+
+/**
+ * Add an external output. Outputs are numbered in the order they are
+ * added. Each output is overwritten with the sum of its input edges.
+ */
+template<std::floating_point FloatType>
+typename FilterGraph<FloatType>::NodeId FilterGraph<FloatType>::addOutput()
+{
+    return addNode(NodeType::output, nullptr, nullptr, m_numOutputs++);
+}
+
+
+// Add a node that outputs the sum of its input edges
+template<std::floating_point FloatType>
+typename FilterGraph<FloatType>::NodeId FilterGraph<FloatType>::addMixer()
+{
+    return addNode(NodeType::mixer, nullptr, nullptr, 0);
+}
+
+
+/**
+ * Add a delay line. Its delay starts at maxDelaySamples and can be changed
+ * with setDelay(). Feedback edges must pass through a delay.
+ *
+ * @param maxDelaySamples  Longest delay, in samples. Must be at least 1.
+ */
+template<std::floating_point FloatType>
+typename FilterGraph<FloatType>::NodeId
+FilterGraph<FloatType>::addDelay(size_t maxDelaySamples)
+{
+    if (maxDelaySamples == 0)
+        throw std::invalid_argument("Delay must be at least one sample");
+
+    m_delayLines.push_back({CircularBuffer<FloatType>(), maxDelaySamples,
+                            maxDelaySamples});
+
+    return addNode(NodeType::delay, nullptr, nullptr,
+                    static_cast<int>(m_delayLines.size()) - 1);
+}
+
+
+/**
+ * Add a filter node. The graph keeps a reference to the filter, which
+ * must outlive the graph.
+ */
+template<std::floating_point FloatType>
+template<typename Filter>
+    requires std::derived_from<Filter, IAudioFilter<FloatType>>
+typename FilterGraph<FloatType>::NodeId
+FilterGraph<FloatType>::addFilter(Filter& filter)
+{
+    return addNode(NodeType::filter, &filter, &runFilter<Filter>, 0);
+}
+
+
+/**
+ * Connect one node's output to another node's input. A node's input is
+ * the sum of all its edges, in the order they were connected.
+ *
+ * @return  The edge, for setGain()
+ */
+template<std::floating_point FloatType>
+typename FilterGraph<FloatType>::EdgeId
+FilterGraph<FloatType>::connect(NodeId from, NodeId to, FloatType gain)
+{
+    int numNodes = static_cast<int>(m_nodes.size());
+
+    if (from < 0 || from >= numNodes || to < 0 || to >= numNodes)
+        throw std::invalid_argument("Edge refers to a node not in the graph");
+
+    if (m_nodes[from].type == NodeType::output)
+        throw std::invalid_argument("An output node has no output to connect");
+
+    if (m_nodes[to].type == NodeType::input)
+        throw std::invalid_argument("An input node takes no edges");
+
+    m_edges.push_back({from, to});
+    m_gains.push_back(gain);
+    m_isCompiled = false;
+
+    return static_cast<EdgeId>(m_edges.size()) - 1;
+}
+
+
+/**
+ * Sort the graph into a schedule and allocate all the buffers it needs.
+ * Allocates, so never call from the audio thread. Delay lines are cleared.
+ *
+ * @param maxBlockSize  Most samples a process() call's sub-blocks will
+ *                      hold. Longer calls are split.
+ * @throws std::invalid_argument  If a cycle does not pass through a delay
+ */
+template<std::floating_point FloatType>
+void FilterGraph<FloatType>::compile(size_t maxBlockSize)
+{
+    if (maxBlockSize == 0)
+        throw std::invalid_argument("Block size must be at least one sample");
+
+    // Vertices are the nodes, plus one extra per delay line for its write.
+    // A delay node's own vertex is its read, which has no inputs.
+    const int numNodes = static_cast<int>(m_nodes.size());
+    const int numVertices = numNodes + static_cast<int>(m_delayLines.size());
+
+    auto getTargetVertex = [&](NodeId node) {
+        return m_nodes[node].type == NodeType::delay
+                ? numNodes + m_nodes[node].index : node;
+    };
+
+    std::vector<int> numPending(numVertices, 0);
+    std::vector<std::vector<EdgeId>> outgoing(numVertices);
+    std::vector<std::vector<EdgeId>> incoming(numVertices);
+
+    for (EdgeId edge = 0; edge < static_cast<EdgeId>(m_edges.size()); edge++)
+    {
+        int target = getTargetVertex(m_edges[edge].to);
+        outgoing[m_edges[edge].from].push_back(edge);
+        incoming[target].push_back(edge);
+        numPending[target]++;
+    }
+
+    // Kahn's algorithm. Ready vertices are taken in the order they become
+    // ready, so the schedule follows the order the graph was built in.
+    // Inputs go first, so outputs may alias them.
+    std::vector<int> order;
+    order.reserve(numVertices);
+
+    for (int vertex = 0; vertex < numNodes; vertex++)
+        if (m_nodes[vertex].type == NodeType::input)
+            order.push_back(vertex);
+
+    for (int vertex = 0; vertex < numVertices; vertex++)
+        if (numPending[vertex] == 0 && (vertex >= numNodes
+                || m_nodes[vertex].type != NodeType::input))
+            order.push_back(vertex);
+
+    for (size_t next = 0; next < order.size(); next++)
+    {
+        if (order[next] >= numNodes)
+            continue;
+
+        for (EdgeId edge : outgoing[order[next]])
+        {
+            int target = getTargetVertex(m_edges[edge].to);
+
+            if (--numPending[target] == 0)
+                order.push_back(target);
+        }
+    }
+
+    if (static_cast<int>(order.size()) != numVertices)
+        throw std::invalid_argument("Every cycle must pass through a delay");
+
+    // One block per vertex that produces a signal, plus the scratch block
+    // that filters and delay writes sum their inputs into
+    std::vector<int> bufferIndex(numNodes, -1);
+    int numBuffers = 0;
+
+    for (int node = 0; node < numNodes; node++)
+        if (m_nodes[node].type != NodeType::output)
+            bufferIndex[node] = numBuffers++;
+
+    m_bufferStorage.assign((numBuffers + 1) * maxBlockSize, FloatType(0));
+    m_scratch = m_bufferStorage.data() + numBuffers * maxBlockSize;
+    m_maxBlockSize = maxBlockSize;
+
+    auto getBuffer = [&](NodeId node) {
+        return m_bufferStorage.data() + bufferIndex[node] * maxBlockSize;
+    };
+
+    m_schedule.clear();
+    m_stepInputs.clear();
+
+    for (int vertex : order)
+    {
+        Step step{};
+
+        if (vertex >= numNodes)
+        {
+            step.type = StepType::writeDelay;
+            step.index = vertex - numNodes;
+        }
+        else
+        {
+            const Node& node = m_nodes[vertex];
+            step.index = node.index;
+            step.filter = node.filter;
+            step.kernel = node.kernel;
+
+            if (node.type != NodeType::output)
+                step.output = getBuffer(vertex);
+
+            switch (node.type)
+            {
+                case NodeType::input:  step.type = StepType::readInput;   break;
+                case NodeType::output: step.type = StepType::writeOutput; break;
+                case NodeType::mixer:  step.type = StepType::mix;         break;
+                case NodeType::delay:  step.type = StepType::readDelay;   break;
+                case NodeType::filter: step.type = StepType::runFilter;   break;
+            }
+        }
+
+        step.firstInput = m_stepInputs.size();
+        step.numInputs = incoming[vertex].size();
+
+        for (EdgeId edge : incoming[vertex])
+            m_stepInputs.push_back({getBuffer(m_edges[edge].from), edge});
+
+        m_schedule.push_back(step);
+    }
+
+    for (DelayLine& line : m_delayLines)
+        line.buffer.resize(std::bit_ceil(line.maxDelay));
+
+    m_isCompiled = true;
+}
+
+
+// Whether the graph has been compiled since it last changed
+template<std::floating_point FloatType>
+bool FilterGraph<FloatType>::isCompiled() const
+{
+    return m_isCompiled;
+}
+
+
+/**
+ * Run the graph. Must be compiled.
+ *
+ * @param inputs      One pointer per input node, each numSamples long
+ * @param outputs     One pointer per output node, each numSamples long.
+ *                    May alias the inputs.
+ * @param numSamples  Any length; runs as sub-blocks of at most the
+ *                    compiled block size and the shortest current delay.
+ */
+template<std::floating_point FloatType>
+void FilterGraph<FloatType>::process(const FloatType* const* inputs,
+                                FloatType* const* outputs, size_t numSamples)
+{
+    assert(m_isCompiled);
+
+    const size_t maxSubBlockSize = getMaxSubBlockSize();
+
+    for (size_t offset = 0; offset < numSamples; )
+    {
+        size_t n = std::min(numSamples - offset, maxSubBlockSize);
+
+        for (const Step& step : m_schedule)
+            runStep(step, inputs, outputs, offset, n);
+
+        offset += n;
+    }
+}
+
+
+// Set an edge's gain. Takes effect from the next process() call.
+template<std::floating_point FloatType>
+void FilterGraph<FloatType>::setGain(EdgeId edge, FloatType gain)
+{
+    assert(edge >= 0 && edge < static_cast<EdgeId>(m_gains.size()));
+    m_gains[edge] = gain;
+}
+
+
+/**
+ * Set a delay node's delay. Takes effect from the next process() call.
+ *
+ * @param delaySamples  Clamped to [1, the delay's maxDelaySamples]
+ */
+template<std::floating_point FloatType>
+void FilterGraph<FloatType>::setDelay(NodeId delay, size_t delaySamples)
+{
+    assert(m_nodes[delay].type == NodeType::delay);
+    DelayLine& line = m_delayLines[m_nodes[delay].index];
+    line.delay = std::clamp(delaySamples, size_t(1), line.maxDelay);
+}
+
+
+// Clear the delay lines. The filters are the caller's to clear.
+template<std::floating_point FloatType>
+void FilterGraph<FloatType>::clear()
+{
+    for (DelayLine& line : m_delayLines)
+        line.buffer.clear();
+}
+
+
+// Get the number of input nodes (channels process() reads)
+template<std::floating_point FloatType>
+int FilterGraph<FloatType>::getNumInputs() const
+{
+    return m_numInputs;
+}
+
+
+// Get the number of output nodes (channels process() writes)
+template<std::floating_point FloatType>
+int FilterGraph<FloatType>::getNumOutputs() const
+{
+    return m_numOutputs;
+}
+
+
+// Get the length of the compiled schedule
+template<std::floating_point FloatType>
+size_t FilterGraph<FloatType>::getNumSteps() const
+{
+    return m_schedule.size();
+}
+
+
+template<std::floating_point FloatType>
+typename FilterGraph<FloatType>::NodeId
+FilterGraph<FloatType>::addNode(NodeType type, void* filter, Kernel kernel,
+                                    int index)
+{
+    m_nodes.push_back({type, filter, kernel, index});
+    m_isCompiled = false;
+
+    return static_cast<NodeId>(m_nodes.size()) - 1;
+}
+
+
+// A delay's read for a whole sub-block happens before its write, so a
+// sub-block can be no longer than the shortest delay
+template<std::floating_point FloatType>
+size_t FilterGraph<FloatType>::getMaxSubBlockSize() const
+{
+    size_t maxSize = m_maxBlockSize;
+
+    for (const DelayLine& line : m_delayLines)
+        maxSize = std::min(maxSize, line.delay);
+
+    return maxSize;
+}
+
+
+// dest = sum of the step's input edges, each times its gain
+template<std::floating_point FloatType>
+void FilterGraph<FloatType>::sumInputs(const Step& step, FloatType* dest,
+                                            size_t n) const
+{
+    if (step.numInputs == 0)
+    {
+        std::fill(dest, dest + n, FloatType(0));
+        return;
+    }
+
+    const StepInput* input = m_stepInputs.data() + step.firstInput;
+    const FloatType* source = input[0].source;
+    FloatType gain = m_gains[input[0].edge];
+
+    for (size_t i = 0; i < n; i++)
+        dest[i] = gain * source[i];
+
+    for (size_t k = 1; k < step.numInputs; k++)
+    {
+        source = input[k].source;
+        gain = m_gains[input[k].edge];
+
+        for (size_t i = 0; i < n; i++)
+            dest[i] += gain * source[i];
+    }
+}
+
+
+template<std::floating_point FloatType>
+void FilterGraph<FloatType>::runStep(const Step& step,
+                const FloatType* const* inputs, FloatType* const* outputs,
+                    size_t offset, size_t n)
+{
+    switch (step.type)
+    {
+        case StepType::readInput:
+            std::copy(inputs[step.index] + offset,
+                        inputs[step.index] + offset + n, step.output);
+            break;
+
+        case StepType::writeOutput:
+            sumInputs(step, outputs[step.index] + offset, n);
+            break;
+
+        case StepType::mix:
+            sumInputs(step, step.output, n);
+            break;
+
+        case StepType::readDelay:
+        {
+            // Sample i of the sub-block is the one pushed delay - i samples
+            // before the sub-block's first, i.e. index size - delay + i
+            // counting from the oldest
+            const DelayLine& line = m_delayLines[step.index];
+            line.buffer.readBlock(line.buffer.getSize() - line.delay,
+                                    step.output, n);
+            break;
+        }
+
+        case StepType::writeDelay:
+            sumInputs(step, m_scratch, n);
+            m_delayLines[step.index].buffer.pushBlock(m_scratch, n);
+            break;
+
+        case StepType::runFilter:
+        {
+            // A serial connection needs no summing: run straight off the
+            // source's buffer
+            const StepInput* input = m_stepInputs.data() + step.firstInput;
+
+            if (step.numInputs == 1 && m_gains[input->edge] == FloatType(1))
+            {
+                step.kernel(step.filter, input->source, step.output, n);
+            }
+            else
+            {
+                sumInputs(step, m_scratch, n);
+                step.kernel(step.filter, m_scratch, step.output, n);
+            }
+            break;
+        }
+    }
+}
+
+
+// The qualified call binds to Filter's own getNextSample(), so the loop
+// makes no virtual calls and the compiler can inline the filter
+template<std::floating_point FloatType>
+template<typename Filter>
+void FilterGraph<FloatType>::runFilter(void* filter, const FloatType* in,
+                                        FloatType* out, size_t n)
+{
+    Filter& typedFilter = *static_cast<Filter*>(filter);
+
+    for (size_t i = 0; i < n; i++)
+        out[i] = typedFilter.Filter::getNextSample(in[i]);
+}
+
+#endif // FILTER_GRAPH_H
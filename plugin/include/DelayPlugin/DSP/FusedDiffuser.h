@@ -0,0 +1,486 @@
+///
+///     @file FusedDiffuser.h
+///     @brief Multi-stage all-pass diffuser with one shared delay ring.
+///     @date October 18, 2026
+///
+///     Same filter as Diffuser (Schroeder all-pass sections in series), but
+///     all stages live in one contiguous power-of-two ring that is indexed
+///     with a single write index and a single mask. Each stage sits at a
+///     fixed offset from the write index:
+///
+///         stage i writes at   writeIndex + writeOffset[i]
+///         stage i reads at    writeIndex + writeOffset[i] - delay[i] - 1
+///
+///     and the offsets are spaced so that no stage's live samples overlap
+///     another's. The ring only has to hold the sum of the stage lengths,
+///     instead of rounding every stage up to its own power of two, and the
+///     whole cascade runs as one loop over a flat array of stages.
+///
+///     Stage lengths are given at REFERENCE_SAMPLE_RATE and scaled to the
+///     current sample rate by setSampleRate(), so the diffusion sounds the
+///     same at any rate. A length scale on top of that makes the whole
+///     diffuser larger or smaller.
+///
+///     setLayout() changes the sample rate and length scale in one go on
+///     memory the caller provides, without allocating, so a replacement
+///     diffuser can be built on the audio thread on memory prepared
+///     elsewhere (see DelayEffect).
+///
+///     Construction never allocates: the stages are held in a fixed-size
+///     array and the ring is only allocated (or given by setLayout()) once
+///     the sample rate is set. getNextSample() must not be called before
+///     that.
+///
+///     @see Diffuser
+///     @see Schroeder
+///
+
+#ifndef FUSED_DIFFUSER_H
+#define FUSED_DIFFUSER_H
+
+#include "IAudioFilter.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @class FusedDiffuser
+ *
+ * @brief Multi-stage all-pass diffuser with one shared delay ring.
+ *
+ * @implements IAudioFilter
+ */
+template<std::floating_point FloatType>
+class FusedDiffuser : public IAudioFilter<FloatType>
+{
+public:
+    // Sample rate the reference delay lengths are specified at (Freeverb's)
+    static constexpr FloatType REFERENCE_SAMPLE_RATE = FloatType(44100);
+
+    // Most all-pass sections a diffuser can have
+    static constexpr size_t MAX_STAGES = 8;
+
+    // Alignment of the ring memory setLayout() takes, which getRingBytes()
+    // pads to
+    static constexpr size_t RING_ALIGNMENT = 64;
+
+    FusedDiffuser(std::span<const unsigned int> referenceLengths,
+                    std::span<const FloatType> gains);
+    FusedDiffuser(const FusedDiffuser& other);
+    FusedDiffuser& operator=(const FusedDiffuser&) = delete;
+    ~FusedDiffuser();
+    FloatType getNextSample(FloatType x) override;
+    void clear();
+    void setSampleRate(FloatType sampleRate);
+    void setDelayLengths(std::span<const unsigned int> referenceLengths);
+    void setLengthScale(FloatType lengthScale);
+    void setLayout(FloatType sampleRate, FloatType lengthScale, FloatType* ring);
+    void setGains(std::span<const FloatType> gains);
+    size_t getNumStages() const;
+    unsigned int getDelaySamples(size_t stage) const;
+    size_t getMemoryBytes() const;
+    size_t getRingBytes(FloatType sampleRate, FloatType lengthScale) const;
+    void copyStateFrom(const FusedDiffuser& other);
+    bool hasSameStateAs(const FusedDiffuser& other) const;
+
+private:
+    struct Stage
+    {
+        size_t writeOffset;
+        size_t readOffset;
+        FloatType gain;
+        unsigned int referenceLength;
+        unsigned int delayInSamples;
+    };
+
+    std::array<Stage, MAX_STAGES> m_stageStorage;
+    std::span<Stage> m_stages;
+    FloatType* m_ring;
+    size_t m_mask;
+    size_t m_writeIndex;
+    FloatType m_sampleRate;
+    FloatType m_lengthScale;
+
+    // Ring size needed by the current stage lengths, and the size of the
+    // memory the ring currently has (which may be larger)
+    size_t m_requiredSize;
+    size_t m_ringSize;
+
+    // Ring memory when not given by setLayout()
+    std::vector<FloatType> m_ownedRing;
+
+    static unsigned int scaleLength(unsigned int referenceLength, 
+                                    FloatType sampleRate);
+    size_t getRingSize(FloatType sampleRate, FloatType lengthScale) const;
+    void layOutStages();
+    void fitRing();
+};
+
+
+// Constructor
+/**
+ * Construct a fused diffuser. The number of stages is the length of the
+ * arrays (at most MAX_STAGES). Doesn't allocate; the ring is allocated when
+ * the sample rate is set.
+ *
+ * @param referenceLengths  The delay length of each all-pass section in
+ *                          samples at REFERENCE_SAMPLE_RATE. Requires values
+ *                          of at least 1.
+ *
+ * @param gains             The gain coefficient of each all-pass section.
+ *                          Requires values between 0 and 1.
+ */
+template<std::floating_point FloatType>
+FusedDiffuser<FloatType>::FusedDiffuser(
+        std::span<const unsigned int> referenceLengths,
+        std::span<const FloatType> gains)
+    : m_stageStorage{}, m_ring{nullptr}, m_mask{0}, m_writeIndex{0},
+      m_sampleRate{REFERENCE_SAMPLE_RATE}, m_lengthScale{1}, m_requiredSize{0}, 
+      m_ringSize{0}
+{
+    if (referenceLengths.size() != gains.size())
+        throw std::invalid_argument("gains.size() must match the number of stages");
+
+    if (referenceLengths.size() > MAX_STAGES)
+        throw std::invalid_argument("too many stages");
+
+    for (unsigned int length : referenceLengths)
+    {
+        if (length < 1)
+            throw std::invalid_argument("delay lengths must be at least 1");
+    }
+
+    m_stages = std::span<Stage>(m_stageStorage.data(), referenceLengths.size());
+
+    for (size_t i = 0; i < m_stages.size(); i++)
+        m_stages[i].referenceLength = referenceLengths[i];
+
+    setGains(gains);
+    layOutStages();
+}
+
+
+// Copy constructor. The copy gets its own (not yet allocated) ring.
+template<std::floating_point FloatType>
+FusedDiffuser<FloatType>::FusedDiffuser(const FusedDiffuser& other)
+    : m_stageStorage{other.m_stageStorage}, 
+      m_stages{m_stageStorage.data(), other.m_stages.size()}, m_ring{nullptr}, 
+      m_mask{0}, m_writeIndex{0}, m_sampleRate{other.m_sampleRate}, 
+      m_lengthScale{other.m_lengthScale}, m_requiredSize{other.m_requiredSize}, 
+      m_ringSize{0}
+{
+}
+
+
+// Destructor
+template<std::floating_point FloatType>
+FusedDiffuser<FloatType>::~FusedDiffuser()
+{
+}
+
+
+/**
+ * Process an audio sample.
+ *
+ * @param x    The input sample.
+ *
+ * @return     The output sample.
+ */
+template<std::floating_point FloatType>
+FloatType FusedDiffuser<FloatType>::getNextSample(FloatType x)
+{
+    FloatType y = x;
+
+    // Same difference equation as Schroeder::getNextSample(), for each
+    // stage in series
+    for (const Stage& stage : m_stages)
+    {
+        FloatType delayed = m_ring[(m_writeIndex + stage.readOffset) & m_mask];
+        FloatType mixed = y + stage.gain * delayed;
+        y = -stage.gain * mixed + delayed;
+
+        m_ring[(m_writeIndex + stage.writeOffset) & m_mask] = mixed;
+    }
+
+    m_writeIndex++;
+
+    return y;
+}
+
+
+/**
+ * Clear the delay ring.
+ */
+template<std::floating_point FloatType>
+void FusedDiffuser<FloatType>::clear()
+{
+    std::fill(m_ring, m_ring + m_ringSize, FloatType(0));
+    m_writeIndex = 0;
+}
+
+
+/**
+ * Set the sample rate, rescaling every stage's delay length. Allocates the
+ * diffuser's own ring if the new lengths don't fit in the current one. The
+ * ring is cleared.
+ *
+ * @param sampleRate    The sample rate in Hz.
+ */
+template<std::floating_point FloatType>
+void FusedDiffuser<FloatType>::setSampleRate(FloatType sampleRate)
+{
+    m_sampleRate = sampleRate;
+    layOutStages();
+    fitRing();
+}
+
+
+/**
+ * Set the delay length of each all-pass section. May allocate if the new
+ * lengths don't fit in the current ring. The ring is cleared.
+ *
+ * @param referenceLengths  The delay length of each all-pass section in
+ *                          samples at REFERENCE_SAMPLE_RATE.
+ */
+template<std::floating_point FloatType>
+void FusedDiffuser<FloatType>::setDelayLengths(
+        std::span<const unsigned int> referenceLengths)
+{
+    if (referenceLengths.size() != m_stages.size())
+        throw std::invalid_argument("referenceLengths.size() must match the number of stages");
+
+    for (unsigned int length : referenceLengths)
+    {
+        if (length < 1)
+            throw std::invalid_argument("delay lengths must be at least 1");
+    }
+
+    for (size_t i = 0; i < m_stages.size(); i++)
+        m_stages[i].referenceLength = referenceLengths[i];
+
+    layOutStages();
+    fitRing();
+}
+
+
+/**
+ * Scale every stage's delay length (1 gives the reference lengths). May 
+ * allocate if the new lengths don't fit in the current ring. The ring is 
+ * cleared.
+ *
+ * @param lengthScale   Requires a value above 0.
+ */
+template<std::floating_point FloatType>
+void FusedDiffuser<FloatType>::setLengthScale(FloatType lengthScale)
+{
+    if (lengthScale <= FloatType(0))
+        throw std::invalid_argument("lengthScale must be above 0");
+
+    m_lengthScale = lengthScale;
+    layOutStages();
+    fitRing();
+}
+
+
+/**
+ * Set the sample rate and length scale, and use ring memory owned by 
+ * someone else. Never allocates, so it may be called on the audio thread.
+ * The ring is cleared.
+ *
+ * @param sampleRate    The sample rate in Hz.
+ *
+ * @param lengthScale   As for setLengthScale().
+ *
+ * @param ring          Cache-line aligned memory of at least 
+ *                      getRingBytes(sampleRate, lengthScale) bytes, which 
+ *                      must outlive its use by the diffuser.
+ */
+template<std::floating_point FloatType>
+void FusedDiffuser<FloatType>::setLayout(FloatType sampleRate, 
+                                        FloatType lengthScale, FloatType* ring)
+{
+    assert(lengthScale > FloatType(0) && ring != nullptr);
+
+    m_sampleRate = sampleRate;
+    m_lengthScale = lengthScale;
+    layOutStages();
+
+    m_ring = ring;
+    m_ringSize = m_requiredSize;
+    m_mask = m_ringSize - 1;
+    m_ownedRing = std::vector<FloatType>();
+
+    clear();
+}
+
+
+/**
+ * Set the gain coefficient of each all-pass section.
+ *
+ * @param gains   The gain coefficient of each all-pass section.
+ */
+template<std::floating_point FloatType>
+void FusedDiffuser<FloatType>::setGains(std::span<const FloatType> gains)
+{
+    if (gains.size() != m_stages.size())
+        throw std::invalid_argument("gains.size() must match the number of stages");
+
+    for (FloatType gain : gains)
+    {
+        if ( (gain < FloatType(0)) || (gain > FloatType(1)) )
+            throw std::invalid_argument("gain must be between 0 and 1");
+    }
+
+    for (size_t i = 0; i < m_stages.size(); i++)
+        m_stages[i].gain = gains[i];
+}
+
+
+// Get the number of all-pass sections
+template<std::floating_point FloatType>
+size_t FusedDiffuser<FloatType>::getNumStages() const
+{
+    return m_stages.size();
+}
+
+
+// Get a stage's delay length in samples at the current sample rate
+template<std::floating_point FloatType>
+unsigned int FusedDiffuser<FloatType>::getDelaySamples(size_t stage) const
+{
+    return m_stages[stage].delayInSamples;
+}
+
+
+/**
+ * Get the size of the ring memory owned by the diffuser in bytes (0 when
+ * the ring was given by setLayout()).
+ */
+template<std::floating_point FloatType>
+size_t FusedDiffuser<FloatType>::getMemoryBytes() const
+{
+    return m_ownedRing.size() * sizeof(FloatType);
+}
+
+
+/**
+ * Get the number of bytes of ring memory setLayout() needs for a sample 
+ * rate and length scale, padded to a whole number of cache lines. Doesn't 
+ * change anything.
+ */
+template<std::floating_point FloatType>
+size_t FusedDiffuser<FloatType>::getRingBytes(FloatType sampleRate, 
+                                                FloatType lengthScale) const
+{
+    size_t bytes = getRingSize(sampleRate, lengthScale) * sizeof(FloatType);
+
+    return (bytes + RING_ALIGNMENT - 1) / RING_ALIGNMENT * RING_ALIGNMENT;
+}
+
+
+/**
+ * Make this diffuser's ring contents match another's, so both give the same
+ * output from here on. Doesn't allocate. Both must have the same stage
+ * lengths and ring size (e.g. the two channels of one effect).
+ */
+template<std::floating_point FloatType>
+void FusedDiffuser<FloatType>::copyStateFrom(const FusedDiffuser& other)
+{
+    assert(other.m_ringSize == m_ringSize);
+
+    std::copy(other.m_ring, other.m_ring + m_ringSize, m_ring);
+    m_writeIndex = other.m_writeIndex;
+}
+
+
+/**
+ * Check whether this diffuser's state is bit-identical to another's, i.e.
+ * whether both will give the same output for the same input. Reads the
+ * whole ring, so not for use on every sample.
+ */
+template<std::floating_point FloatType>
+bool FusedDiffuser<FloatType>::hasSameStateAs(const FusedDiffuser& other) const
+{
+    if (other.m_ringSize != m_ringSize || 
+            ((other.m_writeIndex ^ m_writeIndex) & m_mask) != 0)
+        return false;
+
+    return std::memcmp(m_ring, other.m_ring, m_ringSize * sizeof(FloatType)) == 0;
+}
+
+
+// Scale a reference stage length to a sample rate
+template<std::floating_point FloatType>
+unsigned int FusedDiffuser<FloatType>::scaleLength(unsigned int referenceLength,
+                                                    FloatType sampleRate)
+{
+    auto scaled = std::lround(referenceLength * sampleRate / REFERENCE_SAMPLE_RATE);
+    return static_cast<unsigned int>(std::max(scaled, 1L));
+}
+
+
+// Like Schroeder, a stage reads before it writes, so a stage of length D
+// delays by D + 1 samples and has D + 2 live slots (including the one being
+// written). Stages are packed back to back by that amount.
+
+// Get the ring size the stages need at a sample rate and length scale. 
+// Scaling the lengths is the same as scaling the sample rate.
+template<std::floating_point FloatType>
+size_t FusedDiffuser<FloatType>::getRingSize(FloatType sampleRate, 
+                                                FloatType lengthScale) const
+{
+    size_t offset = 0;
+
+    for (const Stage& stage : m_stages)
+        offset += scaleLength(stage.referenceLength, sampleRate * lengthScale) + 2;
+
+    return std::bit_ceil(offset);
+}
+
+
+// Scale the stage lengths to the sample rate and length scale, and place
+// each stage in the ring
+template<std::floating_point FloatType>
+void FusedDiffuser<FloatType>::layOutStages()
+{
+    size_t offset = 0;
+
+    for (Stage& stage : m_stages)
+    {
+        stage.delayInSamples = scaleLength(stage.referenceLength, 
+                                            m_sampleRate * m_lengthScale);
+
+        offset += stage.delayInSamples + 2;
+        stage.writeOffset = offset;
+        stage.readOffset = offset - stage.delayInSamples - 1;
+    }
+
+    m_requiredSize = std::bit_ceil(offset);
+}
+
+
+// Make sure the ring can hold the current layout, and clear it
+template<std::floating_point FloatType>
+void FusedDiffuser<FloatType>::fitRing()
+{
+    // Only allocate if the current memory (owned or given) is too small
+    if (m_requiredSize > m_ringSize)
+    {
+        m_ownedRing.assign(m_requiredSize, FloatType(0));
+        m_ring = m_ownedRing.data();
+        m_ringSize = m_requiredSize;
+    }
+
+    m_mask = m_ringSize - 1;
+
+    clear();
+}
+
+#endif // FUSED_DIFFUSER_H
@@ -0,0 +1,55 @@
+///
+///     @file MirroredMemory.h
+///     @brief Double-mapped ("mirrored") virtual memory region.
+///     @date October 18, 2026
+///
+///     This class maps the same physical pages twice, back to back, so that
+///     the byte at address (data + i) is also visible at (data + i + size).
+///     A ring buffer stored in this region can read or write any span of up
+///     to its full length through one contiguous pointer, without splitting
+///     the access at the wrap point.
+///
+///     Mirroring is currently implemented on Linux (memfd + mmap). On other
+///     platforms, or if the mapping fails, allocate() returns false and the
+///     caller is expected to fall back to ordinary heap memory.
+///
+///     @see CircularBuffer
+///
+
+#ifndef MIRRORED_MEMORY_H
+#define MIRRORED_MEMORY_H
+
+#include <cstddef>
+
+
+/**
+ * @class MirroredMemory
+ *
+ * @brief Double-mapped virtual memory region. Move-only.
+ */
+class MirroredMemory
+{
+private:
+    void* m_data;
+    std::size_t m_size;
+
+public:
+    MirroredMemory();
+    ~MirroredMemory();
+    MirroredMemory(MirroredMemory&& other) noexcept;
+    MirroredMemory& operator=(MirroredMemory&& other) noexcept;
+    MirroredMemory(const MirroredMemory&) = delete;
+    MirroredMemory& operator=(const MirroredMemory&) = delete;
+
+    bool allocate(std::size_t numBytes);
+    void release();
+
+    void* getData() const { return m_data; }
+    std::size_t getSize() const { return m_size; }
+    bool isAllocated() const { return m_data != nullptr; }
+
+    static std::size_t getPageSize();
+    static bool canMirror(std::size_t numBytes);
+};
+
+#endif // MIRRORED_MEMORY_H
@@ -15,9 +15,11 @@
 #define ONE_POLE_H
 
 #include "IAudioFilter.h"
+#include "OnePoleTable.h"
 #include <cmath>
 #include <concepts>
 #include <algorithm>
+#include <cstring>
 
 
 enum class FilterType { lowPass, highPass };
@@ -35,9 +37,11 @@ public:
     FloatType getNextSample(FloatType x) override;
     void clear();
     void setCutoff(FloatType cutoffFreq);
+    void setCutoff(const OnePoleTable<FloatType>& table, FloatType position);
     void setSampleRate(FloatType sampleRate);
     void useApproxCutoff(bool useApprox);
     void setFilterType(FilterType filterType);
+    bool hasSameStateAs(const OnePole& other) const;
 
 private:
     FloatType m_b0;
@@ -50,6 +54,7 @@ private:
     bool m_useApprox;
     FilterType m_filterType;
     void setCoefs();
+    void setFeedforwardCoefs();
 };
 
 
@@ -129,6 +134,21 @@ void OnePole<FloatType>::setCutoff(FloatType cutoffFreq)
 }
 
 
+template<std::floating_point FloatType>
+void OnePole<FloatType>::setCutoff(const OnePoleTable<FloatType>& table, 
+                                    FloatType position)
+{
+    // Set the cutoff from a position (0 to 1) in the table's cutoff range. 
+    // The feedback coefficient is exact to within the table's interpolation, 
+    // at the cost of a lookup rather than std::exp. The table must be built 
+    // for this filter's sample rate, and setSampleRate() goes back to the 
+    // last cutoff set in Hz.
+    m_a1 = table.getFeedback(position);
+
+    setFeedforwardCoefs();
+}
+
+
 template<std::floating_point FloatType>
 void OnePole<FloatType>::setSampleRate(FloatType sampleRate)
 {
@@ -163,6 +183,13 @@ void OnePole<FloatType>::setCoefs()
         m_a1 = -std::exp(-omega / m_sampleRate);
     }
 
+    setFeedforwardCoefs();
+}
+
+
+template<std::floating_point FloatType>
+void OnePole<FloatType>::setFeedforwardCoefs()
+{
     // Set feedforward coefficients (b0 and b1) depending on the filter type.
     if (m_filterType == FilterType::lowPass)
     {
@@ -189,8 +216,19 @@ template<std::floating_point FloatType>
 void OnePole<FloatType>::setFilterType(FilterType filterType)
 {
     m_filterType = filterType;
-    setCoefs();
+    setFeedforwardCoefs();
     clear();
 }
 
+
+template<std::floating_point FloatType>
+bool OnePole<FloatType>::hasSameStateAs(const OnePole& other) const
+{
+    // Bitwise, so that +0 and -0 count as different (they can give 
+    // different outputs)
+    return std::memcmp(&m_x1, &other.m_x1, sizeof(FloatType)) == 0
+        && std::memcmp(&m_y1, &other.m_y1, sizeof(FloatType)) == 0;
+}
+
+
 #endif // ONE_POLE_H
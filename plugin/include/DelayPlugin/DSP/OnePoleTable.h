@@ -0,0 +1,172 @@
+///
+///     @file OnePoleTable.h
+///     @brief Interpolated lookup of exact one-pole coefficients.
+///     @date October 18, 2026
+///
+///     OnePole works its feedback coefficient out from the cutoff either
+///     exactly,
+///
+///         a1 = -exp(-2 pi fc / fs)
+///
+///     which costs an exp per update, or with the first-order Taylor
+///     approximation a1 = 2 pi fc / fs - 1, which is cheap but far off at
+///     high cutoffs (it reaches 0, no filtering at all, at fs / 2 pi).
+///
+///     This table holds the exact a1 for one sample rate at evenly spaced
+///     positions of a skewed cutoff range, the way a JUCE
+///     NormalisableRange with setSkewForCentre() maps 0..1 to Hz:
+///
+///         fc = maxCutoff * position^(1 / skew)
+///
+///     so a parameter's normalised value looks its coefficient up directly,
+///     with no pow() to get back to Hz, and the points are dense where the
+///     parameter is. In between, a1 is linearly interpolated. Only a1 is
+///     held: OnePole derives b0 and b1 from it, which keeps the low-pass
+///     gain at DC (and the high-pass gain at Nyquist) exactly 1.
+///
+///     build() never allocates, but works out every point, so call it from
+///     prepareToPlay(). Lookups are for the audio thread.
+///
+
+#ifndef ONE_POLE_TABLE_H
+#define ONE_POLE_TABLE_H
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <concepts>
+#include <stdexcept>
+
+
+/**
+ * @class OnePoleTable
+ *
+ * @brief Exact one-pole feedback coefficients over a skewed cutoff range,
+ *        for one sample rate.
+ */
+template<std::floating_point FloatType>
+class OnePoleTable
+{
+public:
+    // Segments between table points. At 512 the interpolated a1 is within
+    // about 1e-5 of the exact value over the loop filter's range.
+    static constexpr int NUM_SEGMENTS = 512;
+
+    OnePoleTable();
+    void build(FloatType sampleRate, FloatType maxCutoff, FloatType centreCutoff);
+    bool isBuilt() const;
+    FloatType getFeedback(FloatType position) const;
+    FloatType getCutoff(FloatType position) const;
+
+private:
+    std::array<FloatType, NUM_SEGMENTS + 1> m_a1;
+    FloatType m_sampleRate;
+    FloatType m_maxCutoff;
+    FloatType m_skew;
+};
+
+
+/**
+ * Construct an empty table. build() must be called before lookups.
+ */
+template<std::floating_point FloatType>
+OnePoleTable<FloatType>::OnePoleTable() : m_a1{}, m_sampleRate{},
+    m_maxCutoff{}, m_skew{}
+{
+}
+
+
+/**
+ * Fill the table for a sample rate and cutoff range. The range starts at
+ * 0 Hz; like OnePole::setCutoff(), cutoffs are kept between 1 Hz and the
+ * Nyquist frequency.
+ *
+ * @param sampleRate    The sample rate the coefficients are for.
+ *
+ * @param maxCutoff     The cutoff at position 1, in Hz.
+ *
+ * @param centreCutoff  The cutoff at position 0.5, in Hz. Requires a value
+ *                      between 0 and maxCutoff.
+ */
+template<std::floating_point FloatType>
+void OnePoleTable<FloatType>::build(FloatType sampleRate, FloatType maxCutoff,
+                                    FloatType centreCutoff)
+{
+    if (sampleRate <= FloatType(0))
+        throw std::invalid_argument("sampleRate must be greater than 0");
+
+    if (centreCutoff <= FloatType(0) || centreCutoff >= maxCutoff)
+        throw std::invalid_argument("centreCutoff must be between 0 and maxCutoff");
+
+    m_sampleRate = sampleRate;
+    m_maxCutoff = maxCutoff;
+
+    // As NormalisableRange::setSkewForCentre() works it out
+    m_skew = static_cast<FloatType>(std::log(0.5)
+                    / std::log(static_cast<double>(centreCutoff / maxCutoff)));
+
+    const double TWO_PI = 6.283185307179586;
+
+    for (int i = 0; i <= NUM_SEGMENTS; i++)
+    {
+        FloatType position = static_cast<FloatType>(i) / NUM_SEGMENTS;
+        double omega = TWO_PI * static_cast<double>(getCutoff(position));
+        m_a1[static_cast<size_t>(i)] = static_cast<FloatType>(
+                                    -std::exp(-omega / static_cast<double>(sampleRate)));
+    }
+}
+
+
+/**
+ * Check whether build() has been called.
+ */
+template<std::floating_point FloatType>
+bool OnePoleTable<FloatType>::isBuilt() const
+{
+    return m_sampleRate > FloatType(0);
+}
+
+
+/**
+ * Look up the feedback coefficient (a1) for a position in the cutoff range.
+ *
+ * @param position  Normalised cutoff, 0 to 1 (clamped).
+ *
+ * @return          a1, interpolated between the nearest two table points.
+ */
+template<std::floating_point FloatType>
+FloatType OnePoleTable<FloatType>::getFeedback(FloatType position) const
+{
+    assert(isBuilt());
+
+    FloatType x = std::clamp(position, FloatType(0), FloatType(1))
+                    * FloatType(NUM_SEGMENTS);
+
+    // The last point is only ever reached with frac == 0
+    int index = std::min(static_cast<int>(x), NUM_SEGMENTS - 1);
+    FloatType frac = x - static_cast<FloatType>(index);
+    FloatType lower = m_a1[static_cast<size_t>(index)];
+    FloatType upper = m_a1[static_cast<size_t>(index) + 1];
+
+    return lower + frac * (upper - lower);
+}
+
+
+/**
+ * Get the cutoff in Hz for a position in the range, kept between 1 Hz and
+ * the Nyquist frequency. Uses pow(), so it is not meant for every update.
+ *
+ * @param position  Normalised cutoff, 0 to 1 (clamped).
+ */
+template<std::floating_point FloatType>
+FloatType OnePoleTable<FloatType>::getCutoff(FloatType position) const
+{
+    FloatType x = std::clamp(position, FloatType(0), FloatType(1));
+    FloatType cutoff = m_maxCutoff * std::pow(x, FloatType(1) / m_skew);
+
+    return std::clamp(cutoff, FloatType(1), m_sampleRate / FloatType(2));
+}
+
+
+#endif // ONE_POLE_TABLE_H
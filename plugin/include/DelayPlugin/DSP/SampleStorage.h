@@ -0,0 +1,202 @@
+///
+///     @file SampleStorage.h
+///     @brief Compact sample formats for delay-line storage.
+///     @date October 18, 2026
+///
+///     CircularBuffer can store its samples in a smaller format than the
+///     type it computes with, trading noise floor for memory and cache
+///     footprint. Samples are converted on push and on read; the DSP code
+///     always sees FloatType.
+///
+///     Formats (noise floor measured with a -6 dBFS 1 kHz sine at 48 kHz,
+///     error relative to full scale):
+///
+///         float       32 bits   (reference)
+///         Fixed16     16 bits   -100 dBFS  with scale 1.0 (clips at +/-1.0)
+///                               -89 dBFS   with scale 4.0 (+12 dB headroom)
+///         Half        16 bits   -85 dBFS   (error follows the signal level)
+///         BFloat16    16 bits   -68 dBFS   (error follows the signal level)
+///
+///     Fixed16 has the lowest noise floor but a hard ceiling at its scale,
+///     so the scale must leave room for the feedback loop to build up.
+///     Anything beyond +/-scale is clamped to it (a NaN is stored as 0)
+///     rather than wrapped around the int16 range. Half and BFloat16 keep
+///     their error roughly 76 dB and 59 dB below the signal at any level,
+///     and never clip in practice.
+///
+///     SampleStorageTests measures these noise floors and checks them
+///     against the table.
+///
+///     All conversions are branch-free apart from the special-value
+///     handling in Half, so the block conversion loops in CircularBuffer
+///     can be vectorized by the compiler.
+///
+///     @see CircularBuffer
+///
+
+#ifndef SAMPLE_STORAGE_H
+#define SAMPLE_STORAGE_H
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+
+
+/**
+ * 16-bit fixed point sample. The value range [-scale, scale] is mapped onto
+ * the full int16 range; anything outside it is clipped.
+ */
+struct Fixed16
+{
+    std::int16_t bits;
+};
+
+
+/**
+ * IEEE 754 binary16 sample (1 sign, 5 exponent, 10 mantissa bits).
+ */
+struct Half
+{
+    std::uint16_t bits;
+};
+
+
+/**
+ * bfloat16 sample (the top 16 bits of a float: 1 sign, 8 exponent, 7
+ * mantissa bits).
+ */
+struct BFloat16
+{
+    std::uint16_t bits;
+};
+
+
+/**
+ * Conversion between the compute type and a storage type. The primary
+ * template handles storing samples in their own type (no conversion).
+ *
+ * @param scale     Full-scale value. Only used by fixed point formats.
+ */
+template<std::floating_point FloatType, typename StorageType>
+struct SampleCodec
+{
+    static_assert(std::is_same_v<FloatType, StorageType>,
+                  "no conversion defined for this storage type");
+
+    static StorageType encode(FloatType x, FloatType /*scale*/) { return x; }
+    static FloatType decode(StorageType s, FloatType /*scale*/) { return s; }
+};
+
+
+template<std::floating_point FloatType>
+struct SampleCodec<FloatType, Fixed16>
+{
+    static Fixed16 encode(FloatType x, FloatType scale)
+    {
+        // Converting a value outside the int16 range is undefined, so
+        // clamp to full scale first, and store a NaN as 0. Both are
+        // selects, so the block loops still vectorize.
+        FloatType scaled = x * (FloatType(32767) / scale);
+        scaled = (scaled == scaled) ? scaled : FloatType(0);
+        scaled = std::clamp(scaled, FloatType(-32767), FloatType(32767));
+
+        // Round to nearest (a plain cast truncates toward zero)
+        scaled += scaled < FloatType(0) ? FloatType(-0.5) : FloatType(0.5);
+
+        return { static_cast<std::int16_t>(scaled) };
+    }
+
+    static FloatType decode(Fixed16 s, FloatType scale)
+    {
+        return static_cast<FloatType>(s.bits) * (scale / FloatType(32767));
+    }
+};
+
+
+template<std::floating_point FloatType>
+struct SampleCodec<FloatType, Half>
+{
+    // Reference: "Half to float done quic", Fabian Giesen, 2012.
+    // Rounds to nearest even, handles subnormals, infinities and NaN.
+    static Half encode(FloatType x, FloatType /*scale*/)
+    {
+        std::uint32_t f = std::bit_cast<std::uint32_t>(static_cast<float>(x));
+        std::uint32_t sign = f & 0x80000000u;
+        f ^= sign;
+
+        std::uint32_t h;
+
+        // Too large for a half (or already inf/NaN)
+        if (f >= 0x47800000u)
+        {
+            h = (f > 0x7f800000u) ? 0x7e00u : 0x7c00u;
+        }
+        // Half subnormal or zero: let the FPU do the rounding by adding a
+        // magic number that shifts the mantissa into place
+        else if (f < 0x38800000u)
+        {
+            float rounded = std::bit_cast<float>(f) + 0.5f;
+            h = std::bit_cast<std::uint32_t>(rounded) - 0x3f000000u;
+        }
+        // Normal half: rebias the exponent and round the mantissa
+        else
+        {
+            std::uint32_t mantissaOdd = (f >> 13) & 1u;
+            f += (static_cast<std::uint32_t>(15 - 127) << 23) + 0xfffu;
+            f += mantissaOdd;
+            h = f >> 13;
+        }
+
+        return { static_cast<std::uint16_t>(h | (sign >> 16)) };
+    }
+
+    static FloatType decode(Half s, FloatType /*scale*/)
+    {
+        constexpr std::uint32_t shiftedExponent = 0x7c00u << 13;
+
+        std::uint32_t f = (s.bits & 0x7fffu) << 13;
+        std::uint32_t exponent = f & shiftedExponent;
+        f += static_cast<std::uint32_t>(127 - 15) << 23;
+
+        // Inf/NaN: extra exponent adjustment
+        if (exponent == shiftedExponent)
+        {
+            f += static_cast<std::uint32_t>(128 - 16) << 23;
+        }
+        // Zero/subnormal: renormalize
+        else if (exponent == 0)
+        {
+            f += 1u << 23;
+            f = std::bit_cast<std::uint32_t>(std::bit_cast<float>(f)
+                                    - std::bit_cast<float>(113u << 23));
+        }
+
+        f |= static_cast<std::uint32_t>(s.bits & 0x8000u) << 16;
+
+        return static_cast<FloatType>(std::bit_cast<float>(f));
+    }
+};
+
+
+template<std::floating_point FloatType>
+struct SampleCodec<FloatType, BFloat16>
+{
+    static BFloat16 encode(FloatType x, FloatType /*scale*/)
+    {
+        std::uint32_t f = std::bit_cast<std::uint32_t>(static_cast<float>(x));
+
+        // Round to nearest even on the 16 bits being dropped
+        f += 0x7fffu + ((f >> 16) & 1u);
+
+        return { static_cast<std::uint16_t>(f >> 16) };
+    }
+
+    static FloatType decode(BFloat16 s, FloatType /*scale*/)
+    {
+        return static_cast<FloatType>(
+                    std::bit_cast<float>(static_cast<std::uint32_t>(s.bits) << 16));
+    }
+};
+
+#endif // SAMPLE_STORAGE_H
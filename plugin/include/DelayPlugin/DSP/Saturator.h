@@ -0,0 +1,320 @@
+///
+///     @file Saturator.h
+///     @brief Anti-aliased waveshaper for the delay feedback loop.
+///     @date October 18, 2026
+///
+///     Soft saturation with three curves:
+///
+///         softClip    cubic, x - 4x^3/27, flat from |x| = 1.5
+///         tape        quintic smoothstep-style tanh stand-in, flat from
+///                     |x| = 1.875. Its first two derivatives are continuous
+///                     at the knee, so it bends in more gently.
+///         tube        the tape curve with a bias, so positive peaks clip
+///                     sooner than negative ones (even harmonics). A DC
+///                     blocker removes the offset the asymmetry makes.
+///
+///     Every curve has unity slope at 0 and saturates at +-1. The input is
+///     multiplied by the drive and the output divided by it, so small
+///     signals pass at unity gain and the drive sets the level (1 / drive)
+///     the output saturates at.
+///
+///     Aliasing is reduced with first-order antiderivative anti-aliasing
+///     (ADAA): a curve r is replaced by its average over the segment
+///     between consecutive inputs, (R(x[n]) - R(x[n-1])) / (x[n] - x[n-1]),
+///     with R its antiderivative. Plain ADAA of the whole curve would also
+///     average the straight-line part of it, which is a two-tap low-pass
+///     (silent at Nyquist) that every repeat in the feedback loop would go
+///     through again. So only the residual r(x) = curve(x) - x is
+///     anti-aliased and x is passed through as is. The residual is where
+///     all the harmonics (and so all the aliasing) come from. The price is
+///     that a signal jumping between samples can overshoot the saturation
+///     level by up to half the jump, so dense high-frequency content is
+///     limited less firmly than low-frequency content.
+///
+///     The curves are piecewise polynomials, so their antiderivatives are
+///     too: no std::tanh, and no log(cosh()) as ADAA of tanh would need.
+///     The ADAA quotient is a difference of two large, close values, so it
+///     is worked out in double whatever FloatType is.
+///
+///     References:
+///
+///         J. Parker et al., "Reducing the Aliasing of Nonlinear Waveshaping
+///         Using Continuous-Time Convolution", DAFx-16
+///         S. Bilbao et al., "Antiderivative Antialiasing for Memoryless
+///         Nonlinearities", IEEE SPL, 2017
+///
+
+#ifndef SATURATOR_H
+#define SATURATOR_H
+
+#include "IAudioFilter.h"
+#include "OnePole.h"
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstring>
+
+
+enum class SaturationCurve { softClip, tape, tube };
+
+
+/* Anti-aliased soft saturation */
+template<std::floating_point FloatType>
+class Saturator : public IAudioFilter<FloatType>
+{
+public:
+    Saturator(SaturationCurve curve = SaturationCurve::softClip,
+                FloatType drive = FloatType(1),
+                    FloatType sampleRate = FloatType(44100));
+    ~Saturator();
+    FloatType getNextSample(FloatType x) override;
+    void clear();
+    void setCurve(SaturationCurve curve);
+    void setDrive(FloatType drive);
+    void setSampleRate(FloatType sampleRate);
+    bool hasSameStateAs(const Saturator& other) const;
+
+    static double shape(SaturationCurve curve, double x);
+    static double antiderivative(SaturationCurve curve, double x);
+
+private:
+    // Below this input step the ADAA quotient is mostly rounding error, so
+    // the residual is evaluated at the midpoint instead
+    static constexpr double ADAA_TOLERANCE = 1e-6;
+
+    // Where the soft clip and tape curves go flat
+    static constexpr double SOFT_CLIP_KNEE = 1.5;
+    static constexpr double TAPE_KNEE = 1.875;
+
+    // Input offset of the tube curve
+    static constexpr double TUBE_BIAS = 0.25;
+
+    // DC blocker cutoff for the tube curve, in Hz
+    static constexpr FloatType DC_BLOCKER_CUTOFF = FloatType(10);
+
+    SaturationCurve m_curve;
+    FloatType m_drive;
+    FloatType m_inverseDrive;
+
+    // Previous (driven) input and the residual's antiderivative there
+    double m_x1;
+    double m_residualIntegral1;
+
+    OnePole<FloatType> m_dcBlocker;
+
+    static double residualAntiderivative(SaturationCurve curve, double x);
+    static double softClip(double x);
+    static double softClipAntiderivative(double x);
+    static double tape(double x);
+    static double tapeAntiderivative(double x);
+};
+
+
+template<std::floating_point FloatType>
+Saturator<FloatType>::Saturator(SaturationCurve curve, FloatType drive,
+                                    FloatType sampleRate)
+    : m_curve{curve}, m_drive{1}, m_inverseDrive{1}, m_x1{},
+        m_residualIntegral1{residualAntiderivative(curve, 0.0)},
+            m_dcBlocker(FilterType::highPass, sampleRate, DC_BLOCKER_CUTOFF)
+{
+    // The approximate one-pole coefficients are fine at 10 Hz, but use the
+    // exact ones so the DC blocker's corner doesn't move with sample rate
+    m_dcBlocker.useApproxCutoff(false);
+    setDrive(drive);
+}
+
+
+template<std::floating_point FloatType>
+Saturator<FloatType>::~Saturator()
+{
+}
+
+
+template<std::floating_point FloatType>
+FloatType Saturator<FloatType>::getNextSample(FloatType x)
+{
+    double driven = static_cast<double>(m_drive * x);
+    double integral = residualAntiderivative(m_curve, driven);
+    double step = driven - m_x1;
+
+    double residual;
+
+    if (std::abs(step) > ADAA_TOLERANCE)
+    {
+        residual = (integral - m_residualIntegral1) / step;
+    }
+    else
+    {
+        double midpoint = 0.5 * (driven + m_x1);
+        residual = shape(m_curve, midpoint) - midpoint;
+    }
+
+    m_x1 = driven;
+    m_residualIntegral1 = integral;
+
+    FloatType y = (m_drive * x + static_cast<FloatType>(residual)) 
+                    * m_inverseDrive;
+
+    if (m_curve == SaturationCurve::tube)
+        y = m_dcBlocker.getNextSample(y);
+
+    return y;
+}
+
+
+template<std::floating_point FloatType>
+void Saturator<FloatType>::clear()
+{
+    // Reset state
+    m_x1 = 0.0;
+    m_residualIntegral1 = residualAntiderivative(m_curve, 0.0);
+    m_dcBlocker.clear();
+}
+
+
+template<std::floating_point FloatType>
+void Saturator<FloatType>::setCurve(SaturationCurve curve)
+{
+    m_curve = curve;
+    clear();
+}
+
+
+template<std::floating_point FloatType>
+void Saturator<FloatType>::setDrive(FloatType drive)
+{
+    // Input gain, at least 1. The output is scaled back down by the same
+    // amount.
+    drive = std::max(drive, FloatType(1));
+
+    if (drive == m_drive)
+        return;
+
+    // Keep the previous input where it was before the drive was applied,
+    // so a drive change doesn't look like a jump in the signal
+    m_x1 *= static_cast<double>(drive / m_drive);
+    m_residualIntegral1 = residualAntiderivative(m_curve, m_x1);
+
+    m_drive = drive;
+    m_inverseDrive = FloatType(1) / drive;
+}
+
+
+template<std::floating_point FloatType>
+void Saturator<FloatType>::setSampleRate(FloatType sampleRate)
+{
+    m_dcBlocker.setSampleRate(sampleRate);
+}
+
+
+// Check whether the other saturator's state is bit-identical to this one's
+template<std::floating_point FloatType>
+bool Saturator<FloatType>::hasSameStateAs(const Saturator& other) const
+{
+    return std::memcmp(&m_x1, &other.m_x1, sizeof(double)) == 0
+            && std::memcmp(&m_residualIntegral1, &other.m_residualIntegral1,
+                            sizeof(double)) == 0
+            && m_dcBlocker.hasSameStateAs(other.m_dcBlocker);
+}
+
+
+// The saturation curve itself (no anti-aliasing, no drive)
+template<std::floating_point FloatType>
+double Saturator<FloatType>::shape(SaturationCurve curve, double x)
+{
+    switch (curve)
+    {
+        case SaturationCurve::softClip:
+            return softClip(x);
+        case SaturationCurve::tape:
+            return tape(x);
+        case SaturationCurve::tube:
+        default:
+            return tape(x + TUBE_BIAS) - tape(TUBE_BIAS);
+    }
+}
+
+
+// An antiderivative of shape(). Only differences of it are used, so the
+// constant doesn't matter.
+template<std::floating_point FloatType>
+double Saturator<FloatType>::antiderivative(SaturationCurve curve, double x)
+{
+    switch (curve)
+    {
+        case SaturationCurve::softClip:
+            return softClipAntiderivative(x);
+        case SaturationCurve::tape:
+            return tapeAntiderivative(x);
+        case SaturationCurve::tube:
+        default:
+            return tapeAntiderivative(x + TUBE_BIAS) - tape(TUBE_BIAS) * x;
+    }
+}
+
+
+// Antiderivative of shape(x) - x, the part of the curve that is 
+// anti-aliased
+template<std::floating_point FloatType>
+double Saturator<FloatType>::residualAntiderivative(SaturationCurve curve,
+                                                        double x)
+{
+    return antiderivative(curve, x) - 0.5 * x * x;
+}
+
+
+template<std::floating_point FloatType>
+double Saturator<FloatType>::softClip(double x)
+{
+    if (std::abs(x) >= SOFT_CLIP_KNEE)
+        return std::copysign(1.0, x);
+
+    return x - 4.0 / 27.0 * x * x * x;
+}
+
+
+template<std::floating_point FloatType>
+double Saturator<FloatType>::softClipAntiderivative(double x)
+{
+    // x^2/2 - x^4/27, then a straight line of slope 1 past the knee
+    double absX = std::abs(x);
+
+    if (absX >= SOFT_CLIP_KNEE)
+        return absX - 0.5625;
+
+    double x2 = x * x;
+    return 0.5 * x2 - x2 * x2 / 27.0;
+}
+
+
+template<std::floating_point FloatType>
+double Saturator<FloatType>::tape(double x)
+{
+    // (15v - 10v^3 + 3v^5) / 8 with v = x / knee, the odd polynomial that
+    // reaches 1 at v = 1 with zero first and second derivatives
+    if (std::abs(x) >= TAPE_KNEE)
+        return std::copysign(1.0, x);
+
+    double v = x / TAPE_KNEE;
+    double v2 = v * v;
+
+    return v * (15.0 + v2 * (-10.0 + 3.0 * v2)) / 8.0;
+}
+
+
+template<std::floating_point FloatType>
+double Saturator<FloatType>::tapeAntiderivative(double x)
+{
+    // knee * (7.5v^2 - 2.5v^4 + 0.5v^6) / 8, then slope 1 past the knee
+    double absX = std::abs(x);
+
+    if (absX >= TAPE_KNEE)
+        return absX - TAPE_KNEE * 2.5 / 8.0;
+
+    double v = x / TAPE_KNEE;
+    double v2 = v * v;
+
+    return TAPE_KNEE * v2 * (7.5 + v2 * (-2.5 + 0.5 * v2)) / 8.0;
+}
+
+#endif // SATURATOR_H
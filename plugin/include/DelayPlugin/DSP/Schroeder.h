@@ -13,6 +13,12 @@
 ///
 ///     @see Diffuser
 ///
+///     The delay buffer is sized at run time by default. Stages whose 
+///     length is known at compile time can give a Capacity (a power of 2 
+///     greater than the delay) instead, which holds the buffer inline with 
+///     a constant wrap mask - e.g. Schroeder<float, 256> for the 225-sample 
+///     Freeverb stage. Those can't grow past Capacity.
+///
 ///     Reference: ccrma.stanford.edu/~jos/pasp/Allpass_Two_Combs.html
 ///
 
@@ -25,6 +31,7 @@
 #include <juce_core/juce_core.h>
 #include <stdexcept>
 #include <memory>
+#include <type_traits>
 
 
 /**
@@ -34,13 +41,20 @@
  *
  * @implements IAudioFilter
  */
-template<std::floating_point FloatType>
+template<std::floating_point FloatType, std::size_t Capacity = 0>
 class Schroeder : public IAudioFilter<FloatType>
 {
 private:
+    // Sized at run time (Capacity 0), or fixed and held inline
+    using DelayBuffer = std::conditional_t<Capacity == 0, 
+                            CircularBuffer<FloatType>,
+                            CircularBuffer<FloatType, FixedCapacity<Capacity>>>;
+
     FloatType m_gain;
     unsigned int m_delayInSamples;
-    CircularBuffer<FloatType> m_delayBuffer;
+    DelayBuffer m_delayBuffer;
+
+    static DelayBuffer makeDelayBuffer(unsigned int delayInSamples);
 
 public:
     Schroeder(unsigned int delayInSamples, FloatType gain);
@@ -49,6 +63,7 @@ public:
     void setGain(FloatType gain);     
     void setDelaySamples(unsigned int delayInSamples);
     void clear();
+    size_t getMemoryBytes() const;
 };
 
 
@@ -62,24 +77,39 @@ public:
  * @param gain              The feedback/feedforward gain. Requires a value 
  *                          between 0 and 1. 
  */
-template<std::floating_point FloatType>
-Schroeder<FloatType>::Schroeder(unsigned int delayInSamples, FloatType gain) 
+template<std::floating_point FloatType, std::size_t Capacity>
+Schroeder<FloatType, Capacity>::Schroeder(unsigned int delayInSamples, FloatType gain) 
     : m_gain{gain}, m_delayInSamples{delayInSamples}, 
-      m_delayBuffer(juce::nextPowerOfTwo(delayInSamples), FloatType(0))
+      m_delayBuffer(makeDelayBuffer(delayInSamples))
 {
     if ( (gain < FloatType(0)) || (gain > FloatType(1)) )
         throw std::invalid_argument("gain must be between 0 and 1");
 
     if (delayInSamples < 1)
         throw std::invalid_argument("delayInSamples must be at least 1");
+
+    if (Capacity != 0 && delayInSamples >= Capacity)
+        throw std::invalid_argument("delayInSamples must be less than Capacity");
+}
+
+
+// Create a cleared delay buffer with room for a delay
+template<std::floating_point FloatType, std::size_t Capacity>
+typename Schroeder<FloatType, Capacity>::DelayBuffer 
+Schroeder<FloatType, Capacity>::makeDelayBuffer(unsigned int delayInSamples)
+{
+    if constexpr (Capacity == 0)
+        return DelayBuffer(juce::nextPowerOfTwo(delayInSamples + 1), FloatType(0));
+    else
+        return DelayBuffer(FloatType(0));
 }
 
 
 /**
  * Destructor
  */
-template<std::floating_point FloatType>
-Schroeder<FloatType>::~Schroeder()
+template<std::floating_point FloatType, std::size_t Capacity>
+Schroeder<FloatType, Capacity>::~Schroeder()
 {
 }
 
@@ -91,8 +121,8 @@ Schroeder<FloatType>::~Schroeder()
  *
  * @return     Returns the processed output sample.
  */
-template<std::floating_point FloatType>
-FloatType Schroeder<FloatType>::getNextSample(FloatType x)
+template<std::floating_point FloatType, std::size_t Capacity>
+FloatType Schroeder<FloatType, Capacity>::getNextSample(FloatType x)
 {
     FloatType delayed = m_delayBuffer[m_delayInSamples];
     FloatType mixed = x + m_gain * delayed;
@@ -109,8 +139,8 @@ FloatType Schroeder<FloatType>::getNextSample(FloatType x)
  *
  * @param gain    The gain coefficient.
  */
-template <std::floating_point FloatType>
-void Schroeder<FloatType>::setGain(FloatType gain)     
+template <std::floating_point FloatType, std::size_t Capacity>
+void Schroeder<FloatType, Capacity>::setGain(FloatType gain)     
 {
     if ( (gain < FloatType(0)) || (gain > FloatType(1)) )
         throw std::invalid_argument("gain must be between 0 and 1");
@@ -122,14 +152,24 @@ void Schroeder<FloatType>::setGain(FloatType gain)
 /**
  * Set the delay length in samples.
  *
- * @param delayInSamples    The all-pass delay length in samples.
+ * @param delayInSamples    The all-pass delay length in samples. With a 
+ *                          fixed Capacity, requires a value less than it.
  */
-template <std::floating_point FloatType>
-void Schroeder<FloatType>::setDelaySamples(unsigned int delayInSamples)
+template <std::floating_point FloatType, std::size_t Capacity>
+void Schroeder<FloatType, Capacity>::setDelaySamples(unsigned int delayInSamples)
 {
-    // Resize the circular buffer if necessary
-    if (delayInSamples >= m_delayBuffer.getSize())
-        m_delayBuffer.resize(juce::nextPowerOfTwo(delayInSamples));
+    // Resize the circular buffer if necessary (a fixed one can't grow).
+    // Reading delayInSamples back needs delayInSamples + 1 slots, as in the
+    // constructor.
+    if constexpr (Capacity == 0)
+    {
+        if (delayInSamples + 1 > m_delayBuffer.getSize())
+            m_delayBuffer.resize(juce::nextPowerOfTwo(delayInSamples + 1));
+    }
+    else if (delayInSamples >= Capacity)
+    {
+        throw std::invalid_argument("delayInSamples must be less than Capacity");
+    }
 
     m_delayInSamples = delayInSamples;
 }
@@ -138,10 +178,21 @@ void Schroeder<FloatType>::setDelaySamples(unsigned int delayInSamples)
 /**
  * Clear the delay buffer.
  */
-template <std::floating_point FloatType>
-void Schroeder<FloatType>::clear()
+template <std::floating_point FloatType, std::size_t Capacity>
+void Schroeder<FloatType, Capacity>::clear()
 {
     m_delayBuffer.clear();
 }
 
+
+/**
+ * Get the size of the delay buffer's sample memory in bytes.
+ */
+template <std::floating_point FloatType, std::size_t Capacity>
+size_t Schroeder<FloatType, Capacity>::getMemoryBytes() const
+{
+    return m_delayBuffer.getMemoryBytes();
+}
+
+
 #endif // SCHROEDER_H
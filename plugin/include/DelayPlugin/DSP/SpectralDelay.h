@@ -0,0 +1,129 @@
+///
+///     @file SpectralDelay.h
+///     @brief Per-bin delay and feedback on a short-time Fourier transform.
+///     @date October 18, 2026
+///
+///     Each channel is cut into overlapping frames (square-root Hann window,
+///     75% overlap), transformed, and every frequency bin gets its own
+///     feedback delay line:
+///
+///         wet[k]  = ring[k][frame - delayFrames[k]]
+///         ring[k][frame] = input[k] + feedback[k] * wet[k]
+///
+///     before the wet spectrum is transformed back and overlap-added. Delay
+///     times are whole hops. The rings of all bins are held frame-major in
+///     one contiguous block (one frame's bins next to each other), which
+///     the owner supplies with setRingMemory() - in DelayEffect it comes
+///     from the DelayBufferPool like the time-domain delay lines, and only
+///     while spectral mode is on.
+///
+///     Delay and feedback follow a tilt around 1 kHz. The delay tilt scales
+///     each bin's delay by 2^(tilt * octaves / 2), so at +1 a bin 4 octaves
+///     up echoes 4x later than 1 kHz and one 4 octaves down 4x sooner. The
+///     feedback tilt adds tilt * 3 dB per octave to the feedback gain,
+///     which is capped at MAX_FEEDBACK.
+///
+///     Latency is one frame (getLatencySamples()): the wet signal comes out
+///     of the overlap-add one FFT length late, and the dry signal is
+///     delayed to match so the host's delay compensation lines up both.
+///     processDry() keeps that delay without the rest, for a bypass that
+///     mustn't change the latency.
+///
+///     The FFT length grows with the sample rate (1024 up to 48 kHz), so
+///     the hop (a quarter of it, about 5.3 ms) and the latency (about
+///     21 ms) stay roughly the same in time. A shorter frame would lower
+///     the latency but cost more transforms per second and smear the low
+///     bins over fewer cycles; 1024 at 48 kHz keeps the engine well inside
+///     its budget of 5% of one core for stereo (see SpectralDelay.cpp).
+///
+///     prepare() allocates. Everything else, including setRingMemory(),
+///     is for the audio thread and never allocates.
+///
+
+#ifndef SPECTRAL_DELAY_H
+#define SPECTRAL_DELAY_H
+
+#include "Fft.h"
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @class SpectralDelay
+ *
+ * @brief Stereo STFT delay with a delay time and feedback per bin.
+ */
+class SpectralDelay
+{
+public:
+    static constexpr int NUM_CHANNELS = 2;
+    static constexpr float MAX_DELAY_SECONDS = 2.0f;
+    static constexpr float MAX_FEEDBACK = 0.99f;
+
+    SpectralDelay();
+    ~SpectralDelay();
+    SpectralDelay(const SpectralDelay&) = delete;
+    SpectralDelay& operator=(const SpectralDelay&) = delete;
+
+    void prepare(float sampleRate);
+    size_t getRingBytes() const;
+    void setRingMemory(std::byte* memory, size_t numBytes);
+    void setParameters(float delayTimeMs, float feedback, float delayTilt,
+                        float feedbackTilt);
+    void process(int channel, float* data, int numSamples, float mix);
+    void processDry(int channel, float* data, int numSamples);
+    void readDelayedInput(int channel, float* destination, int numSamples) const;
+    void setInputGain(float gain);
+    void clear();
+    void clearWet();
+    int getLatencySamples() const;
+    int getHopSize() const;
+    double getTailSeconds(float delayTimeMs, float feedback, float delayTilt,
+                          float feedbackTilt, double decayDb) const;
+
+private:
+    using Complex = std::complex<float>;
+
+    struct Channel
+    {
+        std::vector<float> inputFifo;      // last FFT length of input
+        std::vector<float> outputFifo;     // overlap-add accumulator
+        size_t position;                   // oldest sample in both fifos
+        int samplesUntilFrame;
+        size_t ringFrame;                  // next ring frame to write
+        size_t numLiveFrames;              // ring frames written since a
+                                           // clear (older ones read as 0)
+    };
+
+    float m_sampleRate;
+    size_t m_fftSize;
+    size_t m_numBins;
+    int m_hopSize;
+    size_t m_numRingFrames;
+
+    Fft<float> m_fft;
+    std::vector<float> m_window;
+    std::vector<Complex> m_frame;
+    Channel m_channels[NUM_CHANNELS];
+
+    // Ring memory for all channels (not owned), nullptr while there is none
+    Complex* m_ring;
+
+    // Scales the input going into the rings, but not the dry signal
+    float m_inputGain;
+
+    // Per-bin settings, and each bin's distance from 1 kHz in octaves
+    std::vector<int> m_binDelayFrames;
+    std::vector<float> m_binFeedback;
+    std::vector<float> m_binOctaves;
+
+    // Parameters the per-bin settings were last computed for
+    float m_delayTimeMs;
+    float m_feedback;
+    float m_delayTilt;
+    float m_feedbackTilt;
+
+    void processFrame(Channel& channel, Complex* ring);
+};
+
+#endif // SPECTRAL_DELAY_H
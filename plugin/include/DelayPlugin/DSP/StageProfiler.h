@@ -0,0 +1,250 @@
+///
+///     @file StageProfiler.h
+///     @brief Optional per-stage cycle counting for the DSP hot path.
+///     @date October 18, 2026
+///
+///     When DELAY_PLUGIN_PROFILING is 1 (CMake option
+///     DELAY_PLUGIN_ENABLE_PROFILING), DelayEffect reads the CPU cycle
+///     counter at every stage boundary of its processing, adds the elapsed
+///     cycles to that stage's total for the block, and at the end of the
+///     block records each total in a lock-free histogram. Any other thread
+///     can read min/mean/p99 cycles per block for each stage with
+///     getStatistics() while audio is running.
+///
+///     When DELAY_PLUGIN_PROFILING is 0 (the default), the DSP_PROFILE_*
+///     macros expand to nothing and DelayEffect holds no profiler, so the
+///     hot path is exactly the same as an uninstrumented build.
+///
+///     Overhead when enabled: the per-sample loop reads the counter 8 times
+///     per stereo sample (3 laps per channel, then the write and the mix).
+///     A counter read is ~20 cycles on bare-metal x86 and can be twice that
+///     under virtualization, which is large next to a ~50 ns sample. On an
+///     x86-64 VM (rdtsc ~21 ns), DelayEffect went from 50 ns to 238 ns per
+///     stereo sample. The totals include that overhead, so compare stages
+///     against each other rather than against an uninstrumented build.
+///
+///     The cycle counter is the TSC on x86, CNTVCT on ARM64 (which ticks at
+///     a fixed rate well below the CPU clock), and steady_clock nanoseconds
+///     elsewhere.
+///
+
+#ifndef STAGE_PROFILER_H
+#define STAGE_PROFILER_H
+
+#ifndef DELAY_PLUGIN_PROFILING
+    #define DELAY_PLUGIN_PROFILING 0
+#endif
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+#endif
+
+
+// The stages of DelayEffect's processing, in signal order
+enum class ProfileStage
+{
+    parameterFetch,
+    update,
+    delayRead,
+    loopFilter,
+    diffuser,
+    saturator,
+    bufferWrite,
+    mix,
+    numStages
+};
+
+
+/**
+ * @class StageProfiler
+ *
+ * @brief Per-block cycle totals per stage, with lock-free statistics.
+ *
+ * lap() and endBlock() are for the audio thread. getStatistics() and
+ * reset() can be called from any thread.
+ */
+class StageProfiler
+{
+public:
+    static constexpr int NUM_STAGES = static_cast<int>(ProfileStage::numStages);
+
+    struct Statistics
+    {
+        std::uint64_t numBlocks;
+        std::uint64_t minCycles;    // per block
+        double meanCycles;          // per block
+        std::uint64_t p99Cycles;    // per block, upper edge of the p99 bucket
+    };
+
+    StageProfiler()
+    {
+        reset();
+    }
+
+    // Read the cycle counter
+    static std::uint64_t now()
+    {
+    #if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        return __rdtsc();
+    #elif defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+    #elif defined(__aarch64__)
+        std::uint64_t ticks;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+        return ticks;
+    #else
+        return static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count());
+    #endif
+    }
+
+    /**
+     * Charge the time since start to a stage, and return the current time
+     * so the next stage can start from it.
+     */
+    std::uint64_t lap(ProfileStage stage, std::uint64_t start)
+    {
+        std::uint64_t end = now();
+        m_blockCycles[static_cast<int>(stage)] += end - start;
+        return end;
+    }
+
+    // Record this block's per-stage totals and start a new block
+    void endBlock()
+    {
+        for (int stage = 0; stage < NUM_STAGES; stage++)
+        {
+            std::uint64_t cycles = m_blockCycles[stage];
+            m_blockCycles[stage] = 0;
+
+            StageCounters& counters = m_counters[stage];
+            counters.numBlocks.fetch_add(1, std::memory_order_relaxed);
+            counters.totalCycles.fetch_add(cycles, std::memory_order_relaxed);
+            counters.histogram[getBucket(cycles)].fetch_add(
+                                                1, std::memory_order_relaxed);
+
+            // Only the audio thread writes the minimum, so no CAS loop
+            if (cycles < counters.minCycles.load(std::memory_order_relaxed))
+                counters.minCycles.store(cycles, std::memory_order_relaxed);
+        }
+    }
+
+    // Get the statistics for one stage
+    Statistics getStatistics(ProfileStage stage) const
+    {
+        const StageCounters& counters = m_counters[static_cast<int>(stage)];
+        Statistics stats{};
+
+        stats.numBlocks = counters.numBlocks.load(std::memory_order_relaxed);
+
+        if (stats.numBlocks == 0)
+            return stats;
+
+        stats.minCycles = counters.minCycles.load(std::memory_order_relaxed);
+        stats.meanCycles = static_cast<double>(
+                counters.totalCycles.load(std::memory_order_relaxed))
+                / static_cast<double>(stats.numBlocks);
+
+        // Walk the histogram up to the 99th percentile. Counts are read one
+        // at a time, so the result is approximate while audio is running.
+        std::uint64_t target = stats.numBlocks - stats.numBlocks / 100;
+        std::uint64_t seen = 0;
+
+        for (int bucket = 0; bucket < NUM_BUCKETS; bucket++)
+        {
+            seen += counters.histogram[bucket].load(std::memory_order_relaxed);
+
+            if (seen >= target)
+            {
+                stats.p99Cycles = getBucketUpperEdge(bucket);
+                break;
+            }
+        }
+
+        return stats;
+    }
+
+    // Clear all statistics. Blocks recorded while resetting may be lost.
+    void reset()
+    {
+        m_blockCycles.fill(0);
+
+        for (StageCounters& counters : m_counters)
+        {
+            counters.numBlocks.store(0, std::memory_order_relaxed);
+            counters.totalCycles.store(0, std::memory_order_relaxed);
+            counters.minCycles.store(UINT64_MAX, std::memory_order_relaxed);
+
+            for (auto& count : counters.histogram)
+                count.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    // Log-scale histogram with 4 buckets per octave (about 19% wide)
+    static constexpr int BUCKETS_PER_OCTAVE = 4;
+    static constexpr int NUM_BUCKETS = 64 * BUCKETS_PER_OCTAVE;
+
+    struct StageCounters
+    {
+        std::atomic<std::uint64_t> numBlocks;
+        std::atomic<std::uint64_t> totalCycles;
+        std::atomic<std::uint64_t> minCycles;
+        std::array<std::atomic<std::uint32_t>, NUM_BUCKETS> histogram;
+    };
+
+    // Audio thread only
+    std::array<std::uint64_t, NUM_STAGES> m_blockCycles;
+
+    std::array<StageCounters, NUM_STAGES> m_counters;
+
+    static int getBucket(std::uint64_t cycles)
+    {
+        if (cycles < 2)
+            return 0;
+
+        int octave = std::bit_width(cycles) - 1;
+
+        // The two bits below the leading one pick the bucket in the octave
+        int fraction = octave >= 2 ? static_cast<int>((cycles >> (octave - 2)) & 3)
+                                   : static_cast<int>((cycles << (2 - octave)) & 3);
+
+        return octave * BUCKETS_PER_OCTAVE + fraction;
+    }
+
+    static std::uint64_t getBucketUpperEdge(int bucket)
+    {
+        int octave = bucket / BUCKETS_PER_OCTAVE;
+        int fraction = bucket % BUCKETS_PER_OCTAVE;
+
+        if (octave < 2)
+            return std::uint64_t(1) << (octave + 1);
+
+        return ((std::uint64_t(4 + fraction + 1)) << (octave - 2)) - 1;
+    }
+};
+
+
+// Instrumentation macros. They compile to nothing unless profiling is on.
+#if DELAY_PLUGIN_PROFILING
+    #define DSP_PROFILE_START(profileTime) \
+        std::uint64_t profileTime = StageProfiler::now()
+    #define DSP_PROFILE_LAP(profiler, profileTime, stage) \
+        profileTime = (profiler).lap(ProfileStage::stage, profileTime)
+    #define DSP_PROFILE_END_BLOCK(profiler) (profiler).endBlock()
+#else
+    #define DSP_PROFILE_START(profileTime) ((void)0)
+    #define DSP_PROFILE_LAP(profiler, profileTime, stage) ((void)0)
+    #define DSP_PROFILE_END_BLOCK(profiler) ((void)0)
+#endif
+
+#endif // STAGE_PROFILER_H
@@ -0,0 +1,255 @@
+///
+///     @file StateVariableFilter.h
+///     @brief Resonant low-pass/high-pass/band-pass/notch state variable filter.
+///     @date October 18, 2026
+///
+///     Second order state variable filter in topology-preserving transform
+///     (TPT) form: two trapezoidal integrators in the analog SVF structure,
+///     with the zero-delay feedback loop solved directly. Each integrator's
+///     state is a physical quantity rather than a past output, so the cutoff
+///     and resonance can change every sample without the filter blowing up
+///     or clicking (unlike a direct form biquad, whose coefficients only
+///     make sense together with the state they were computed for).
+///
+///     The cutoff is prewarped with a rational approximation of tan()
+///     instead of std::tan, so setCutoff() is a handful of multiplies and
+///     one divide and can be called every sample.
+///
+///     The outputs are normalised so the gain never goes above 1 at any
+///     frequency: band-pass has unity gain at the cutoff, and low-pass and
+///     high-pass are scaled down by their resonant peak. In a feedback loop
+///     that keeps the loop gain at or below the feedback amount, whatever
+///     the resonance.
+///
+///     References:
+///
+///         V. Zavalishin, "The Art of VA Filter Design", ch. 4
+///         A. Simper, "Linear Trapezoidal Integrated SVF" (Cytomic, 2013)
+///
+
+#ifndef STATE_VARIABLE_FILTER_H
+#define STATE_VARIABLE_FILTER_H
+
+#include "IAudioFilter.h"
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstring>
+
+
+enum class SvfType { lowPass, highPass, bandPass, notch };
+
+
+/* Resonant state variable filter (TPT form) */
+template<std::floating_point FloatType>
+class StateVariableFilter : public IAudioFilter<FloatType>
+{
+public:
+    StateVariableFilter(SvfType filterType = SvfType::lowPass,
+                            FloatType sampleRate = FloatType(44100),
+                                FloatType cutoffFreq = FloatType(1000),
+                                    FloatType resonance = FloatType(0));
+    ~StateVariableFilter();
+    FloatType getNextSample(FloatType x) override;
+    void clear();
+    void setCutoff(FloatType cutoffFreq);
+    void setResonance(FloatType resonance);
+    void setSampleRate(FloatType sampleRate);
+    void setFilterType(SvfType filterType);
+    bool hasSameStateAs(const StateVariableFilter& other) const;
+
+    static FloatType fastTan(FloatType x);
+
+private:
+    // Damping (1/Q) at full resonance, i.e. Q = 10
+    static constexpr FloatType MIN_DAMPING = FloatType(0.1);
+
+    // Highest cutoff, as a fraction of the sample rate. tan() has a pole at
+    // half the sample rate.
+    static constexpr FloatType MAX_CUTOFF_RATIO = FloatType(0.49);
+
+    FloatType m_a1;
+    FloatType m_a2;
+    FloatType m_a3;
+    FloatType m_k;
+    FloatType m_outputGain;
+    FloatType m_ic1eq;
+    FloatType m_ic2eq;
+    FloatType m_sampleRate;
+    FloatType m_cutoffFreq;
+    FloatType m_piOverSampleRate;
+    SvfType m_filterType;
+    void setCoefs();
+    void setOutputGain();
+};
+
+
+template<std::floating_point FloatType>
+StateVariableFilter<FloatType>::StateVariableFilter(SvfType filterType,
+            FloatType sampleRate, FloatType cutoffFreq, FloatType resonance)
+    : m_a1{}, m_a2{}, m_a3{}, m_k{2}, m_outputGain{1}, m_ic1eq{}, m_ic2eq{},
+        m_sampleRate{sampleRate}, m_cutoffFreq{}, m_piOverSampleRate{},
+            m_filterType{filterType}
+{
+    setSampleRate(sampleRate);
+    setCutoff(cutoffFreq);
+    setResonance(resonance);
+}
+
+
+template<std::floating_point FloatType>
+StateVariableFilter<FloatType>::~StateVariableFilter()
+{
+}
+
+
+template<std::floating_point FloatType>
+FloatType StateVariableFilter<FloatType>::getNextSample(FloatType x)
+{
+/*
+ *  Solves one step of the analog SVF with trapezoidal integrators
+ *  (Simper's formulation). ic1eq and ic2eq are the integrator states:
+ *
+ *      v3 = x - ic2eq
+ *      v1 = a1 * ic1eq + a2 * v3       (band-pass)
+ *      v2 = ic2eq + a2 * ic1eq + a3 * v3   (low-pass)
+ *
+ *  with g = tan(pi * fc / fs), k = 1/Q and
+ *
+ *      a1 = 1 / (1 + g * (g + k)),  a2 = g * a1,  a3 = g * a2
+ *
+ *  High-pass is x - k * v1 - v2, and notch is x - k * v1.
+ */
+    FloatType v3 = x - m_ic2eq;
+    FloatType v1 = m_a1 * m_ic1eq + m_a2 * v3;
+    FloatType v2 = m_ic2eq + m_a2 * m_ic1eq + m_a3 * v3;
+
+    m_ic1eq = FloatType(2) * v1 - m_ic1eq;
+    m_ic2eq = FloatType(2) * v2 - m_ic2eq;
+
+    switch (m_filterType)
+    {
+        case SvfType::lowPass:
+            return m_outputGain * v2;
+        case SvfType::highPass:
+            return m_outputGain * (x - m_k * v1 - v2);
+        case SvfType::bandPass:
+            return m_k * v1;
+        case SvfType::notch:
+        default:
+            return x - m_k * v1;
+    }
+}
+
+
+template<std::floating_point FloatType>
+void StateVariableFilter<FloatType>::clear()
+{
+    // Reset filter state
+    m_ic1eq = FloatType(0);
+    m_ic2eq = FloatType(0);
+}
+
+
+template<std::floating_point FloatType>
+void StateVariableFilter<FloatType>::setCutoff(FloatType cutoffFreq)
+{
+    // Set the cutoff (or centre) frequency in Hz. Cheap enough to call
+    // every sample.
+    m_cutoffFreq = std::clamp(cutoffFreq, FloatType(1),
+                                MAX_CUTOFF_RATIO * m_sampleRate);
+
+    setCoefs();
+}
+
+
+template<std::floating_point FloatType>
+void StateVariableFilter<FloatType>::setResonance(FloatType resonance)
+{
+    // 0 is critically damped (Q = 0.5, no peak), 1 is Q = 10
+    resonance = std::clamp(resonance, FloatType(0), FloatType(1));
+    m_k = FloatType(2) - resonance * (FloatType(2) - MIN_DAMPING);
+
+    setOutputGain();
+    setCoefs();
+}
+
+
+template<std::floating_point FloatType>
+void StateVariableFilter<FloatType>::setSampleRate(FloatType sampleRate)
+{
+    const FloatType PI = FloatType(3.14159265358979);
+
+    m_sampleRate = sampleRate;
+    m_piOverSampleRate = PI / sampleRate;
+
+    setCutoff(m_cutoffFreq);
+}
+
+
+template<std::floating_point FloatType>
+void StateVariableFilter<FloatType>::setFilterType(SvfType filterType)
+{
+    m_filterType = filterType;
+    clear();
+}
+
+
+// Check whether the other filter's state is bit-identical to this one's
+template<std::floating_point FloatType>
+bool StateVariableFilter<FloatType>::hasSameStateAs(
+                                    const StateVariableFilter& other) const
+{
+    return std::memcmp(&m_ic1eq, &other.m_ic1eq, sizeof(FloatType)) == 0
+            && std::memcmp(&m_ic2eq, &other.m_ic2eq, sizeof(FloatType)) == 0;
+}
+
+
+/**
+ * Approximate tan(x) for 0 <= x < pi/2. This is the continued fraction
+ * for tan() cut off after seven terms, so it has a pole close to pi/2
+ * like tan() does. Relative error is below 1e-6 up to x = 0.49 * pi (the
+ * highest cutoff setCutoff() allows), which is below float precision.
+ */
+template<std::floating_point FloatType>
+FloatType StateVariableFilter<FloatType>::fastTan(FloatType x)
+{
+    FloatType x2 = x * x;
+
+    FloatType numerator = x * (FloatType(135135) + x2 * (FloatType(-17325)
+                            + x2 * (FloatType(378) - x2)));
+    FloatType denominator = FloatType(135135) + x2 * (FloatType(-62370)
+                            + x2 * (FloatType(3150) - FloatType(28) * x2));
+
+    return numerator / denominator;
+}
+
+
+template<std::floating_point FloatType>
+void StateVariableFilter<FloatType>::setCoefs()
+{
+    // Prewarp so the digital cutoff lands where the analog one would
+    FloatType g = fastTan(m_cutoffFreq * m_piOverSampleRate);
+
+    m_a1 = FloatType(1) / (FloatType(1) + g * (g + m_k));
+    m_a2 = g * m_a1;
+    m_a3 = g * m_a2;
+}
+
+
+template<std::floating_point FloatType>
+void StateVariableFilter<FloatType>::setOutputGain()
+{
+    // Low-pass and high-pass peak at Q / sqrt(1 - 1 / (4 Q^2)) once
+    // Q > 1/sqrt(2) (k < sqrt(2)), and have unity gain at most below that.
+    // Bilinear prewarping moves the peak's frequency but not its height.
+    if (m_k * m_k >= FloatType(2))
+    {
+        m_outputGain = FloatType(1);
+        return;
+    }
+
+    m_outputGain = m_k * std::sqrt(FloatType(1) - m_k * m_k / FloatType(4));
+}
+
+#endif // STATE_VARIABLE_FILTER_H
@@ -0,0 +1,97 @@
+///
+///     @file TelemetryFifo.h
+///     @brief Wait-free single-producer, single-consumer FIFO.
+///     @date October 18, 2026
+///
+///     Carries small fixed-size records (meter levels, scope points) from
+///     the audio thread to the editor. push() and pop() are each a couple of
+///     atomic loads and one store, never lock or allocate, and never wait
+///     for the other side. When the consumer falls behind (or no editor is
+///     draining) push() drops the new record rather than overwriting old
+///     ones, which keeps both sides simple and costs the UI nothing it
+///     would have shown anyway.
+///
+
+#ifndef TELEMETRY_FIFO_H
+#define TELEMETRY_FIFO_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+/**
+ * @class TelemetryFifo
+ *
+ * @brief Wait-free SPSC FIFO of trivially copyable records.
+ *
+ * push() is for the one producer thread, pop() and discardAll() for the one
+ * consumer thread.
+ */
+template<typename T, size_t Capacity>
+class TelemetryFifo
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2");
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+public:
+    TelemetryFifo() : m_writeIndex{0}, m_readIndex{0}, m_numDropped{0}
+    {
+    }
+
+    // Add a record. Returns false (and drops it) if the FIFO is full.
+    bool push(const T& item)
+    {
+        size_t write = m_writeIndex.load(std::memory_order_relaxed);
+        size_t read = m_readIndex.load(std::memory_order_acquire);
+
+        if (write - read == Capacity)
+        {
+            m_numDropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        m_items[write & (Capacity - 1)] = item;
+        m_writeIndex.store(write + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // Take the oldest record. Returns false if the FIFO is empty.
+    bool pop(T& item)
+    {
+        size_t read = m_readIndex.load(std::memory_order_relaxed);
+        size_t write = m_writeIndex.load(std::memory_order_acquire);
+
+        if (read == write)
+            return false;
+
+        item = m_items[read & (Capacity - 1)];
+        m_readIndex.store(read + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // Throw away everything currently in the FIFO
+    void discardAll()
+    {
+        m_readIndex.store(m_writeIndex.load(std::memory_order_acquire),
+                            std::memory_order_release);
+    }
+
+    // Number of records pushed while the FIFO was full
+    size_t getNumDropped() const
+    {
+        return m_numDropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    // Indices count up forever and are masked on use. Each side's index
+    // has its own cache line so the two threads don't contend.
+    alignas(64) std::atomic<size_t> m_writeIndex;
+    alignas(64) std::atomic<size_t> m_readIndex;
+    alignas(64) std::atomic<size_t> m_numDropped;
+    std::array<T, Capacity> m_items;
+};
+
+#endif // TELEMETRY_FIFO_H
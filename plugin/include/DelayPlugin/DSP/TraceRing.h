@@ -0,0 +1,149 @@
+///
+///     @file TraceRing.h
+///     @brief Wait-free ring of timestamped trace events.
+///     @date October 18, 2026
+///
+///     The audio thread records begin/end events for the work it does
+///     (processBlock(), DelayEffect::update(), clear(), processAudioBuffer())
+///     into a fixed-size ring, without locking or allocating. Any other
+///     thread can take a snapshot of the ring and write it out in the Chrome
+///     trace-event JSON format, which chrome://tracing and Perfetto
+///     (ui.perfetto.dev) both open. Timestamps come from steady_clock, so
+///     traces from several instances in one process line up with each other.
+///
+///     When the ring is full the oldest events are overwritten, so a dump
+///     always holds the most recent CAPACITY events. At 6 events per block
+///     that is about 7 seconds of 256-sample blocks at 48 kHz.
+///
+///     The ring's memory is allocated by allocate() (from prepareToPlay()),
+///     not by the constructor, so plugin scans don't pay for it. Events
+///     recorded before then are ignored.
+///
+
+#ifndef TRACE_RING_H
+#define TRACE_RING_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @class TraceRing
+ *
+ * @brief Single-producer, wait-free ring of trace events.
+ *
+ * record(), begin(), end() and TraceScope must only be called by one thread
+ * at a time: the audio thread, or a thread the host keeps from running at
+ * the same time as it (e.g. in releaseResources()). The other methods can
+ * be called from any thread.
+ */
+class TraceRing
+{
+public:
+    static constexpr size_t CAPACITY = 8192;
+
+    enum class Phase : char { begin = 'B', end = 'E', instant = 'i' };
+
+    struct Event
+    {
+        std::int64_t timestampNs;
+        const char* name;
+        Phase phase;
+        std::int64_t value;
+    };
+
+    explicit TraceRing(std::string trackName = "DelayPlugin");
+
+    // Record an event. name must be a string literal (only the pointer is
+    // stored). value is shown as an argument in the trace viewer.
+    void record(const char* name, Phase phase, std::int64_t value = 0)
+    {
+        Slot* slots = m_slots.load(std::memory_order_relaxed);
+
+        if (slots == nullptr || ! m_isEnabled.load(std::memory_order_relaxed))
+            return;
+
+        std::uint64_t index = m_writeCount.load(std::memory_order_relaxed);
+        Slot& slot = slots[index & (CAPACITY - 1)];
+
+        slot.timestampNs.store(now(), std::memory_order_relaxed);
+        slot.name.store(name, std::memory_order_relaxed);
+        slot.phase.store(static_cast<char>(phase), std::memory_order_relaxed);
+        slot.value.store(value, std::memory_order_relaxed);
+
+        m_writeCount.store(index + 1, std::memory_order_release);
+    }
+
+    void begin(const char* name, std::int64_t value = 0) { record(name, Phase::begin, value); }
+    void end(const char* name) { record(name, Phase::end); }
+
+    void allocate();
+    void setEnabled(bool shouldBeEnabled);
+    bool isEnabled() const;
+    void setTrackName(std::string trackName);
+
+    std::vector<Event> getSnapshot() const;
+    std::string toChromeTraceJson() const;
+    bool writeChromeTrace(const std::string& path) const;
+
+    static std::int64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    // Each field is a relaxed atomic so a reader racing the writer sees
+    // whole values; the snapshot then drops any slot that may have been
+    // rewritten while it was being read.
+    struct Slot
+    {
+        std::atomic<std::int64_t> timestampNs{0};
+        std::atomic<const char*> name{nullptr};
+        std::atomic<char> phase{0};
+        std::atomic<std::int64_t> value{0};
+    };
+
+    std::unique_ptr<Slot[]> m_slotStorage;
+    std::atomic<Slot*> m_slots;
+    std::atomic<std::uint64_t> m_writeCount;
+    std::atomic<bool> m_isEnabled;
+    std::string m_trackName;
+    int m_trackId;
+};
+
+
+/**
+ * @class TraceScope
+ *
+ * @brief Records a begin event on construction and the matching end event
+ *        when it goes out of scope. Does nothing when given a null ring.
+ */
+class TraceScope
+{
+public:
+    TraceScope(TraceRing* ring, const char* name, std::int64_t value = 0)
+        : m_ring{ring}, m_name{name}
+    {
+        if (m_ring != nullptr)
+            m_ring->begin(m_name, value);
+    }
+
+    ~TraceScope()
+    {
+        if (m_ring != nullptr)
+            m_ring->end(m_name);
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    TraceRing* m_ring;
+    const char* m_name;
+};
+
+#endif // TRACE_RING_H
@@ -9,9 +9,10 @@
 #include "BinaryData.h"
 #include <JuceHeader.h>
 #include "CustomLookAndFeel.h"
+#include "TelemetryViews.h"
 
 //==============================================================================
-class RasterComponent final : public juce::Component
+class RasterComponent final : public juce::Component, private juce::Timer
 {
 public:
     explicit RasterComponent (AudioPluginAudioProcessor&);
@@ -22,6 +23,8 @@ public:
     void resized() override;
 
 private:
+    void timerCallback() override;
+
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
     AudioPluginAudioProcessor& processorRef;
@@ -84,11 +87,26 @@ private:
     // Loop filter type
     juce::ComboBox loopFilterTypeComboBox;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> loopFilterTypeComboBoxAttachment;
+    // Loop filter resonance (SVF types only)
+    juce::Slider loopFilterResonanceSlider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> loopFilterResonanceSliderAttachment;
+    juce::Label loopFilterResonanceLabel;
 
     // Diffusion
     juce::Slider diffusionSlider;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> diffusionSliderAttachment;
     juce::Label diffusionLabel;
+    juce::Slider diffusionSizeSlider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> diffusionSizeSliderAttachment;
+    juce::Label diffusionSizeLabel;
+
+    // Feedback saturation
+    juce::ComboBox saturationTypeComboBox;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> saturationTypeComboBoxAttachment;
+    juce::Label saturationLabel;
+    juce::Slider saturationDriveSlider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> saturationDriveSliderAttachment;
+    juce::Label saturationDriveLabel;
 
     // Ping Pong Toggle
     juce::ToggleButton pingPongToggleButton;
@@ -100,6 +118,44 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> bypassToggleButtonAttachment;
     juce::Label bypassLabel;
 
+    // Bypass trails
+    juce::ToggleButton trailsToggleButton;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> trailsToggleButtonAttachment;
+    juce::Label trailsLabel;
+
+    // Reverse
+    juce::ToggleButton reverseToggleButton;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> reverseToggleButtonAttachment;
+    juce::Label reverseLabel;
+
+    // Freeze
+    juce::ToggleButton freezeToggleButton;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> freezeToggleButtonAttachment;
+    juce::Label freezeLabel;
+
+    // Spectral mode
+    juce::ToggleButton spectralToggleButton;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> spectralToggleButtonAttachment;
+    juce::Label spectralLabel;
+    juce::Slider spectralDelayTiltSlider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> spectralDelayTiltSliderAttachment;
+    juce::Label spectralDelayTiltLabel;
+    juce::Slider spectralFeedbackTiltSlider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> spectralFeedbackTiltSliderAttachment;
+    juce::Label spectralFeedbackTiltLabel;
+
+    // CPU load readout
+    juce::Label loadLabel;
+    int timerTicksSinceLoadUpdate { 0 };
+
+    // Meters and delay line scope, fed from the processor's telemetry queue
+    LevelMeter inputMeter { "In" };
+    LevelMeter outputMeter { "Out" };
+    LevelMeter feedbackMeter { "Fb" };
+    DelayScope delayScope;
+
+    void drainTelemetry();
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RasterComponent)
 };
 
@@ -5,11 +5,33 @@
 
 #pragma once
 
+#include "BlockLoadMeter.h"
 #include "DSP/DelayEffect.h"
+#include "DSP/TelemetryFifo.h"
 #include <juce_audio_processors/juce_audio_processors.h>
 
 //==============================================================================
-class AudioPluginAudioProcessor final : public juce::AudioProcessor
+// Per-block levels sent from the audio thread to the editor
+struct TelemetryFrame
+{
+    float inputPeak;
+    float inputRms;
+    float outputPeak;
+    float outputRms;
+    float feedbackRms;
+    float delayLineMin;
+    float delayLineMax;
+    float delayTimeMs;
+    float sampleRate;
+    int numSamples;
+};
+
+// Room for a few display frames' worth of 32-sample blocks at 192 kHz
+using TelemetryQueue = TelemetryFifo<TelemetryFrame, 1024>;
+
+//==============================================================================
+class AudioPluginAudioProcessor final : public juce::AudioProcessor,
+                                        private juce::AsyncUpdater
 {
 public:
     //==============================================================================
@@ -25,6 +47,11 @@ public:
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
     using AudioProcessor::processBlock;
 
+    void processBlockBypassed (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    using AudioProcessor::processBlockBypassed;
+
+    juce::AudioProcessorParameter* getBypassParameter() const override;
+
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
@@ -50,12 +77,43 @@ public:
 
     juce::AudioProcessorValueTreeState& getAPVTS();
 
+    size_t getMemoryUsageBytes() const;
+    const BlockLoadMeter& getLoadMeter() const;
+    BlockLoadMeter::Statistics getLoadStatistics() const;
+    TraceRing& getTraceRing();
+
+    void setTelemetryEnabled(bool shouldBeEnabled);
+    TelemetryQueue& getTelemetryQueue();
+
 private:
 
+    // Declared before m_delayEffect, which records into it
+    TraceRing m_traceRing;
+
     DelayEffect m_delayEffect;
 
+    BlockLoadMeter m_loadMeter;
+
+    // Filled only while an editor is open to drain it
+    TelemetryQueue m_telemetryQueue;
+    std::atomic<bool> m_isTelemetryEnabled { false };
+
+    // Latency the delay last asked for. The audio thread sets it, and the
+    // host is told on the message thread (see handleAsyncUpdate()).
+    std::atomic<int> m_pendingLatencySamples { 0 };
+
+    void processDelay(juce::AudioBuffer<float>& buffer, bool isHostBypassed);
+    void measureLevels(const juce::AudioBuffer<float>& buffer, float& peak, float& rms) const;
+    void handleAsyncUpdate() override;
+
     juce::AudioProcessorValueTreeState m_apvts;
 
+    // Read directly every block, so a settled bypass can skip everything else
+    std::atomic<float>* m_isBypassOnValue = nullptr;
+
+    // Read for telemetry every block while an editor is open
+    std::atomic<float>* m_delayTimeValue = nullptr;
+
     juce::AudioProcessorValueTreeState::ParameterLayout createParameters();
     
     //==============================================================================
@@ -0,0 +1,77 @@
+///
+///     @file TelemetryViews.h
+///     @brief Level meters and delay line scope for the editor.
+///     @date October 18, 2026
+///
+///     Both components are fed from the processor's telemetry queue by the
+///     editor's timer, and only repaint the part of themselves that changed:
+///     a meter repaints when its bar moves by at least a pixel, and the
+///     scope draws new columns into an offscreen image and repaints just
+///     those columns (it sweeps left to right like an oscilloscope rather
+///     than scrolling, so old columns never have to be redrawn).
+///
+
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+//==============================================================================
+// Vertical peak/RMS meter on a -60..0 dBFS scale
+class LevelMeter final : public juce::Component
+{
+public:
+    explicit LevelMeter (const juce::String& caption);
+
+    void setLevels (float peak, float rms);
+    void paint (juce::Graphics&) override;
+
+private:
+    static constexpr float MIN_DB = -60.0f;
+    static constexpr int CAPTION_HEIGHT = 14;
+
+    // Display release per update (levels fall back smoothly)
+    static constexpr float RELEASE = 0.85f;
+
+    juce::String caption;
+    float displayedPeak { 0.0f };
+    float displayedRms { 0.0f };
+    int peakHeight { 0 };
+    int rmsHeight { 0 };
+
+    int getBarHeight (float level) const;
+    juce::Rectangle<int> getBarArea() const;
+};
+
+//==============================================================================
+// Sweeping min/max view of the signal written into the delay lines. The full
+// width always spans the current delay time, so it shows what is in the
+// delay line right now.
+class DelayScope final : public juce::Component
+{
+public:
+    DelayScope();
+
+    void addBlock (float minimum, float maximum, int numSamples,
+                   float sampleRate, float delayTimeMs);
+    void repaintDirtyArea();
+
+    void paint (juce::Graphics&) override;
+    void resized() override;
+
+private:
+    juce::Image image;
+    int writeX { 0 };
+
+    // Samples still to go into the column being built, and its range so far
+    double samplesPerColumn { 1.0 };
+    double columnSamples { 0.0 };
+    float columnMin { 0.0f };
+    float columnMax { 0.0f };
+    bool isColumnEmpty { true };
+
+    // Columns drawn since the last repaint
+    int firstDirtyX { -1 };
+    int numDirtyColumns { 0 };
+
+    void drawColumn (float minimum, float maximum);
+};
@@ -0,0 +1,148 @@
+///
+///     @file BlockLoadMeter.cpp
+///     @brief Per-instance realtime CPU load and deadline-miss tracking.
+///     @date October 18, 2026
+///
+
+#include "DelayPlugin/BlockLoadMeter.h"
+#include <algorithm>
+
+
+BlockLoadMeter::BlockLoadMeter() : m_msPerSample{0.0}
+{
+    clearStatistics();
+}
+
+
+// Set the block budget. Call from prepareToPlay(), not while processing.
+void BlockLoadMeter::reset(double sampleRate, int maximumBlockSize)
+{
+    m_loadMeasurer.reset(sampleRate, maximumBlockSize);
+    m_msPerSample.store(sampleRate > 0.0 ? 1000.0 / sampleRate : 0.0,
+                        std::memory_order_relaxed);
+    clearStatistics();
+}
+
+
+/**
+ * Record one processed block. Audio thread only. Lock-free.
+ *
+ * @param milliseconds  How long the block took to process.
+ * @param numSamples    The number of samples in the block. The budget is
+ *                      worked out per block, since hosts may send blocks
+ *                      shorter than the maximum.
+ */
+void BlockLoadMeter::registerBlock(double milliseconds, int numSamples)
+{
+    double budget = m_msPerSample.load(std::memory_order_relaxed) * numSamples;
+
+    if (budget <= 0.0)
+        return;
+
+    m_loadMeasurer.registerRenderTime(milliseconds, numSamples);
+
+    double load = milliseconds / budget;
+
+    int bucket = std::min(static_cast<int>(load / BUCKET_WIDTH), NUM_BUCKETS - 1);
+    m_histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+
+    if (load > 1.0)
+        m_numOverruns.fetch_add(1, std::memory_order_relaxed);
+
+    if (load > m_peakLoad.load(std::memory_order_relaxed))
+        m_peakLoad.store(load, std::memory_order_relaxed);
+
+    m_numBlocks.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+// Get the current statistics. Safe to call from any thread.
+BlockLoadMeter::Statistics BlockLoadMeter::getStatistics() const
+{
+    Statistics stats{};
+
+    stats.load = m_loadMeasurer.getLoadAsProportion();
+    stats.peakLoad = m_peakLoad.load(std::memory_order_relaxed);
+    stats.numBlocks = m_numBlocks.load(std::memory_order_relaxed);
+    stats.numOverruns = m_numOverruns.load(std::memory_order_relaxed);
+
+    stats.p99Load = getLoadPercentile(99.0);
+
+    return stats;
+}
+
+
+/**
+ * Get the block load that the given percentage of blocks stayed under, to
+ * the resolution of the histogram (the upper edge of the bucket it falls
+ * in). Safe to call from any thread.
+ *
+ * @param percentile    Between 0 and 100, e.g. 99.9 for the 99.9th
+ *                      percentile.
+ *
+ * @return              The load as a proportion of the budget, or 0 if no
+ *                      blocks have been recorded.
+ */
+double BlockLoadMeter::getLoadPercentile(double percentile) const
+{
+    Histogram histogram = getHistogram();
+    std::uint64_t total = 0;
+
+    for (auto count : histogram)
+        total += count;
+
+    if (total == 0)
+        return 0.0;
+
+    double target = std::clamp(percentile, 0.0, 100.0) * 0.01 * total;
+    std::uint64_t seen = 0;
+
+    for (int bucket = 0; bucket < NUM_BUCKETS; bucket++)
+    {
+        seen += histogram[bucket];
+
+        if (seen >= target)
+            return (bucket + 1) * BUCKET_WIDTH;
+    }
+
+    return NUM_BUCKETS * BUCKET_WIDTH;
+}
+
+
+// Get a snapshot of the block load histogram. Safe to call from any thread.
+BlockLoadMeter::Histogram BlockLoadMeter::getHistogram() const
+{
+    Histogram histogram;
+
+    for (int bucket = 0; bucket < NUM_BUCKETS; bucket++)
+        histogram[bucket] = m_histogram[bucket].load(std::memory_order_relaxed);
+
+    return histogram;
+}
+
+
+// Start counting from zero again. Blocks recorded meanwhile may be lost.
+void BlockLoadMeter::clearStatistics()
+{
+    m_numBlocks.store(0, std::memory_order_relaxed);
+    m_numOverruns.store(0, std::memory_order_relaxed);
+    m_peakLoad.store(0.0, std::memory_order_relaxed);
+
+    for (auto& count : m_histogram)
+        count.store(0, std::memory_order_relaxed);
+}
+
+
+//==============================================================================
+BlockLoadMeter::ScopedTimer::ScopedTimer(BlockLoadMeter& meter, int numSamples)
+    : m_meter{meter}, m_numSamples{numSamples},
+      m_startMilliseconds{juce::Time::getMillisecondCounterHiRes()}
+{
+}
+
+
+BlockLoadMeter::ScopedTimer::~ScopedTimer()
+{
+    m_meter.registerBlock(juce::Time::getMillisecondCounterHiRes()
+                            - m_startMilliseconds, m_numSamples);
+}
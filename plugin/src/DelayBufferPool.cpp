@@ -0,0 +1,532 @@
+///
+///     @file DelayBufferPool.cpp
+///     @brief Process-wide pool of delay line memory.
+///     @date October 18, 2026
+///
+
+#include "DelayPlugin/DSP/DelayBufferPool.h"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <utility>
+
+
+// Default limit on memory the pool keeps for reuse once nobody is using it
+static constexpr std::size_t DEFAULT_MAX_POOLED_BYTES = 64 * 1024 * 1024;
+
+
+DelayBufferPool& DelayBufferPool::getInstance()
+{
+    static DelayBufferPool pool;
+    return pool;
+}
+
+
+DelayBufferPool::DelayBufferPool() : m_maxPooledBytes{DEFAULT_MAX_POOLED_BYTES},
+    m_pooledBytes{0}, m_inUseBytes{0}, m_pooledBlocks{0}, m_inUseBlocks{0},
+    m_hasWork{false}, m_shouldStop{false}
+{
+}
+
+
+DelayBufferPool::~DelayBufferPool()
+{
+    // All leases should be gone by now, which also stops the service thread
+    if (m_serviceThread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_shouldStop = true;
+        }
+        m_wakeUp.notify_all();
+        m_serviceThread.join();
+    }
+
+    trim(0);
+}
+
+
+// Round a request up to the size of block that will be handed out
+std::size_t DelayBufferPool::getBlockSize(std::size_t numBytes)
+{
+    return numBytes == 0 ? 0 : std::bit_ceil(numBytes);
+}
+
+
+/**
+ * Get a zeroed block of at least numBytes, reusing a pooled one if possible.
+ *
+ * @param numBytes  Requested size. 0 gives an empty block.
+ *
+ * @throws std::bad_alloc if there is no pooled block and allocating one fails.
+ */
+DelayBufferPool::Block DelayBufferPool::acquire(std::size_t numBytes)
+{
+    Block block;
+
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        block = takeLocked(numBytes);
+    }
+
+    if (! fillBlock(block))
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        untakeLocked(block);
+
+        throw std::bad_alloc();
+    }
+
+    return block;
+}
+
+
+// Return a block to the pool for reuse
+void DelayBufferPool::release(Block block)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    releaseLocked(block);
+}
+
+
+// Free pooled (unused) blocks until at most maxPooledBytes remain
+void DelayBufferPool::trim(std::size_t maxPooledBytes)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    trimLocked(maxPooledBytes);
+}
+
+
+// Set the most memory the pool keeps for reuse. Anything over is freed.
+void DelayBufferPool::setMaxPooledBytes(std::size_t maxPooledBytes)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_maxPooledBytes = maxPooledBytes;
+    trimLocked(maxPooledBytes);
+}
+
+
+// Get a snapshot of the pool's memory use. Safe to call from any thread,
+// including the audio thread.
+DelayBufferPool::Statistics DelayBufferPool::getStatistics() const
+{
+    return { m_pooledBytes.load(std::memory_order_relaxed),
+             m_inUseBytes.load(std::memory_order_relaxed),
+             m_pooledBlocks.load(std::memory_order_relaxed),
+             m_inUseBlocks.load(std::memory_order_relaxed) };
+}
+
+
+// Take a block of at least numBytes off the free list, or (with no data)
+// one to be allocated. Either way it still has to go through fillBlock(),
+// which the caller does after letting go of the lock.
+DelayBufferPool::Block DelayBufferPool::takeLocked(std::size_t numBytes)
+{
+    Block block;
+    block.numBytes = getBlockSize(numBytes);
+
+    if (block.numBytes == 0)
+        return block;
+
+    auto freeList = m_freeBlocks.find(block.numBytes);
+
+    if (freeList != m_freeBlocks.end() && ! freeList->second.empty())
+    {
+        block.data = freeList->second.back();
+        freeList->second.pop_back();
+
+        m_pooledBytes -= block.numBytes;
+        m_pooledBlocks--;
+    }
+
+    m_inUseBytes += block.numBytes;
+    m_inUseBlocks++;
+
+    return block;
+}
+
+
+// Allocate a taken block's memory if it has none, and zero it so the audio 
+// thread never has to. Without the lock. Returns false if the allocation 
+// failed; the caller then gives the block back with untakeLocked().
+bool DelayBufferPool::fillBlock(Block& block)
+{
+    if (block.numBytes == 0)
+        return true;
+
+    if (block.data == nullptr)
+    {
+        block.data = static_cast<std::byte*>(::operator new(block.numBytes, 
+                        std::align_val_t{ALIGNMENT}, std::nothrow));
+
+        if (block.data == nullptr)
+            return false;
+    }
+
+    std::memset(block.data, 0, block.numBytes);
+    return true;
+}
+
+
+// Undo takeLocked() for a block that fillBlock() couldn't allocate
+void DelayBufferPool::untakeLocked(const Block& block)
+{
+    m_inUseBytes -= block.numBytes;
+    m_inUseBlocks--;
+}
+
+
+void DelayBufferPool::releaseLocked(Block block)
+{
+    if (block.data == nullptr)
+        return;
+
+    m_freeBlocks[block.numBytes].push_back(block.data);
+
+    m_inUseBytes -= block.numBytes;
+    m_inUseBlocks--;
+    m_pooledBytes += block.numBytes;
+    m_pooledBlocks++;
+
+    trimLocked(m_maxPooledBytes);
+}
+
+
+void DelayBufferPool::trimLocked(std::size_t maxPooledBytes)
+{
+    // Free the largest blocks first; they are the least likely to be reused
+    for (auto freeList = m_freeBlocks.rbegin(); freeList != m_freeBlocks.rend();
+            ++freeList)
+    {
+        while (m_pooledBytes > maxPooledBytes && ! freeList->second.empty())
+        {
+            ::operator delete(freeList->second.back(),
+                                std::align_val_t{ALIGNMENT});
+            freeList->second.pop_back();
+
+            m_pooledBytes -= freeList->first;
+            m_pooledBlocks--;
+        }
+    }
+}
+
+
+void DelayBufferPool::addLease(DelayBufferLease* lease)
+{
+    std::lock_guard<std::mutex> threadLock(m_threadLock);
+
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_leases.push_back(lease);
+    }
+
+    // The service thread only runs while somebody holds a lease
+    if (! m_serviceThread.joinable())
+    {
+        m_shouldStop = false;
+        m_serviceThread = std::thread([this] { serviceLoop(); });
+    }
+}
+
+
+void DelayBufferPool::removeLease(DelayBufferLease* lease)
+{
+    std::lock_guard<std::mutex> threadLock(m_threadLock);
+    bool noLeasesLeft;
+
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_leases.erase(std::find(m_leases.begin(), m_leases.end(), lease));
+
+        releaseLocked(lease->m_current);
+        releaseLocked(lease->m_pending);
+        releaseLocked(lease->m_retired);
+
+        noLeasesLeft = m_leases.empty();
+        m_shouldStop = noLeasesLeft;
+    }
+
+    if (noLeasesLeft && m_serviceThread.joinable())
+    {
+        m_wakeUp.notify_all();
+        m_serviceThread.join();
+    }
+}
+
+
+// Have the service thread look at the leases within SERVICE_POLL_MS. Safe 
+// from the audio thread: it only sets a flag.
+void DelayBufferPool::wakeServiceThread()
+{
+    m_hasWork.store(true, std::memory_order_release);
+}
+
+
+void DelayBufferPool::serviceLoop()
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    // Anything asked for before the thread started is serviced straight away
+    m_hasWork.store(true, std::memory_order_relaxed);
+
+    while (! m_shouldStop)
+    {
+        if (m_hasWork.exchange(false, std::memory_order_acquire))
+            serviceLeases(lock);
+
+        m_wakeUp.wait_for(lock, std::chrono::milliseconds(SERVICE_POLL_MS),
+                [this] { return m_shouldStop; });
+    }
+}
+
+
+// Recycle retired blocks and publish new ones for leases whose requests 
+// changed. Each new block is zeroed with the lock released and published 
+// straight after, unless its lease went away or changed its mind in the 
+// meantime. Smallest first, so a large block doesn't hold up small ones.
+void DelayBufferPool::serviceLeases(std::unique_lock<std::mutex>& lock)
+{
+    std::vector<std::pair<DelayBufferLease*, Block>> fills;
+
+    for (DelayBufferLease* lease : m_leases)
+    {
+        if (lease->service(*this))
+            fills.emplace_back(lease, takeLocked(
+                    lease->m_requestedBytes.load(std::memory_order_relaxed)));
+    }
+
+    std::sort(fills.begin(), fills.end(), [] (const auto& a, const auto& b)
+                    { return a.second.numBytes < b.second.numBytes; });
+
+    for (auto& [lease, block] : fills)
+    {
+        lock.unlock();
+        bool isFilled = fillBlock(block);
+        lock.lock();
+
+        bool isLeased = std::find(m_leases.begin(), m_leases.end(), lease) 
+                            != m_leases.end();
+
+        // Out of memory: the lease keeps what it has, and this size isn't
+        // tried again until it asks for another
+        if (! isFilled)
+        {
+            untakeLocked(block);
+
+            if (isLeased)
+                lease->m_failedBytes = block.numBytes;
+
+            continue;
+        }
+
+        if (! isLeased || ! lease->publish(block))
+            releaseLocked(block);
+    }
+}
+
+
+//==============================================================================
+// A lease only joins the pool (and so starts its service thread) on its 
+// first acquireNow() or joinPool(), so constructing one is free
+DelayBufferLease::DelayBufferLease() : m_state{idle}, m_requestedBytes{0},
+    m_currentBytes{0}, m_failedBytes{0}, m_isRegistered{false}
+{
+}
+
+
+DelayBufferLease::~DelayBufferLease()
+{
+    if (m_isRegistered)
+        DelayBufferPool::getInstance().removeLease(this);
+}
+
+
+/**
+ * Ask for a block of (at least) numBytes. Audio thread only. The block
+ * arrives later through getPendingBlock(). Requesting 0 bytes gives the
+ * current block back to the pool.
+ */
+void DelayBufferLease::request(std::size_t numBytes)
+{
+    std::size_t blockSize = DelayBufferPool::getBlockSize(numBytes);
+
+    // Called every block, so the service thread is only woken for a change
+    if (m_requestedBytes.exchange(blockSize, std::memory_order_relaxed) 
+            != blockSize && m_isRegistered)
+        DelayBufferPool::getInstance().wakeServiceThread();
+}
+
+
+/**
+ * Get the size of the current block. Unlike getCurrentBlock(), safe to call
+ * from any thread (e.g. for a memory readout in the editor); the value may
+ * be a block behind the audio thread.
+ */
+std::size_t DelayBufferLease::getCurrentBytes() const
+{
+    return m_currentBytes.load(std::memory_order_relaxed);
+}
+
+
+/**
+ * Get the block published by the service thread, or nullptr if there is
+ * none. Audio thread only. The block stays pending (and the current block
+ * stays valid) until acceptPendingBlock() is called, so the caller can copy
+ * the current contents across first.
+ */
+const DelayBufferLease::Block* DelayBufferLease::getPendingBlock() const
+{
+    if (m_state.load(std::memory_order_acquire) != pending)
+        return nullptr;
+
+    return &m_pending;
+}
+
+
+/**
+ * Make the pending block current. The old block is handed back to the
+ * service thread, which returns it to the pool. Audio thread only, and only
+ * after getPendingBlock() returned a block.
+ */
+void DelayBufferLease::acceptPendingBlock()
+{
+    m_retired = m_current;
+    m_current = m_pending;
+    m_pending = Block();
+
+    m_currentBytes.store(m_current.numBytes, std::memory_order_relaxed);
+    m_state.store(retired, std::memory_order_release);
+
+    // The old block is recycled, and any request made meanwhile serviced
+    DelayBufferPool::getInstance().wakeServiceThread();
+}
+
+
+/**
+ * Replace the current block with a new one of (at least) numBytes straight
+ * away. Must not be called while the audio thread is using the lease (e.g.
+ * from prepareToPlay()). If the allocation fails the lease is left empty,
+ * and that size isn't tried again until a different one is requested.
+ */
+void DelayBufferLease::acquireNow(std::size_t numBytes)
+{
+    DelayBufferPool& pool = DelayBufferPool::getInstance();
+
+    // Nothing held yet, so releasing needs no pool at all
+    if (! m_isRegistered && numBytes == 0)
+        return;
+
+    joinPool();
+
+    Block block;
+
+    // While the new block is zeroed the lease holds nothing and asks for 
+    // nothing, so the service thread leaves it alone
+    {
+        std::lock_guard<std::mutex> lock(pool.m_lock);
+
+        pool.releaseLocked(m_current);
+        pool.releaseLocked(m_pending);
+        pool.releaseLocked(m_retired);
+        m_current = Block();
+        m_pending = Block();
+        m_retired = Block();
+
+        m_requestedBytes.store(0, std::memory_order_relaxed);
+        m_currentBytes.store(0, std::memory_order_relaxed);
+        m_state.store(idle, std::memory_order_release);
+        m_failedBytes = 0;
+
+        block = pool.takeLocked(numBytes);
+    }
+
+    bool isFilled = DelayBufferPool::fillBlock(block);
+
+    std::lock_guard<std::mutex> lock(pool.m_lock);
+
+    if (! isFilled)
+    {
+        pool.untakeLocked(block);
+        m_requestedBytes.store(block.numBytes, std::memory_order_relaxed);
+        m_failedBytes = block.numBytes;
+        return;
+    }
+
+    m_current = block;
+    m_requestedBytes.store(m_current.numBytes, std::memory_order_relaxed);
+    m_currentBytes.store(m_current.numBytes, std::memory_order_relaxed);
+}
+
+
+/**
+ * Have the pool service this lease from now on, without taking any memory
+ * yet. Not from the audio thread. acquireNow() does this too; it is only
+ * needed for a lease that may start out empty and later request() memory
+ * from the audio thread.
+ */
+void DelayBufferLease::joinPool()
+{
+    if (m_isRegistered)
+        return;
+
+    DelayBufferPool::getInstance().addLease(this);
+    m_isRegistered = true;
+}
+
+
+/**
+ * Give all memory back to the pool straight away. Must not be called while
+ * the audio thread is using the lease (e.g. from releaseResources()).
+ */
+void DelayBufferLease::releaseNow()
+{
+    acquireNow(0);
+}
+
+
+// Called by the pool's service thread with the pool lock held. Recycles a
+// retired block, and returns true if the lease needs a new block of the 
+// requested size.
+bool DelayBufferLease::service(DelayBufferPool& pool)
+{
+    int state = m_state.load(std::memory_order_acquire);
+
+    // Recycle the block the audio thread has finished with
+    if (state == retired)
+    {
+        pool.releaseLocked(m_retired);
+        m_retired = Block();
+
+        m_state.store(idle, std::memory_order_release);
+        state = idle;
+    }
+
+    if (state != idle)
+        return false;
+
+    std::size_t requestedBytes = m_requestedBytes.load(std::memory_order_relaxed);
+
+    if (requestedBytes != m_failedBytes)
+        m_failedBytes = 0;
+
+    return requestedBytes != m_currentBytes.load(std::memory_order_relaxed)
+            && requestedBytes != m_failedBytes;
+}
+
+
+// Hand a block from service() to the audio thread. Service thread, with 
+// the pool lock held. Returns false, leaving the block to the caller, if 
+// the lease no longer wants a block of that size.
+bool DelayBufferLease::publish(Block block)
+{
+    if (m_state.load(std::memory_order_acquire) != idle 
+            || m_requestedBytes.load(std::memory_order_relaxed) != block.numBytes)
+        return false;
+
+    m_pending = block;
+    m_state.store(pending, std::memory_order_release);
+
+    return true;
+}
@@ -10,30 +10,53 @@
 
 #include "DelayPlugin/DSP/DelayEffect.h"
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <limits>
 
 
-DelayEffect::DelayEffect() : m_sampleRate{}, m_delayTime{}, m_feedback{}, 
+// Diffuser delay lengths based on Freeverb (given at 44.1 kHz, and scaled to 
+// the actual sample rate and the diffuser size)
+// ccrma.stanford.edu/~jos/pasp/Freeverb.html
+static constexpr unsigned int DIFFUSER_LENGTHS[] = {225, 556, 441, 341};
+static constexpr float DIFFUSER_GAINS[] = {0.7f, 0.7f, 0.7f, 0.7f};
+
+static FusedDiffuser<float> makeDiffuser()
+{
+    return FusedDiffuser<float>(DIFFUSER_LENGTHS, DIFFUSER_GAINS);
+}
+
+
+DelayEffect::DelayEffect() : m_isPrepared{false}, m_sampleRate{}, m_delayTime{}, m_feedback{}, 
     m_mix{}, m_isPingPongOn{}, m_lastIsPingPongOn{}, m_isBypassOn{}, 
-    m_lastIsBypassOn{}, m_loopFilterType{}, m_lastLoopFilterType{}, 
-    m_loopFilterCutoff{}, m_diffusion{}
+    m_lastIsBypassOn{}, m_isBypassTrailsOn{}, m_isBypassTrailing{false}, 
+    m_bypassFadeStep{}, m_effectLevel{1.0f}, 
+    m_silentTailSamples{0}, m_bypassDry{}, m_loopFilterType{}, 
+    m_lastLoopFilterType{}, 
+    m_loopFilterCutoff{}, m_loopFilterPosition{}, m_loopFilterResonance{}, m_svfCutoff{}, 
+    m_diffusion{}, m_diffusionSize{1.0f}, m_diffuserSetSizes{1.0f, 1.0f}, 
+    m_activeDiffuserSet{0}, m_diffuserFadeSamples{0}, m_diffuserFadePosition{0}, 
+    m_saturationType{}, m_lastSaturationType{}, 
+    m_saturationDrive{1.0f}, m_isSpectralOn{}, m_lastIsSpectralOn{}, 
+    m_spectralDelayTilt{}, m_spectralFeedbackTilt{}, m_isFreezeOn{}, 
+    m_lastIsFreezeOn{}, m_freezeFadeSamples{0}, m_freezeLoopLength{0}, 
+    m_freezeLoopFadeLength{0}, m_freezeLoopFadeStep{}, m_freezePosition{0}, 
+    m_freezeTailPosition{0}, m_isReverseOn{}, m_lastIsReverseOn{}, 
+    m_reverseVoices{}, m_nextReverseVoice{0}, m_reverseSamplesUntilSegment{0}, 
+    m_reverseChunk{}, m_smoothedDelayTime{}, m_liveDelaySamples{}, 
+    m_diffuserSets{{{{makeDiffuser(), makeDiffuser()}}, 
+                    {{makeDiffuser(), makeDiffuser()}}}}, m_traceRing{nullptr}, m_areChannelsInSync{true}, 
+    m_isRightChannelStale{false}, m_samplesUntilSyncCheck{0}, 
+    m_syncCheckAge{-1}, 
+    m_feedbackSumSquares{}
 {
     // Delay time smoothing filter will have a fixed cutoff frequency of 1 Hz.
     m_delayTimeLowPass.setCutoff(1.0f); 
 
-    for (int channel = 0; channel < 2; channel++)
-    {
-        // Delay buffers are initialized with a size of 1024, but will be 
-        // resized once the sample rate is provided in prepareToPlay()
-        m_delayBuffers.emplace_back(1024, 0.0f);
-        
-        m_loopFilters.emplace_back(); 
-
-        // Diffuser delay lengths based on Freeverb 
-        // ccrma.stanford.edu/~jos/pasp/Freeverb.html
-        m_diffusers.emplace_back(4, 
-                        std::vector<unsigned int>{225, 556, 441, 341}, 
-                            std::vector<float>{0.7f, 0.7f, 0.7f, 0.7f});
-    }
+    // Delay buffers are empty until prepareToPlay() gives them pool memory
+    for (auto& delayBuffer : m_delayBuffers)
+        delayBuffer.setStorageScale(DELAY_LINE_FIXED_SCALE);
 }
 
 
@@ -45,6 +68,12 @@ DelayEffect::~DelayEffect()
 // Initialize before playback begins
 void DelayEffect::prepareToPlay(float sampleRate)
 {
+    // Hosts often prepare again with nothing relevant changed (e.g. only 
+    // the block size). Everything is already allocated and sized for this 
+    // rate then, so it is left alone, state included.
+    if (m_isPrepared && sampleRate == m_sampleRate)
+        return;
+
     m_sampleRate = sampleRate;
 
     m_delayTimeLowPass.setSampleRate(sampleRate);
@@ -52,21 +81,92 @@ void DelayEffect::prepareToPlay(float sampleRate)
     for (auto& filter : m_loopFilters)
         filter.setSampleRate(sampleRate);
 
-    // Max delay in samples must be rounded up. This will be used to determine 
-    // the size of the delay buffers.
-    int maxDelaySamples = static_cast<int>(
-                                std::ceil(MAX_DELAY_SECONDS * sampleRate)); 
+    m_loopFilterTable.build(sampleRate, LOOP_FILTER_CUTOFF_MAX, 
+                                LOOP_FILTER_CUTOFF_CENTRE);
+
+    for (auto& filter : m_svfLoopFilters)
+        filter.setSampleRate(sampleRate);
 
-    // Buffer size must be at least (maxDelaySamples + 1). CircularBuffer also
-    // requires a size that's a power of 2.
-    // (method for finding the next power of 2 was originally implemented by 
-    // Travis Garrahan)
-    int delayBufferSize = 1;
-    while (delayBufferSize < maxDelaySamples + 1)
-        delayBufferSize <<= 1;
+    for (auto& saturator : m_saturators)
+        saturator.setSampleRate(sampleRate);
 
-    for (auto& delayBuffer : m_delayBuffers)
-        delayBuffer.resize(delayBufferSize);
+    // The diffuser rings are small and touched every sample, so both 
+    // channels' rings share one pool block. Any crossfade to a new size is 
+    // dropped; the diffusers start over at the size in use now. The other 
+    // set's lease has to join the pool for later size changes.
+    m_diffuserFadeSamples = static_cast<int>(
+                                std::ceil(DIFFUSER_FADE_SECONDS * sampleRate));
+    m_diffuserFadePosition = m_diffuserFadeSamples;
+
+    for (auto& lease : m_diffuserLeases)
+        lease.joinPool();
+
+    m_diffuserLeases[m_activeDiffuserSet ^ 1].releaseNow();
+    m_diffuserLeases[m_activeDiffuserSet].acquireNow(
+                                        getDiffuserRingBytes(m_diffusionSize));
+    layOutDiffuserSet(m_activeDiffuserSet, m_diffusionSize);
+
+    m_freezeFadeSamples = static_cast<int>(
+                                std::ceil(FREEZE_FADE_SECONDS * sampleRate));
+
+    // A bypass starts out settled, with nothing to fade
+    m_bypassFadeStep = 1.0f / std::ceil(BYPASS_FADE_SECONDS * sampleRate);
+    m_effectLevel = m_isBypassOn ? 0.0f : 1.0f;
+    m_isBypassTrailing = false;
+    m_lastIsBypassOn = m_isBypassOn;
+
+    for (auto& tail : m_freezeTails)
+        tail.assign(static_cast<size_t>(m_freezeFadeSamples), 0.0f);
+
+    m_freezeTailPosition = m_freezeFadeSamples;
+
+    // The delay lines get pool memory for the delay time currently in use. 
+    // update() grows or shrinks it as the delay time changes. In spectral 
+    // mode the delay lines aren't used, and the spectral rings get the 
+    // memory instead. A bypassed delay needs none.
+    size_t delayBufferSize = m_isSpectralOn || m_isBypassOn 
+                                ? 0 : getDelayBufferSize(
+                                std::max(m_delayTime, m_smoothedDelayTime)
+                                    * (m_isReverseOn ? 2.0f : 1.0f));
+
+    // A lease that starts out empty still has to join the pool now, so 
+    // that it is serviced when update() asks for memory later
+    for (int channel = 0; channel < 2; channel++)
+    {
+        m_delayLeases[channel].joinPool();
+        m_delayLeases[channel].acquireNow(
+                                delayBufferSize * sizeof(DelayLineStorage));
+        attachDelayMemory(channel);
+    }
+
+    m_spectralDelay.prepare(sampleRate);
+    m_spectralLease.joinPool();
+    m_spectralLease.acquireNow(m_isSpectralOn && ! isBypassSettled() 
+                                ? m_spectralDelay.getRingBytes() : 0);
+    attachSpectralMemory();
+
+    // Everything else starts from silence now, so the filters do too, and 
+    // both channels are in step again
+    for (auto& filter : m_loopFilters)
+        filter.clear();
+
+    for (auto& filter : m_svfLoopFilters)
+        filter.clear();
+
+    for (auto& saturator : m_saturators)
+        saturator.clear();
+
+    m_areChannelsInSync = true;
+    m_isRightChannelStale = false;
+    m_syncCheckAge = -1;
+
+    // A freeze carries on, but from the (now silent) new delay lines
+    if (m_isFreezeOn)
+        startFreeze();
+
+    m_lastIsFreezeOn = m_isFreezeOn;
+
+    m_isPrepared = true;
 }
 
 
@@ -75,6 +175,24 @@ void DelayEffect::releaseResources()
 {
     clear();
     m_delayTimeLowPass.clear();
+    m_smoothedDelayTime = 0.0f;
+
+    // Give the delay memory back to the pool while stopped
+    for (int channel = 0; channel < 2; channel++)
+    {
+        m_delayLeases[channel].releaseNow();
+        attachDelayMemory(channel);
+    }
+
+    m_spectralLease.releaseNow();
+    attachSpectralMemory();
+
+    // The diffusers are laid out again by the next prepareToPlay(), before 
+    // they are used
+    for (auto& lease : m_diffuserLeases)
+        lease.releaseNow();
+
+    m_isPrepared = false;
 }
 
 
@@ -83,19 +201,48 @@ void DelayEffect::releaseResources()
 void DelayEffect::setParametersFromAPVTS(
         juce::AudioProcessorValueTreeState& apvts)
 {
+    DSP_PROFILE_START(profileTime);
+
     // Get current parameter values. 
     m_mix              = *apvts.getRawParameterValue("MIX");
     m_feedback         = *apvts.getRawParameterValue("FEEDBACK");
     m_delayTime        = *apvts.getRawParameterValue("DELAY_TIME");    
     m_isPingPongOn     = *apvts.getRawParameterValue("IS_PING_PONG_ON");
     m_isBypassOn       = *apvts.getRawParameterValue("IS_BYPASS_ON");
+    m_isBypassTrailsOn = *apvts.getRawParameterValue("BYPASS_TRAILS");
     m_loopFilterCutoff = *apvts.getRawParameterValue("LOOP_FILTER_CUTOFF");
+    m_loopFilterPosition = apvts.getParameter("LOOP_FILTER_CUTOFF")->getValue();
+    m_loopFilterResonance = *apvts.getRawParameterValue("LOOP_FILTER_RESONANCE");
     m_diffusion        = *apvts.getRawParameterValue("DIFFUSION");
+    m_diffusionSize    = *apvts.getRawParameterValue("DIFFUSION_SIZE");
+    m_isFreezeOn       = *apvts.getRawParameterValue("IS_FREEZE_ON");
+    m_isReverseOn      = *apvts.getRawParameterValue("IS_REVERSE_ON");
+    m_isSpectralOn     = *apvts.getRawParameterValue("IS_SPECTRAL_ON");
+    m_spectralDelayTilt = *apvts.getRawParameterValue("SPECTRAL_DELAY_TILT");
+    m_spectralFeedbackTilt = *apvts.getRawParameterValue("SPECTRAL_FEEDBACK_TILT");
+    m_saturationDrive  = juce::Decibels::decibelsToGain(
+                    apvts.getRawParameterValue("SATURATION_DRIVE")->load());
 
     auto* loopFilterTypePtr = dynamic_cast<juce::AudioParameterChoice*>(
                                     apvts.getParameter("LOOP_FILTER_TYPE"));
     
     m_loopFilterType = loopFilterTypePtr->getIndex();
+
+    auto* saturationTypePtr = dynamic_cast<juce::AudioParameterChoice*>(
+                                    apvts.getParameter("SATURATION_TYPE"));
+
+    m_saturationType = saturationTypePtr->getIndex();
+
+    DSP_PROFILE_LAP(m_profiler, profileTime, parameterFetch);
+}
+
+
+// Bypass for this block whatever IS_BYPASS_ON says, for hosts that bypass 
+// through AudioProcessor::processBlockBypassed(). Call between 
+// setParametersFromAPVTS() and update().
+void DelayEffect::forceBypass()
+{
+    m_isBypassOn = true;
 }
 
 
@@ -103,48 +250,157 @@ void DelayEffect::setParametersFromAPVTS(
 // setParametersFromAPVTS().
 void DelayEffect::update()
 {
-    // Check if toggle values changed. Clear delay buffers if so
+    DSP_PROFILE_START(profileTime);
+    TraceScope trace(m_traceRing, "update");
+
+    // Bypass fades rather than clearing (see processBypassFade()). Trails 
+    // are latched as it engages, so switching them while bypassed can't 
+    // cut a tail off.
     if (m_isBypassOn != m_lastIsBypassOn)
     {
-        clear();
+        if (m_traceRing != nullptr)
+            m_traceRing->record("bypass toggled", TraceRing::Phase::instant, 
+                                m_isBypassOn);
+
+        m_isBypassTrailing = m_isBypassOn && m_isBypassTrailsOn;
+        m_silentTailSamples = 0;
         m_lastIsBypassOn = m_isBypassOn;
     }
- 
+
+    // Check if other toggle values changed. Clear delay buffers if so
+
     if (m_isPingPongOn != m_lastIsPingPongOn)
     {
+        if (m_traceRing != nullptr)
+            m_traceRing->record("ping pong toggled", 
+                                TraceRing::Phase::instant, m_isPingPongOn);
+
         clear();
         m_lastIsPingPongOn = m_isPingPongOn;
     }
 
+    if (m_isSpectralOn != m_lastIsSpectralOn)
+    {
+        if (m_traceRing != nullptr)
+            m_traceRing->record("spectral toggled", 
+                                TraceRing::Phase::instant, m_isSpectralOn);
+
+        clear();
+        m_lastIsSpectralOn = m_isSpectralOn;
+    }
+
+    if (m_isReverseOn != m_lastIsReverseOn)
+    {
+        if (m_traceRing != nullptr)
+            m_traceRing->record("reverse toggled", 
+                                TraceRing::Phase::instant, m_isReverseOn);
+
+        clear();
+        m_lastIsReverseOn = m_isReverseOn;
+    }
+
+    if (m_isFreezeOn != m_lastIsFreezeOn)
+    {
+        if (m_traceRing != nullptr)
+            m_traceRing->record("freeze toggled", 
+                                TraceRing::Phase::instant, m_isFreezeOn);
+
+        if (m_isFreezeOn)
+            startFreeze();
+        else
+            releaseFreeze();
+
+        m_lastIsFreezeOn = m_isFreezeOn;
+    }
+
     // Check if filter type changed. The filter state will also be cleared
     if (m_loopFilterType != m_lastLoopFilterType)
     {
-        switch (m_loopFilterType)
+        // Every type from FIRST_SVF_LOOP_FILTER_TYPE on is a state 
+        // variable filter response, in SvfType order
+        if (m_loopFilterType >= FIRST_SVF_LOOP_FILTER_TYPE)
         {
-            case 0:
-                for (auto& filter : m_loopFilters)
-                {
-                    filter.setFilterType(FilterType::lowPass);
-                }
-                break;
-            case 1:
-                for (auto& filter : m_loopFilters)
-                {
-                    filter.setFilterType(FilterType::highPass);
-                }
-                break;
-            default:
-                // Do nothing
-                break;
+            // State variable filters start from the current cutoff 
+            // rather than ramping from wherever they were left
+            m_svfCutoff = m_loopFilterCutoff;
+
+            for (auto& filter : m_svfLoopFilters)
+            {
+                filter.setFilterType(static_cast<SvfType>(
+                        m_loopFilterType - FIRST_SVF_LOOP_FILTER_TYPE));
+                filter.setCutoff(m_svfCutoff);
+            }
+        }
+        else
+        {
+            switch (m_loopFilterType)
+            {
+                case 0:
+                    for (auto& filter : m_loopFilters)
+                    {
+                        filter.setFilterType(FilterType::lowPass);
+                    }
+                    break;
+                case 1:
+                    for (auto& filter : m_loopFilters)
+                    {
+                        filter.setFilterType(FilterType::highPass);
+                    }
+                    break;
+                default:
+                    // Do nothing
+                    break;
+            }
         }
 
         m_lastLoopFilterType = m_loopFilterType;
     }
 
+    // Exact coefficients from the table; no std::exp per block, and none of 
+    // the Taylor approximation's error at high cutoffs
     for (auto& filter : m_loopFilters)
     {
-        filter.setCutoff(m_loopFilterCutoff);
+        filter.setCutoff(m_loopFilterTable, m_loopFilterPosition);
+    }
+
+    for (auto& filter : m_svfLoopFilters)
+    {
+        filter.setResonance(m_loopFilterResonance);
+    }
+
+    // Changing the curve starts the saturators from a clean state
+    if (m_saturationType != m_lastSaturationType)
+    {
+        if (m_saturationType != 0)
+        {
+            for (auto& saturator : m_saturators)
+            {
+                saturator.setCurve(static_cast<SaturationCurve>(
+                                                    m_saturationType - 1));
+            }
+        }
+
+        m_lastSaturationType = m_saturationType;
+    }
+
+    for (auto& saturator : m_saturators)
+    {
+        saturator.setDrive(m_saturationDrive);
+    }
+
+    // Only recomputes the per-bin settings when something has changed
+    if (m_isSpectralOn)
+    {
+        m_spectralDelay.setParameters(m_delayTime, m_feedback, 
+                                      m_spectralDelayTilt, 
+                                      m_spectralFeedbackTilt);
     }
+
+    updateDelayMemory();
+    updateSpectralMemory();
+    updateDiffuserMemory();
+
+    DSP_PROFILE_LAP(m_profiler, profileTime, update);
 }
 
 
@@ -152,12 +408,250 @@ void DelayEffect::update()
 // in the AudioProcessor that calls this method).
 void DelayEffect::processAudioBuffer(juce::AudioBuffer<float>& buffer)
 {
-    if (m_isBypassOn == true)
+    TraceScope trace(m_traceRing, "processAudioBuffer", buffer.getNumSamples());
+
+    m_feedbackSumSquares = 0.0f;
+
+    // Hosts may send empty blocks (e.g. to pass parameter changes). There 
+    // is nothing to process, and the per-sample ramps would divide by zero.
+    if (buffer.getNumSamples() == 0)
+    {
+        DSP_PROFILE_END_BLOCK(m_profiler);
+        return;
+    }
+
+    // Spectral mode keeps its latency while bypassed, so the dry signal 
+    // goes on through the spectral delay's input, which delays it to match
+    if (isBypassSettled())
+    {
+        if (m_isSpectralOn)
+        {
+            for (int channel = 0; channel < 2; channel++)
+            {
+                m_spectralDelay.processDry(channel, buffer.getWritePointer(channel), 
+                                           buffer.getNumSamples());
+            }
+        }
+
+        DSP_PROFILE_END_BLOCK(m_profiler);
+        return;
+    }
+
+    if (m_isBypassOn || m_effectLevel != 1.0f)
+        processBypassFade(buffer);
+    else
+        processEffect(buffer);
+}
+
+
+// true once a bypass has faded out (and any tail has died away), and the 
+// delay memory has gone back to the pool. processAudioBuffer() leaves the 
+// audio alone then, and update() has nothing left to do, so the caller can 
+// skip the effect altogether for as long as bypass stays on. Never true in 
+// spectral mode, where the bypassed signal is still delayed by the latency.
+bool DelayEffect::isFullyBypassed() const
+{
+    return isBypassSettled() && ! m_isSpectralOn 
+            && m_spectralLease.getCurrentBlock().numBytes == 0
+            && m_delayLeases[0].getCurrentBlock().numBytes == 0
+            && m_delayLeases[1].getCurrentBlock().numBytes == 0;
+}
+
+
+// true when bypassed, with the fade and any tail over
+bool DelayEffect::isBypassSettled() const
+{
+    return m_isBypassOn && m_effectLevel == 0.0f && ! m_isBypassTrailing;
+}
+
+
+/**
+ * Process a block while the bypass is fading in or out, or a tail is 
+ * playing out under it. The block is processed in chunks, each mixed with 
+ * a copy of its dry input, with the effect level moving towards its target 
+ * a sample at a time:
+ *
+ *      out = dry + level * (processed - dry)
+ *
+ * With trails, the input is scaled by the level before processing instead 
+ * (so the delay is fed less and less), and the dry signal made up to unity:
+ *
+ *      out = processed + (1 - level) * dry
+ *
+ * In spectral mode the dry signal is the spectral delay's input delayed by 
+ * the latency, the same as the processed signal's dry part, so the latency 
+ * holds through the fade. With trails, only the input to its rings is 
+ * scaled (a frame at a time), so the processed signal keeps its full 
+ * (1 - mix) * dry, and the rest is made up:
+ *
+ *      out = processed + (1 - level) * mix * dry
+ */
+void DelayEffect::processBypassFade(juce::AudioBuffer<float>& buffer)
+{
+    const int numSamples = buffer.getNumSamples();
+    const float step = m_isBypassOn ? -m_bypassFadeStep : m_bypassFadeStep;
+    float* const channels[2] = {buffer.getWritePointer(0), 
+                                buffer.getWritePointer(1)};
+
+    for (int start = 0; start < numSamples; start += BYPASS_CHUNK_SIZE)
+    {
+        // Faded out with no tail to play: the rest stays dry (delayed to 
+        // match in spectral mode)
+        if (isBypassSettled())
+        {
+            if (m_isSpectralOn)
+            {
+                for (int channel = 0; channel < 2; channel++)
+                    m_spectralDelay.processDry(channel, channels[channel] + start, 
+                                               numSamples - start);
+            }
+
+            break;
+        }
+
+        const int n = std::min(BYPASS_CHUNK_SIZE, numSamples - start);
+        const float startLevel = m_effectLevel;
+
+        auto levelAt = [startLevel, step](int i)
+        {
+            return std::clamp(startLevel + step * static_cast<float>(i + 1), 
+                              0.0f, 1.0f);
+        };
+
+        for (int channel = 0; channel < 2; channel++)
+        {
+            float* data = channels[channel] + start;
+
+            if (m_isSpectralOn)
+            {
+                m_spectralDelay.readDelayedInput(channel, m_bypassDry[channel].data(), n);
+            }
+            else
+            {
+                std::copy(data, data + n, m_bypassDry[channel].begin());
+
+                if (m_isBypassTrailing)
+                {
+                    for (int i = 0; i < n; i++)
+                        data[i] *= levelAt(i);
+                }
+            }
+        }
+
+        if (m_isSpectralOn)
+            m_spectralDelay.setInputGain(m_isBypassTrailing ? levelAt(n - 1) : 1.0f);
+
+        juce::AudioBuffer<float> chunk(channels, 2, start, n);
+        processEffect(chunk);
+
+        // Dry signal left in the processed signal with trails, and the 
+        // amount made up as the level falls
+        const float dryLeft = m_isSpectralOn ? 1.0f - m_mix : 0.0f;
+        const float dryMakeUp = m_isSpectralOn ? m_mix : 1.0f;
+        float tailPeak = 0.0f;
+
+        for (int channel = 0; channel < 2; channel++)
+        {
+            float* data = channels[channel] + start;
+            const auto& dry = m_bypassDry[channel];
+
+            for (int i = 0; i < n; i++)
+            {
+                float level = levelAt(i);
+
+                if (m_isBypassTrailing)
+                {
+                    tailPeak = std::max(tailPeak, std::abs(data[i] - dryLeft * dry[i]));
+                    data[i] += (1.0f - level) * dryMakeUp * dry[i];
+                }
+                else
+                {
+                    data[i] = dry[i] + level * (data[i] - dry[i]);
+                }
+            }
+        }
+
+        m_effectLevel = levelAt(n - 1);
+
+        // Once the input is off, the tail is over when it has stayed 
+        // silent for longer than anything the delay can hold
+        if (m_isBypassTrailing && m_effectLevel == 0.0f)
+        {
+            m_silentTailSamples = tailPeak < BYPASS_SILENCE_LEVEL 
+                                    ? m_silentTailSamples + n : 0;
+
+            if (m_silentTailSamples > static_cast<int>(
+                                    MAX_DELAY_SECONDS * m_sampleRate) 
+                                    + m_spectralDelay.getLatencySamples())
+                m_isBypassTrailing = false;
+        }
+
+        // Nothing is left to hear, so start the next unbypass from silence. 
+        // update() gives the delay memory back to the pool. The spectral 
+        // delay's input is the dry signal still to come, so it stays.
+        if (isBypassSettled())
+            clear(m_isSpectralOn);
+    }
+}
+
+
+// Run the effect on a block
+void DelayEffect::processEffect(juce::AudioBuffer<float>& buffer)
+{
+    // The spectral delay takes the place of the whole delay line path, so 
+    // ping pong, the loop filter, diffusion and saturation don't apply
+    if (m_isSpectralOn)
+    {
+        for (int channel = 0; channel < 2; channel++)
+        {
+            m_spectralDelay.process(channel, buffer.getWritePointer(channel), 
+                                    buffer.getNumSamples(), m_mix);
+        }
+
+        DSP_PROFILE_END_BLOCK(m_profiler);
+        return;
+    }
+
+    // Delay memory hasn't arrived from the pool yet. The delay lines would
+    // be silent anyway, so only the dry signal is output.
+    if (m_delayBuffers[0].getSize() == 0 || m_delayBuffers[1].getSize() == 0)
+    {
+        buffer.applyGain(1.0f - m_mix);
+        DSP_PROFILE_END_BLOCK(m_profiler);
+        return;
+    }
+
+    if (m_isFreezeOn)
+    {
+        processFrozen(buffer);
+        DSP_PROFILE_END_BLOCK(m_profiler);
         return;
+    }
+
+    // 1 when the left path's output can be used for both channels
+    const int numPaths = selectNumPaths(buffer);
+
+    // Temporary storage for the current sample in each channel
+    float inputData[2];
+    float tempData[2];
+    float feedbackSumSquares = 0.0f;
 
-    // Vectors for temporarily storing the current sample in each channel
-    std::vector<float> inputData(2);
-    std::vector<float> tempData(2);
+    // Reverse mode reads each stretch of the delay lines as one reversed 
+    // block copy, a chunk at a time (see fillReverseChunk())
+    int reverseChunkStart = 0;
+    int reverseChunkEnd = 0;
+
+    // The state variable filters glide to a new cutoff over the block 
+    // instead of jumping at its start
+    const bool isSvfLoopFilter = m_loopFilterType >= FIRST_SVF_LOOP_FILTER_TYPE;
+    const float svfStartCutoff = m_svfCutoff;
+    const float svfCutoffStep = (m_loopFilterCutoff - m_svfCutoff) 
+                                    / static_cast<float>(buffer.getNumSamples());
+    const bool isSvfCutoffRamping = isSvfLoopFilter && svfCutoffStep != 0.0f;
+
+    // Stage timing (see StageProfiler.h). Loop overhead between samples is
+    // charged to the delay read.
+    DSP_PROFILE_START(profileTime);
 
     // Loop through each sample (outer loop is through samples instead of
     // channels so that parameter smoothing only happens once.)
@@ -172,27 +666,101 @@ void DelayEffect::processAudioBuffer(juce::AudioBuffer<float>& buffer)
         int delaySamples = static_cast<int>(
                                     currentDelayTimeSeconds * m_sampleRate);
 
-        for (int channel = 0; channel < 2; channel++)
+        if (m_isReverseOn && sample == reverseChunkEnd)
+        {
+            reverseChunkStart = sample;
+            reverseChunkEnd = sample + fillReverseChunk(numPaths, 
+                                        buffer.getNumSamples() - sample);
+        }
+
+        // While the diffuser size changes, both diffuser sets run and 
+        // their outputs are crossfaded
+        auto& diffusers = m_diffuserSets[m_activeDiffuserSet];
+        auto& incomingDiffusers = m_diffuserSets[m_activeDiffuserSet ^ 1];
+
+        if (isSvfCutoffRamping)
+        {
+            // Land exactly on the target at the end of the block
+            m_svfCutoff = sample + 1 == buffer.getNumSamples() 
+                            ? m_loopFilterCutoff 
+                            : svfStartCutoff + svfCutoffStep * (sample + 1);
+
+            for (int channel = 0; channel < numPaths; channel++)
+                m_svfLoopFilters[channel].setCutoff(m_svfCutoff);
+        }
+
+        for (int channel = 0; channel < numPaths; channel++)
         {
             // Get the current input sample
             inputData[channel] = buffer.getWritePointer(channel)[sample];
 
-            // Get delayed output and apply feedback gain
-            tempData[channel] = m_feedback 
-                                    * m_delayBuffers[channel][delaySamples];
+            // Get delayed output and apply feedback gain. If the delay line 
+            // is still waiting for a larger block from the pool, anything 
+            // past its end is treated as silence, as is anything from before 
+            // the last clear().
+            const auto& delayBuffer = m_delayBuffers[channel];
+
+            if (m_isReverseOn)
+            {
+                tempData[channel] = m_feedback 
+                    * m_reverseChunk[channel][sample - reverseChunkStart];
+            }
+            else
+            {
+                tempData[channel] = static_cast<size_t>(delaySamples) 
+                                            < getLiveDelaySamples(channel)
+                                        ? m_feedback * delayBuffer[delaySamples]
+                                        : 0.0f;
+            }
+
+            DSP_PROFILE_LAP(m_profiler, profileTime, delayRead);
 
             // Apply filter to delay output (value of 2 means no filtering)
-            if (m_loopFilterType != 2)
+            if (isSvfLoopFilter)
+            {
+                tempData[channel] = m_svfLoopFilters[channel].getNextSample(
+                                                            tempData[channel]);
+            }
+            else if (m_loopFilterType != 2)
             {
                 tempData[channel] = m_loopFilters[channel].getNextSample(
                                                             tempData[channel]);
             }
 
+            DSP_PROFILE_LAP(m_profiler, profileTime, loopFilter);
+
             // Apply diffusion. The diffusion amount is controlled by 
             // cross-fading between the diffuser input and output
+            float diffused = diffusers[channel].getNextSample(tempData[channel]);
+
+            // The incoming diffusers start out empty, so their input is 
+            // faded in too. Switching it on at full level would start every 
+            // stage's echo with a step.
+            if (isDiffuserFading())
+            {
+                float gain = static_cast<float>(m_diffuserFadePosition + 1) 
+                                / static_cast<float>(m_diffuserFadeSamples + 1);
+                float incoming = incomingDiffusers[channel].getNextSample(
+                                                    gain * tempData[channel]);
+                diffused += gain * (incoming - diffused);
+            }
+
             tempData[channel] = (1.0f - m_diffusion) * tempData[channel]
-                + m_diffusion * m_diffusers[channel].getNextSample(
+                                    + m_diffusion * diffused;
+
+            DSP_PROFILE_LAP(m_profiler, profileTime, diffuser);
+
+            // Saturate the feedback signal, which limits how far high 
+            // feedback can build up (value of 0 means no saturation)
+            if (m_saturationType != 0)
+            {
+                tempData[channel] = m_saturators[channel].getNextSample(
                                                             tempData[channel]);
+            }
+
+            feedbackSumSquares += tempData[channel] * tempData[channel];
+
+            DSP_PROFILE_LAP(m_profiler, profileTime, saturator);
         }
 
         // Determine feedback configuration. This occurs outside of the 
@@ -207,35 +775,850 @@ void DelayEffect::processAudioBuffer(juce::AudioBuffer<float>& buffer)
             // Incomming audio will be fed into the left delay.
             m_delayBuffers[0].push(inputMono + tempData[1]);
             m_delayBuffers[1].push(tempData[0]);
+            m_liveDelaySamples[0]++;
+            m_liveDelaySamples[1]++;
         }
         else
         {
             // Independent feedback loop for each channel. 
-            for (int channel = 0; channel < 2; channel++)
+            for (int channel = 0; channel < numPaths; channel++)
             {
                 m_delayBuffers[channel].push(
                                     inputData[channel] + tempData[channel]);
+                m_liveDelaySamples[channel]++;
             }
         }
+
+        DSP_PROFILE_LAP(m_profiler, profileTime, bufferWrite);
         
+        // Just after a freeze is released, the rest of the loop fades out 
+        // under the delay output
+        const bool isFreezeTail = m_freezeTailPosition < m_freezeFadeSamples;
+        const float freezeTailGain = isFreezeTail 
+                ? 1.0f - static_cast<float>(m_freezeTailPosition + 1) 
+                            / static_cast<float>(m_freezeFadeSamples + 1)
+                : 0.0f;
+
         // Write output audio for each channel. Mix dry signal with wet signal             
         for (int channel = 0; channel < 2; channel++)
         {
+            int path = std::min(channel, numPaths - 1);
             auto* channelData = buffer.getWritePointer(channel);
-            channelData[sample] = (1.0f - m_mix) * inputData[channel] 
-                                            + m_mix * tempData[channel];
+            float wet = tempData[path];
+
+            if (isFreezeTail)
+            {
+                wet += freezeTailGain 
+                        * (m_freezeTails[path][m_freezeTailPosition] - wet);
+            }
+
+            channelData[sample] = (1.0f - m_mix) * inputData[path] 
+                                            + m_mix * wet;
         }
+
+        if (isFreezeTail)
+            m_freezeTailPosition++;
+
+        // At the end of the crossfade the new diffusers take over. 
+        // update() gives the old set's memory back to the pool.
+        if (isDiffuserFading() 
+                && ++m_diffuserFadePosition == m_diffuserFadeSamples)
+            m_activeDiffuserSet ^= 1;
+
+        m_smoothedDelayTime = currentDelayTimeSeconds * 1000.0f;
+
+        DSP_PROFILE_LAP(m_profiler, profileTime, mix);
     }
+
+    // The right path's feedback was the same as the left's. The bypass 
+    // fade can process a block in several calls, so this adds up.
+    m_feedbackSumSquares += numPaths == 1 ? 2.0f * feedbackSumSquares 
+                                          : feedbackSumSquares;
+
+    DSP_PROFILE_END_BLOCK(m_profiler);
 }
 
 
-// Clear the state of audio processing objects
-void DelayEffect::clear()
+// Get the number of bytes of sample memory held by the delay lines, 
+// diffusers and spectral rings (excludes small fixed-size state such as 
+// filter coefficients). Safe to call from any thread while processing.
+size_t DelayEffect::getMemoryUsageBytes() const
 {
-    for (int channel = 0; channel < 2; channel++)
+    size_t bytes = m_spectralLease.getCurrentBytes();
+
+    for (const auto& lease : m_delayLeases)
+        bytes += lease.getCurrentBytes();
+
+    for (const auto& lease : m_diffuserLeases)
+        bytes += lease.getCurrentBytes();
+
+    return bytes;
+}
+
+
+// Get the number of samples the output lags the input by, for the host's 
+// delay compensation. Only spectral mode adds latency, and it stays while 
+// bypassed (the dry signal is delayed to match), so bypassing never makes 
+// the host realign. Call after update().
+int DelayEffect::getLatencySamples() const
+{
+    return m_isSpectralOn ? m_spectralDelay.getLatencySamples() : 0;
+}
+
+
+/**
+ * Work out how long the output goes on after the input stops (and so how 
+ * long a bypass with trails plays for): until the echoes have fallen by 
+ * TAIL_DECAY_DB, with the diffusers' smearing and any latency on top. 
+ * Infinite while frozen. Reads the parameters from the APVTS rather than 
+ * this block's values, so it can be called from the message thread.
+ */
+double DelayEffect::getTailLengthSeconds(
+        const juce::AudioProcessorValueTreeState& apvts) const
+{
+    if (apvts.getRawParameterValue("IS_FREEZE_ON")->load() >= 0.5f)
+        return std::numeric_limits<double>::infinity();
+
+    const float delayTime = apvts.getRawParameterValue("DELAY_TIME")->load();
+    const float feedback = apvts.getRawParameterValue("FEEDBACK")->load();
+
+    if (apvts.getRawParameterValue("IS_SPECTRAL_ON")->load() >= 0.5f)
     {
-        m_delayBuffers[channel].clear();
-        m_loopFilters[channel].clear();
-        m_diffusers[channel].clear();
+        return m_spectralDelay.getTailSeconds(delayTime, feedback, 
+                    apvts.getRawParameterValue("SPECTRAL_DELAY_TILT")->load(),
+                    apvts.getRawParameterValue("SPECTRAL_FEEDBACK_TILT")->load(),
+                    TAIL_DECAY_DB)
+                + static_cast<double>(m_spectralDelay.getLatencySamples()) 
+                    / std::max(m_sampleRate, 1.0f);
     }
+
+    // The first echo, then enough repeats to fall by TAIL_DECAY_DB
+    const double delaySeconds = std::min(0.001f * delayTime, MAX_DELAY_SECONDS);
+    double numEchoes = 1.0;
+
+    if (feedback > 0.0f)
+        numEchoes += std::ceil(-TAIL_DECAY_DB / (20.0 * std::log10(feedback)));
+
+    double tailSeconds = numEchoes * delaySeconds;
+
+    // Diffusion smears the echoes out by roughly as long as its all-pass 
+    // stages take to ring down. That is added once, as an estimate.
+    if (apvts.getRawParameterValue("DIFFUSION")->load() > 0.0f)
+    {
+        const double size = apvts.getRawParameterValue("DIFFUSION_SIZE")->load();
+        double ringDownSeconds = 0.0;
+
+        for (size_t stage = 0; stage < std::size(DIFFUSER_LENGTHS); stage++)
+        {
+            ringDownSeconds += DIFFUSER_LENGTHS[stage] * size / 44100.0 
+                * std::ceil(-TAIL_DECAY_DB / (20.0 * std::log10(DIFFUSER_GAINS[stage])));
+        }
+
+        tailSeconds += ringDownSeconds;
+    }
+
+    return tailSeconds;
+}
+
+
+// Record update() and processAudioBuffer() activity into a trace ring, 
+// which must outlive this object. nullptr turns tracing off. Not while 
+// processing.
+void DelayEffect::setTraceRing(TraceRing* traceRing)
+{
+    m_traceRing = traceRing;
+}
+
+
+/**
+ * Get meter levels for the last processed block: the RMS of the feedback 
+ * signal and the range of the samples written into the delay lines. Audio 
+ * thread only (call straight after processAudioBuffer()). Doesn't lock or 
+ * allocate.
+ *
+ * @param numSamples    The number of samples in the last block.
+ */
+DelayEffect::BlockTelemetry DelayEffect::getBlockTelemetry(int numSamples) const
+{
+    BlockTelemetry telemetry{0.0f, 0.0f, 0.0f};
+
+    if (numSamples <= 0)
+        return telemetry;
+
+    telemetry.feedbackRms = std::sqrt(m_feedbackSumSquares 
+                                        / static_cast<float>(2 * numSamples));
+
+    // The most recent numSamples elements are the ones this block wrote. 
+    // A stale right channel holds nothing the left doesn't.
+    for (int channel = 0; channel < (m_isRightChannelStale ? 1 : 2); channel++)
+    {
+        const auto& delayBuffer = m_delayBuffers[channel];
+        size_t count = std::min(static_cast<size_t>(numSamples), 
+                                getLiveDelaySamples(channel));
+
+        for (size_t i = 0; i < count; i++)
+        {
+            float x = delayBuffer[i];
+            telemetry.delayLineMin = std::min(telemetry.delayLineMin, x);
+            telemetry.delayLineMax = std::max(telemetry.delayLineMax, x);
+        }
+    }
+
+    return telemetry;
+}
+
+
+// Get the delay line size in samples needed for a delay time in ms. 
+// Delay times past MAX_DELAY_SECONDS are capped.
+size_t DelayEffect::getDelayBufferSize(float delayTimeMs) const
+{
+    float delaySeconds = std::min(delayTimeMs * 0.001f, MAX_DELAY_SECONDS);
+    int delaySamples = static_cast<int>(std::ceil(delaySeconds * m_sampleRate));
+
+    // Buffer size must be at least (delaySamples + 1), plus room for the 
+    // freeze loop's crossfade. CircularBuffer also requires a size that's 
+    // a power of 2.
+    return static_cast<size_t>(juce::nextPowerOfTwo(
+                                    delaySamples + 1 + m_freezeFadeSamples));
+}
+
+
+// Point a delay line at its lease's current block. The pool hands out 
+// zeroed blocks, so there is nothing to clear, and all of it is live.
+void DelayEffect::attachDelayMemory(int channel)
+{
+    const auto& block = m_delayLeases[channel].getCurrentBlock();
+
+    m_delayBuffers[channel].setExternalStorage(
+            reinterpret_cast<DelayLineStorage*>(block.data), 
+            block.numBytes / sizeof(DelayLineStorage), false);
+    m_liveDelaySamples[channel] = m_delayBuffers[channel].getSize();
+}
+
+
+// Get the number of samples at the newest end of a delay line that can be 
+// read. Older ones are left over from before the last clear(), and read as 
+// silence.
+size_t DelayEffect::getLiveDelaySamples(int channel) const
+{
+    return std::min(m_liveDelaySamples[channel], 
+                    m_delayBuffers[channel].getSize());
+}
+
+
+// Request delay line memory for the delay range in use, and switch to any 
+// block the pool has published since the last call. Runs on the audio 
+// thread, so it never allocates: it only posts requests and swaps pointers.
+void DelayEffect::updateDelayMemory()
+{
+    // The frozen loop is found by its position in the delay lines, so they 
+    // keep their blocks (and any pending block waits) until the release, 
+    // or until a clear() (e.g. a bypass) has emptied the loop
+    if (m_isFreezeOn && m_freezeLoopLength > 0)
+        return;
+
+    // A bypassed delay (whose buffers were cleared once it had faded out) 
+    // needs no memory at all, and neither do the delay lines in spectral mode
+    size_t neededSize = isBypassSettled() || m_isSpectralOn ? 0 : getDelayBufferSize(
+                                std::max(m_delayTime, m_smoothedDelayTime)
+                                    * (m_isReverseOn ? 2.0f : 1.0f));
+
+    for (int channel = 0; channel < 2; channel++)
+    {
+        auto& lease = m_delayLeases[channel];
+        size_t currentSize = m_delayBuffers[channel].getSize();
+
+        // Grow as soon as the delay needs it, but only shrink once the 
+        // buffer is 4x too large, so small delay time moves don't cause a 
+        // stream of reallocations.
+        if (neededSize > currentSize || neededSize * 4 <= currentSize)
+            lease.request(neededSize * sizeof(DelayLineStorage));
+        else
+            lease.request(currentSize * sizeof(DelayLineStorage));
+
+        if (const auto* block = lease.getPendingBlock())
+        {
+            // Carry the most recent (live) audio over to the new block. The 
+            // rest of the block is zeroed, so all of it is live.
+            DelayLine incoming;
+            incoming.setStorageScale(DELAY_LINE_FIXED_SCALE);
+            incoming.setExternalStorage(
+                    reinterpret_cast<DelayLineStorage*>(block->data), 
+                    block->numBytes / sizeof(DelayLineStorage), false);
+
+            incoming.pushRecent(m_delayBuffers[channel], std::min(
+                        incoming.getSize(), getLiveDelaySamples(channel)));
+
+            m_delayBuffers[channel] = std::move(incoming);
+            m_liveDelaySamples[channel] = m_delayBuffers[channel].getSize();
+            lease.acceptPendingBlock();
+        }
+    }
+}
+
+
+// Point the spectral delay at its lease's current block (zeroed by the 
+// pool, like the delay lines' blocks)
+void DelayEffect::attachSpectralMemory()
+{
+    const auto& block = m_spectralLease.getCurrentBlock();
+
+    m_spectralDelay.setRingMemory(block.data, block.numBytes);
+}
+
+
+// Request ring memory for the spectral delay while it is on, and switch to 
+// any block the pool has published since the last call. Audio thread only; 
+// never allocates. The only switches are between no rings and rings of the
+// prepared size, so there is no audio to carry over.
+void DelayEffect::updateSpectralMemory()
+{
+    m_spectralLease.request(m_isSpectralOn && ! isBypassSettled() 
+                                ? m_spectralDelay.getRingBytes() : 0);
+
+    if (m_spectralLease.getPendingBlock() != nullptr)
+    {
+        m_spectralLease.acceptPendingBlock();
+        attachSpectralMemory();
+    }
+}
+
+
+// Get the bytes of ring memory one diffuser set (both channels) needs at 
+// a diffuser size, at the prepared sample rate
+size_t DelayEffect::getDiffuserRingBytes(float size) const
+{
+    size_t bytes = 0;
+
+    for (const auto& diffuser : m_diffuserSets[0])
+        bytes += diffuser.getRingBytes(m_sampleRate, size);
+
+    return bytes;
+}
+
+
+// Lay a diffuser set out for a size in its lease's current block, which 
+// must hold getDiffuserRingBytes(size). Never allocates.
+void DelayEffect::layOutDiffuserSet(int set, float size)
+{
+    std::byte* memory = m_diffuserLeases[set].getCurrentBlock().data;
+
+    for (auto& diffuser : m_diffuserSets[set])
+    {
+        diffuser.setLayout(m_sampleRate, size, reinterpret_cast<float*>(memory));
+        memory += diffuser.getRingBytes(m_sampleRate, size);
+    }
+
+    m_diffuserSetSizes[set] = size;
+}
+
+
+/**
+ * Move the diffusers towards the diffuser size parameter. Audio thread 
+ * only; never allocates. When the size changes, the idle set's lease asks 
+ * the pool for a block, and once the service thread has published it the 
+ * idle set is laid out in it at the new size and the crossfade to it 
+ * starts. After the crossfade, the set that was replaced asks for nothing, 
+ * which hands its block back to the service thread to free.
+ */
+void DelayEffect::updateDiffuserMemory()
+{
+    // The incoming set's memory is in use until the crossfade ends
+    if (isDiffuserFading())
+        return;
+
+    const int idleSet = m_activeDiffuserSet ^ 1;
+    auto& lease = m_diffuserLeases[idleSet];
+
+    const bool isResizeNeeded = 
+                    m_diffusionSize != m_diffuserSetSizes[m_activeDiffuserSet];
+    const size_t neededBytes = isResizeNeeded 
+                                ? getDiffuserRingBytes(m_diffusionSize) : 0;
+
+    lease.request(neededBytes);
+
+    // Nothing reads the idle set's memory, so there is nothing to carry 
+    // over. A block that turns out too small (the size moved on since it 
+    // was asked for) is used for nothing, and the next one is waited for.
+    if (lease.getPendingBlock() != nullptr)
+        lease.acceptPendingBlock();
+
+    if (isResizeNeeded && lease.getCurrentBlock().numBytes >= neededBytes)
+    {
+        if (m_traceRing != nullptr)
+        {
+            // Size in percent
+            m_traceRing->record("diffuser resized", TraceRing::Phase::instant, 
+                                std::lround(m_diffusionSize * 100.0f));
+        }
+
+        layOutDiffuserSet(idleSet, m_diffusionSize);
+        m_diffuserFadePosition = 0;
+    }
+}
+
+
+// Whether the diffuser output is crossfading to the other diffuser set
+bool DelayEffect::isDiffuserFading() const
+{
+    return m_diffuserFadePosition < m_diffuserFadeSamples;
+}
+
+
+// Start looping the last delay time's worth of the delay lines. Both 
+// channels loop the same span. A stale right channel hasn't been written 
+// since the channels started sharing a path, and its loop is the left's.
+void DelayEffect::startFreeze()
+{
+    int size = static_cast<int>(m_isRightChannelStale 
+                                    ? getLiveDelaySamples(0)
+                                    : std::min(getLiveDelaySamples(0), 
+                                               getLiveDelaySamples(1)));
+
+    // No delay memory yet (or nothing written since a clear), so nothing 
+    // to loop (processAudioBuffer() only outputs the dry signal then)
+    if (size < 2)
+    {
+        m_freezeLoopLength = 0;
+        return;
+    }
+
+    // The first sample of the loop is the one the delay would have read 
+    // next, so the wet signal carries straight on
+    int delaySamples = static_cast<int>(
+                        m_smoothedDelayTime * 0.001f * m_sampleRate);
+
+    m_freezeLoopLength = std::clamp(delaySamples, 1, size - 1);
+    m_freezePosition = 0;
+
+    // The end of the loop fades into the audio just before its start, 
+    // which has to still be in the delay lines
+    m_freezeLoopFadeLength = std::min({m_freezeFadeSamples, 
+                                       m_freezeLoopLength / 2, 
+                                       size - 1 - m_freezeLoopLength});
+    m_freezeLoopFadeStep = 1.0f / static_cast<float>(m_freezeLoopFadeLength + 1);
+}
+
+
+// Stop looping. The delay lines pick up from where they were frozen, and 
+// the next few ms of the loop are kept to fade out over the restart.
+void DelayEffect::releaseFreeze()
+{
+    if (m_freezeLoopLength == 0)
+        return;
+
+    for (int channel = 0; channel < 2; channel++)
+    {
+        // A stale right channel's loop is the left's
+        int source = m_isRightChannelStale ? 0 : channel;
+        int position = m_freezePosition;
+
+        for (float& sample : m_freezeTails[channel])
+        {
+            sample = m_feedback * getFrozenSample(source, position);
+
+            if (++position == m_freezeLoopLength)
+                position = 0;
+        }
+    }
+
+    m_freezeTailPosition = 0;
+    m_freezeLoopLength = 0;
+}
+
+
+// Get the frozen loop's sample at a position in the loop (0 is the oldest)
+float DelayEffect::getFrozenSample(int channel, int position) const
+{
+    const auto& delayBuffer = m_delayBuffers[channel];
+    size_t index = static_cast<size_t>(m_freezeLoopLength - position);
+    float x = delayBuffer[index];
+
+    // Crossfade into the samples that came just before the loop's start, 
+    // so the end meets the start without a step
+    int fadePosition = position - (m_freezeLoopLength - m_freezeLoopFadeLength);
+
+    if (fadePosition >= 0)
+    {
+        float t = static_cast<float>(fadePosition + 1) * m_freezeLoopFadeStep;
+        x += t * (delayBuffer[index + m_freezeLoopLength] - x);
+    }
+
+    return x;
+}
+
+
+// Process a block while frozen: the loop (scaled by the feedback amount, 
+// as the delay output is) is the wet signal, and nothing is written to the 
+// delay lines
+void DelayEffect::processFrozen(juce::AudioBuffer<float>& buffer)
+{
+    const int numPaths = m_isRightChannelStale ? 1 : 2;
+    float feedbackSumSquares = 0.0f;
+
+    if (m_freezeLoopLength == 0)
+    {
+        buffer.applyGain(1.0f - m_mix);
+        return;
+    }
+
+    for (int sample = 0; sample < buffer.getNumSamples(); sample++)
+    {
+        // Keep the delay time smoothing running, so the release picks up 
+        // at the delay time the knob is at now
+        m_smoothedDelayTime = m_delayTimeLowPass.getNextSample(m_delayTime);
+
+        float wet[2];
+
+        for (int channel = 0; channel < numPaths; channel++)
+        {
+            wet[channel] = m_feedback * getFrozenSample(channel, 
+                                                        m_freezePosition);
+            feedbackSumSquares += wet[channel] * wet[channel];
+        }
+
+        if (++m_freezePosition == m_freezeLoopLength)
+            m_freezePosition = 0;
+
+        for (int channel = 0; channel < 2; channel++)
+        {
+            auto* channelData = buffer.getWritePointer(channel);
+            channelData[sample] = (1.0f - m_mix) * channelData[sample] 
+                                    + m_mix * wet[std::min(channel, numPaths - 1)];
+        }
+    }
+
+    m_feedbackSumSquares += numPaths == 1 ? 2.0f * feedbackSumSquares 
+                                          : feedbackSumSquares;
+}
+
+
+// Stop both reverse voices. The next segment starts straight away.
+void DelayEffect::resetReverse()
+{
+    for (auto& voice : m_reverseVoices)
+        voice.length = 0;
+
+    m_nextReverseVoice = 0;
+    m_reverseSamplesUntilSegment = 0;
+}
+
+
+/**
+ * Work out the reversed delay output (before the feedback gain) for the 
+ * next samples into m_reverseChunk, starting a new segment first if one is 
+ * due. A chunk never crosses the start of a segment, so everything it 
+ * reads was written before the chunk begins. Returns the number of samples 
+ * worked out, between 1 and maxSamples.
+ */
+int DelayEffect::fillReverseChunk(int numPaths, int maxSamples)
+{
+    if (m_reverseSamplesUntilSegment == 0)
+    {
+        // Segments are one delay time long and start every half delay time
+        int delaySamples = static_cast<int>(
+                            m_smoothedDelayTime * 0.001f * m_sampleRate);
+        const double TWO_PI = 6.283185307179586;
+        int halfLength = std::max(delaySamples / 2, 1);
+        double step = TWO_PI / static_cast<double>(2 * halfLength);
+
+        auto& voice = m_reverseVoices[m_nextReverseVoice];
+        voice.position = 0;
+        voice.length = 2 * halfLength;
+        voice.windowCos = 1.0;
+        voice.windowSin = 0.0;
+        voice.stepCos = std::cos(step);
+        voice.stepSin = std::sin(step);
+
+        m_nextReverseVoice ^= 1;
+        m_reverseSamplesUntilSegment = halfLength;
+    }
+
+    const int n = std::min({maxSamples, REVERSE_CHUNK_SIZE, 
+                            m_reverseSamplesUntilSegment});
+
+    for (int channel = 0; channel < numPaths; channel++)
+        std::fill_n(m_reverseChunk[channel].begin(), n, 0.0f);
+
+    for (auto& voice : m_reverseVoices)
+    {
+        int count = std::min(n, voice.length - voice.position);
+
+        if (count <= 0)
+            continue;
+
+        // sin^2(pi position / length), by rotating (cos, sin) of twice 
+        // the angle a sample at a time
+        float window[REVERSE_CHUNK_SIZE];
+
+        for (int i = 0; i < count; i++)
+        {
+            window[i] = static_cast<float>(0.5 - 0.5 * voice.windowCos);
+
+            double nextCos = voice.windowCos * voice.stepCos 
+                                - voice.windowSin * voice.stepSin;
+            voice.windowSin = voice.windowSin * voice.stepCos 
+                                + voice.windowCos * voice.stepSin;
+            voice.windowCos = nextCos;
+        }
+
+        // A segment started s samples ago reads the sample pushed 2s ago
+        // (the line has moved s forwards and the voice s backwards). 
+        // Relative to the start of this chunk that is a contiguous run.
+        size_t firstIndex = 2 * static_cast<size_t>(voice.position);
+
+        for (int channel = 0; channel < numPaths; channel++)
+        {
+            float reversed[REVERSE_CHUNK_SIZE];
+            readReversed(channel, firstIndex, reversed, count);
+
+            for (int i = 0; i < count; i++)
+                m_reverseChunk[channel][i] += window[i] * reversed[i];
+        }
+
+        voice.position += count;
+    }
+
+    m_reverseSamplesUntilSegment -= n;
+    return n;
+}
+
+
+// Copy delay line elements firstIndex, firstIndex + 1, ... (operator[] 
+// indexing, so going back in time) into dest with one block read. Anything 
+// past the end of the delay line, or from before the last clear(), reads 
+// as silence.
+void DelayEffect::readReversed(int channel, size_t firstIndex, float* dest, 
+                                int n) const
+{
+    const auto& delayBuffer = m_delayBuffers[channel];
+    size_t size = delayBuffer.getSize();
+    size_t live = getLiveDelaySamples(channel);
+    size_t count = firstIndex < live 
+                    ? std::min(static_cast<size_t>(n), live - firstIndex) : 0;
+
+    if (count > 0)
+    {
+        delayBuffer.readBlock(size - firstIndex - count, dest, count);
+        std::reverse(dest, dest + count);
+    }
+
+    std::fill(dest + count, dest + n, 0.0f);
+}
+
+
+// Clear the state of audio processing objects. The delay lines and the 
+// spectral rings can be megabytes at high sample rates, too much to zero 
+// in one block, so their contents are only marked stale and read as 
+// silence until they have been overwritten. shouldKeepSpectralInput keeps 
+// the last FFT length of the spectral delay's input, for the dry signal.
+void DelayEffect::clear(bool shouldKeepSpectralInput)
+{
+    TraceScope trace(m_traceRing, "clear");
+
+    for (int channel = 0; channel < 2; channel++)
+    {
+        m_liveDelaySamples[channel] = 0;
+        m_loopFilters[channel].clear();
+        m_svfLoopFilters[channel].clear();
+        m_saturators[channel].clear();
+    }
+
+    // Both diffuser sets would start from silence, so a crossfade between 
+    // them is pointless and the new set takes over straight away
+    if (isDiffuserFading())
+    {
+        m_activeDiffuserSet ^= 1;
+        m_diffuserFadePosition = m_diffuserFadeSamples;
+    }
+
+    for (auto& diffuser : m_diffuserSets[m_activeDiffuserSet])
+        diffuser.clear();
+
+    if (shouldKeepSpectralInput)
+        m_spectralDelay.clearWet();
+    else
+        m_spectralDelay.clear();
+
+    // A frozen loop is cleared with the delay lines
+    m_freezeLoopLength = 0;
+    m_freezeTailPosition = m_freezeFadeSamples;
+    resetReverse();
+
+    m_areChannelsInSync = true;
+    m_isRightChannelStale = false;
+    m_syncCheckAge = -1;
+}
+
+
+// Decide how many processing paths this block needs. Dual-mono input (both 
+// channels bit-identical) with ping pong off gives the same wet signal on 
+// both channels as long as both channels' state is identical too, so only 
+// the left path is run. Returns 1 or 2.
+int DelayEffect::selectNumPaths(const juce::AudioBuffer<float>& buffer)
+{
+    const int numSamples = buffer.getNumSamples();
+
+    bool isDualMono = ! m_isPingPongOn && std::memcmp(buffer.getReadPointer(0), 
+                                                      buffer.getReadPointer(1), 
+                                                      numSamples * sizeof(float)) == 0;
+
+    // Once the channels have differed they can only share a path again if 
+    // their state has become identical (in practice, after silence has let 
+    // every tail decay to zero). Checking reads all of it, so not too often, 
+    // and a little at a time.
+    if (isDualMono && ! m_areChannelsInSync)
+    {
+        m_samplesUntilSyncCheck -= numSamples;
+
+        if (m_samplesUntilSyncCheck <= 0 && m_syncCheckAge < 0)
+        {
+            m_samplesUntilSyncCheck = static_cast<int>(
+                                    m_sampleRate * SYNC_CHECK_INTERVAL_SECONDS);
+            m_syncCheckAge = static_cast<int>(getLiveDelaySamples(0)) - 1;
+        }
+
+        if (m_syncCheckAge >= 0)
+            m_areChannelsInSync = continueSyncCheck(numSamples);
+    }
+
+    if (isDualMono && m_areChannelsInSync)
+    {
+        if (! m_isRightChannelStale && m_traceRing != nullptr)
+            m_traceRing->record("channels shared", TraceRing::Phase::instant, 1);
+
+        m_isRightChannelStale = true;
+        return 1;
+    }
+
+    // The right channel is about to run again, so bring it up to date
+    if (m_isRightChannelStale)
+    {
+        if (m_traceRing != nullptr)
+            m_traceRing->record("channels shared", TraceRing::Phase::instant, 0);
+
+        copyLeftChannelState();
+        m_isRightChannelStale = false;
+    }
+
+    if (! isDualMono)
+    {
+        m_areChannelsInSync = false;
+        m_syncCheckAge = -1;
+    }
+
+    return 2;
+}
+
+
+// Make the right channel's state a copy of the left's. Doesn't allocate.
+void DelayEffect::copyLeftChannelState()
+{
+    auto& left = m_delayBuffers[0];
+    auto& right = m_delayBuffers[1];
+
+    // Past the end of the left buffer's live samples counts as silence, so 
+    // the rest of the right buffer goes stale
+    size_t count = std::min(getLiveDelaySamples(0), right.getSize());
+
+    right.pushRecent(left, count);
+    m_liveDelaySamples[1] = count;
+
+    m_loopFilters[1] = m_loopFilters[0];
+    m_svfLoopFilters[1] = m_svfLoopFilters[0];
+
+    // Both diffuser sets run during a crossfade
+    for (int set = 0; set < 2; set++)
+    {
+        if (set == m_activeDiffuserSet || isDiffuserFading())
+            m_diffuserSets[set][1].copyStateFrom(m_diffuserSets[set][0]);
+    }
+
+    m_saturators[1] = m_saturators[0];
+}
+
+
+/**
+ * Take the next step of checking whether both channels' state is 
+ * bit-identical, so that they would give the same output for the same 
+ * input. Each step compares the next SYNC_CHECK_RATE * numSamples delay 
+ * line samples of both channels, oldest first. A sample never changes once 
+ * it is in a delay line, so samples found equal stay equal while the check 
+ * carries on over later blocks (as long as both channels get the same 
+ * input). Once it reaches the newest samples, the rest of the state is 
+ * compared.
+ *
+ * @param numSamples    The number of samples in this block, which will be 
+ *                      pushed after the step.
+ *
+ * @return  true once the whole state has been found equal. false if it 
+ *          differs, or the check isn't finished.
+ */
+bool DelayEffect::continueSyncCheck(int numSamples)
+{
+    const auto& left = m_delayBuffers[0];
+    const auto& right = m_delayBuffers[1];
+    const size_t size = left.getSize();
+
+    // The delay lines have been swapped or cleared since the check 
+    // started. Stale samples read as silence, so only live ones are 
+    // compared, and both channels must have the same number of those.
+    const size_t live = getLiveDelaySamples(0);
+
+    if (right.getSize() != size || getLiveDelaySamples(1) != live 
+            || static_cast<size_t>(m_syncCheckAge) >= live)
+    {
+        m_syncCheckAge = -1;
+        return false;
+    }
+
+    // Compare ages m_syncCheckAge down to lastAge, a chunk at a time. Age a 
+    // is element size - 1 - a in readBlock() order.
+    const int lastAge = std::max(
+                        m_syncCheckAge - SYNC_CHECK_RATE * numSamples + 1, 0);
+    constexpr int chunkSize = 256;
+    float leftChunk[chunkSize];
+    float rightChunk[chunkSize];
+
+    for (int age = m_syncCheckAge; age >= lastAge; age -= chunkSize)
+    {
+        int count = std::min(chunkSize, age - lastAge + 1);
+        size_t first = size - 1 - static_cast<size_t>(age);
+
+        left.readBlock(first, leftChunk, static_cast<size_t>(count));
+        right.readBlock(first, rightChunk, static_cast<size_t>(count));
+
+        if (std::memcmp(leftChunk, rightChunk, count * sizeof(float)) != 0)
+        {
+            m_syncCheckAge = -1;
+            return false;
+        }
+    }
+
+    // Not at the newest samples yet. This block's samples are pushed before 
+    // the next step, which ages the rest by numSamples.
+    if (lastAge > 0)
+    {
+        m_syncCheckAge = std::min(lastAge - 1 + numSamples, 
+                                  static_cast<int>(live) - 1);
+        return false;
+    }
+
+    m_syncCheckAge = -1;
+
+    if (! m_loopFilters[0].hasSameStateAs(m_loopFilters[1]) 
+            || ! m_svfLoopFilters[0].hasSameStateAs(m_svfLoopFilters[1])
+            || ! m_saturators[0].hasSameStateAs(m_saturators[1]))
+        return false;
+
+    for (int set = 0; set < 2; set++)
+    {
+        const auto& diffusers = m_diffuserSets[set];
+
+        if ((set == m_activeDiffuserSet || isDiffuserFading()) 
+                && ! diffusers[0].hasSameStateAs(diffusers[1]))
+            return false;
+    }
+
+    return true;
 }
@@ -0,0 +1,145 @@
+///
+///     @file MirroredMemory.cpp
+///     @brief Double-mapped ("mirrored") virtual memory region.
+///     @date October 18, 2026
+///
+
+#include "DelayPlugin/DSP/MirroredMemory.h"
+#include <utility>
+
+#if defined(__linux__)
+    #include <sys/mman.h>
+    #include <unistd.h>
+    #define DELAY_PLUGIN_HAS_MIRRORED_MEMORY 1
+#else
+    #define DELAY_PLUGIN_HAS_MIRRORED_MEMORY 0
+#endif
+
+
+MirroredMemory::MirroredMemory() : m_data{nullptr}, m_size{0}
+{
+}
+
+
+MirroredMemory::~MirroredMemory()
+{
+    release();
+}
+
+
+MirroredMemory::MirroredMemory(MirroredMemory&& other) noexcept
+    : m_data{std::exchange(other.m_data, nullptr)},
+      m_size{std::exchange(other.m_size, 0)}
+{
+}
+
+
+MirroredMemory& MirroredMemory::operator=(MirroredMemory&& other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+    }
+
+    return *this;
+}
+
+
+/**
+ * Map a region of numBytes twice, back to back. Any previous mapping is
+ * released first.
+ *
+ * @param numBytes  Size of one copy of the region. Must be a non-zero
+ *                  multiple of the page size.
+ *
+ * @return          true if the mirrored mapping was created, false if
+ *                  mirroring is unsupported or the mapping failed.
+ */
+bool MirroredMemory::allocate(std::size_t numBytes)
+{
+    release();
+
+    if (! canMirror(numBytes))
+        return false;
+
+#if DELAY_PLUGIN_HAS_MIRRORED_MEMORY
+    int fd = memfd_create("DelayPluginRing", MFD_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    if (ftruncate(fd, static_cast<off_t>(numBytes)) != 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    // Reserve address space for both copies, then map the file over each
+    // half so that the two halves alias the same physical pages.
+    void* reserved = mmap(nullptr, 2 * numBytes, PROT_NONE,
+                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (reserved == MAP_FAILED)
+    {
+        close(fd);
+        return false;
+    }
+
+    auto* base = static_cast<char*>(reserved);
+
+    void* first = mmap(base, numBytes, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_FIXED, fd, 0);
+    void* second = mmap(base + numBytes, numBytes, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_FIXED, fd, 0);
+
+    // The mappings keep the memory alive, so the descriptor is not needed
+    close(fd);
+
+    if (first != base || second != base + numBytes)
+    {
+        munmap(reserved, 2 * numBytes);
+        return false;
+    }
+
+    m_data = reserved;
+    m_size = numBytes;
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+// Unmap the region (if any)
+void MirroredMemory::release()
+{
+#if DELAY_PLUGIN_HAS_MIRRORED_MEMORY
+    if (m_data != nullptr)
+        munmap(m_data, 2 * m_size);
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+}
+
+
+// Return the virtual memory page size, or 0 if mirroring is unsupported
+std::size_t MirroredMemory::getPageSize()
+{
+#if DELAY_PLUGIN_HAS_MIRRORED_MEMORY
+    static const std::size_t pageSize = static_cast<std::size_t>(
+                                                sysconf(_SC_PAGESIZE));
+    return pageSize;
+#else
+    return 0;
+#endif
+}
+
+
+// Return true if a region of numBytes can be mirrored on this platform
+bool MirroredMemory::canMirror(std::size_t numBytes)
+{
+    std::size_t pageSize = getPageSize();
+
+    return pageSize != 0 && numBytes != 0 && numBytes % pageSize == 0;
+}
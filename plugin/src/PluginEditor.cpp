@@ -42,6 +42,43 @@ RasterComponent::RasterComponent (AudioPluginAudioProcessor& p)
     bypassLabel.setText("Bypass", juce::dontSendNotification);
     addAndMakeVisible(bypassLabel);
 
+    addAndMakeVisible(trailsToggleButton);
+    trailsToggleButtonAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(apvts,
+        "BYPASS_TRAILS", trailsToggleButton);
+
+    trailsLabel.setText("Trails", juce::dontSendNotification);
+    addAndMakeVisible(trailsLabel);
+
+    addAndMakeVisible(reverseToggleButton);
+    reverseToggleButtonAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(apvts,
+        "IS_REVERSE_ON", reverseToggleButton);
+
+    reverseLabel.setText("Reverse", juce::dontSendNotification);
+    addAndMakeVisible(reverseLabel);
+
+    addAndMakeVisible(freezeToggleButton);
+    freezeToggleButtonAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(apvts,
+        "IS_FREEZE_ON", freezeToggleButton);
+
+    freezeLabel.setText("Freeze", juce::dontSendNotification);
+    addAndMakeVisible(freezeLabel);
+
+    // Spectral mode
+    addAndMakeVisible(spectralToggleButton);
+    spectralToggleButtonAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(apvts,
+        "IS_SPECTRAL_ON", spectralToggleButton);
+
+    spectralLabel.setText("Spectral", juce::dontSendNotification);
+    addAndMakeVisible(spectralLabel);
+
+    createSliderAndLabel(&spectralDelayTiltSlider, &spectralDelayTiltLabel, "Delay Tilt", customLookAndFeel);
+    spectralDelayTiltSliderAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts,
+        "SPECTRAL_DELAY_TILT", spectralDelayTiltSlider);
+
+    createSliderAndLabel(&spectralFeedbackTiltSlider, &spectralFeedbackTiltLabel, "Fb Tilt", customLookAndFeel);
+    spectralFeedbackTiltSliderAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts,
+        "SPECTRAL_FEEDBACK_TILT", spectralFeedbackTiltSlider);
+
     // Cutoff
     createSliderAndLabel(&loopFilterCutoffSlider, &loopFilterCutoffLabel, "Filter Cutoff", customLookAndFeel);
     loopFilterCutoffSliderAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts,
@@ -55,14 +92,82 @@ RasterComponent::RasterComponent (AudioPluginAudioProcessor& p)
     const auto* parameter = apvts.getParameter("LOOP_FILTER_TYPE");
     loopFilterTypeComboBox.addItemList(parameter->getAllValueStrings(), 1);
 
+    // Resonance
+    createSliderAndLabel(&loopFilterResonanceSlider, &loopFilterResonanceLabel, "Resonance", customLookAndFeel);
+    loopFilterResonanceSliderAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts,
+        "LOOP_FILTER_RESONANCE", loopFilterResonanceSlider);
+
     // Diffusion slider
     createSliderAndLabel(&diffusionSlider, &diffusionLabel, "Diffusion", customLookAndFeel);
     diffusionSliderAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts,
         "DIFFUSION", diffusionSlider);
+
+    // Diffusion size slider
+    createSliderAndLabel(&diffusionSizeSlider, &diffusionSizeLabel, "Size", customLookAndFeel);
+    diffusionSizeSliderAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts,
+        "DIFFUSION_SIZE", diffusionSizeSlider);
+
+    // Saturation type
+    addAndMakeVisible(saturationTypeComboBox);
+    saturationTypeComboBoxAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(apvts,
+        "SATURATION_TYPE", saturationTypeComboBox);
+    saturationTypeComboBox.addItemList(apvts.getParameter("SATURATION_TYPE")->getAllValueStrings(), 1);
+
+    saturationLabel.setText("Saturation", juce::dontSendNotification);
+    addAndMakeVisible(saturationLabel);
+
+    // Saturation drive
+    createSliderAndLabel(&saturationDriveSlider, &saturationDriveLabel, "Drive", customLookAndFeel);
+    saturationDriveSliderAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts,
+        "SATURATION_DRIVE", saturationDriveSlider);
+
+    // CPU load readout
+    loadLabel.setJustificationType(juce::Justification::centredRight);
+    addAndMakeVisible(loadLabel);
+
+    // Meters and scope. The processor only publishes levels while an 
+    // editor is open; anything left over from a previous editor is stale.
+    addAndMakeVisible(inputMeter);
+    addAndMakeVisible(outputMeter);
+    addAndMakeVisible(feedbackMeter);
+    addAndMakeVisible(delayScope);
+
+    processorRef.getTelemetryQueue().discardAll();
+    processorRef.setTelemetryEnabled(true);
+
+    // Display rate. The load readout is refreshed less often.
+    startTimerHz(30);
 }
 
 RasterComponent::~RasterComponent()
-= default;
+{
+    processorRef.setTelemetryEnabled(false);
+}
+
+void RasterComponent::timerCallback()
+{
+    drainTelemetry();
+
+    constexpr int loadUpdateTicks = 8;
+
+    if (++timerTicksSinceLoadUpdate < loadUpdateTicks)
+        return;
+
+    timerTicksSinceLoadUpdate = 0;
+
+    const auto stats = processorRef.getLoadStatistics();
+
+    loadLabel.setText(juce::String::formatted("CPU %d%%  p99 %d%%  over %llu",
+                                              juce::roundToInt(stats.load * 100.0),
+                                              juce::roundToInt(stats.p99Load * 100.0),
+                                              static_cast<unsigned long long>(stats.numOverruns)),
+                      juce::dontSendNotification);
+
+    // Warn once the slow blocks are getting close to the deadline
+    const bool isNearDeadline = stats.p99Load > 0.5 || stats.numOverruns > 0;
+    loadLabel.setColour(juce::Label::textColourId,
+                        isNearDeadline ? juce::Colours::red : juce::Colours::white);
+}
 
 //==============================================================================
 void RasterComponent::paint (juce::Graphics& g)
@@ -91,6 +196,12 @@ void RasterComponent::resized() {
         sliderWidth, sliderHeight,
         labelHeight, "Diffusion");
 
+    placeSliderWithLabel(&diffusionSizeSlider, &diffusionSizeLabel,
+        getWidth() / 2 - sliderWidth / 2,
+        getHeight() / 3 + 45,
+        sliderWidth, sliderHeight,
+        labelHeight, "Size");
+
     placeSliderWithLabel(&delayTimeSlider, &delayTimeLabel,
         static_cast<int>(getWidth() * 0.75 - sliderWidth / 2),
         getHeight() / 2 + 50,
@@ -110,6 +221,12 @@ void RasterComponent::resized() {
                          sliderWidth, sliderHeight,
                          labelHeight, "Cutoff");
 
+    placeSliderWithLabel(&loopFilterResonanceSlider, &loopFilterResonanceLabel,
+                         getWidth() / 6 - sliderWidth / 2,
+                         getHeight() / 6 + 120,
+                         sliderWidth, sliderHeight,
+                         labelHeight, "Resonance");
+
     constexpr int toggleWidth = 60;
     constexpr int toggleHeight = 20;
 
@@ -120,9 +237,26 @@ void RasterComponent::resized() {
 
 
 
+    // Wide enough for the SVF type names
+    constexpr int filterTypeWidth = 110;
+
     loopFilterTypeComboBox.setBounds(getWidth() / 6 - sliderWidth / 2,
                                      getHeight() / 6 + 90,
-                                     toggleWidth, toggleHeight);
+                                     filterTypeWidth, toggleHeight);
+
+    saturationLabel.setBounds(getWidth() * 5 / 6 - sliderWidth / 2,
+                              getHeight() / 6 + 70,
+                              filterTypeWidth, labelHeight);
+
+    saturationTypeComboBox.setBounds(getWidth() * 5 / 6 - sliderWidth / 2,
+                                     getHeight() / 6 + 90,
+                                     filterTypeWidth, toggleHeight);
+
+    placeSliderWithLabel(&saturationDriveSlider, &saturationDriveLabel,
+                         getWidth() * 5 / 6 - sliderWidth / 2,
+                         getHeight() / 6 + 120,
+                         sliderWidth, sliderHeight,
+                         labelHeight, "Drive");
 
     pingPongToggleButton.setBounds(pingPongLabelX,
                                    pingPongButtonY,
@@ -139,7 +273,99 @@ void RasterComponent::resized() {
                           static_cast<int>(getHeight() * 0.9) - 20,
                           labelWidth, labelHeight);
 
+    // Trails sit between bypass and spectral
+    trailsToggleButton.setBounds(static_cast<int>(getWidth() * 0.5),
+                                 static_cast<int>(getHeight() * 0.9),
+                                 toggleWidth, toggleHeight);
+
+    trailsLabel.setBounds(static_cast<int>(getWidth() * 0.5),
+                          static_cast<int>(getHeight() * 0.9) - 20,
+                          labelWidth, labelHeight);
+
+    reverseToggleButton.setBounds(static_cast<int>(getWidth() * 0.5 + 3 * toggleWidth),
+                                  static_cast<int>(getHeight() * 0.9),
+                                  toggleWidth, toggleHeight);
+
+    reverseLabel.setBounds(static_cast<int>(getWidth() * 0.5 + 3 * toggleWidth),
+                           static_cast<int>(getHeight() * 0.9) - 20,
+                           labelWidth, labelHeight);
+
+    freezeToggleButton.setBounds(static_cast<int>(getWidth() * 0.5 - 3 * toggleWidth),
+                                 static_cast<int>(getHeight() * 0.9),
+                                 toggleWidth, toggleHeight);
+
+    freezeLabel.setBounds(static_cast<int>(getWidth() * 0.5 - 3 * toggleWidth),
+                          static_cast<int>(getHeight() * 0.9) - 20,
+                          labelWidth, labelHeight);
+
+    spectralToggleButton.setBounds(static_cast<int>(getWidth() * 0.5 + toggleWidth),
+                                   static_cast<int>(getHeight() * 0.9),
+                                   toggleWidth, toggleHeight);
+
+    spectralLabel.setBounds(static_cast<int>(getWidth() * 0.5 + toggleWidth),
+                            static_cast<int>(getHeight() * 0.9) - 20,
+                            labelWidth, labelHeight);
+
+    placeSliderWithLabel(&spectralDelayTiltSlider, &spectralDelayTiltLabel,
+                         getWidth() / 3 - sliderWidth / 2,
+                         getHeight() / 3 - sliderHeight + 25,
+                         sliderWidth, sliderHeight,
+                         labelHeight, "Delay Tilt");
+
+    placeSliderWithLabel(&spectralFeedbackTiltSlider, &spectralFeedbackTiltLabel,
+                         getWidth() * 2 / 3 - sliderWidth / 2,
+                         getHeight() / 3 - sliderHeight + 25,
+                         sliderWidth, sliderHeight,
+                         labelHeight, "Fb Tilt");
+
+    loadLabel.setBounds(getWidth() - 260, getHeight() - 25, 250, labelHeight + 5);
+
+    constexpr int meterWidth = 28;
+    constexpr int meterHeight = 110;
+    constexpr int meterX = 30;
+    const int meterY = getHeight() - meterHeight - 20;
+
+    inputMeter.setBounds(meterX, meterY, meterWidth, meterHeight);
+    outputMeter.setBounds(meterX + meterWidth, meterY, meterWidth, meterHeight);
+    feedbackMeter.setBounds(meterX + 2 * meterWidth, meterY, meterWidth, meterHeight);
+
+    delayScope.setBounds(getWidth() / 2 - 150, 20, 300, 80);
+}
+
+// Take everything the audio thread has published since the last tick and 
+// pass it on to the meters and scope
+void RasterComponent::drainTelemetry()
+{
+    auto& queue = processorRef.getTelemetryQueue();
+    TelemetryFrame frame;
+
+    float inputPeak = 0.0f, outputPeak = 0.0f, feedbackPeak = 0.0f;
+    float inputSumSquares = 0.0f, outputSumSquares = 0.0f, feedbackSumSquares = 0.0f;
+    int numSamples = 0;
+
+    while (queue.pop(frame))
+    {
+        inputPeak = juce::jmax(inputPeak, frame.inputPeak);
+        outputPeak = juce::jmax(outputPeak, frame.outputPeak);
+        feedbackPeak = juce::jmax(feedbackPeak, frame.feedbackRms);
+
+        // Weight each block's RMS by its length
+        inputSumSquares += frame.inputRms * frame.inputRms * frame.numSamples;
+        outputSumSquares += frame.outputRms * frame.outputRms * frame.numSamples;
+        feedbackSumSquares += frame.feedbackRms * frame.feedbackRms * frame.numSamples;
+        numSamples += frame.numSamples;
+
+        delayScope.addBlock(frame.delayLineMin, frame.delayLineMax, frame.numSamples,
+                            frame.sampleRate, frame.delayTimeMs);
+    }
+
+    const float scale = numSamples > 0 ? 1.0f / static_cast<float>(numSamples) : 0.0f;
+
+    inputMeter.setLevels(inputPeak, std::sqrt(inputSumSquares * scale));
+    outputMeter.setLevels(outputPeak, std::sqrt(outputSumSquares * scale));
+    feedbackMeter.setLevels(feedbackPeak, std::sqrt(feedbackSumSquares * scale));
 
+    delayScope.repaintDirtyArea();
 }
 
 // Wrapper Implementation
@@ -17,10 +17,14 @@ AudioPluginAudioProcessor::AudioPluginAudioProcessor()
                      #endif
                        ), m_apvts (*this, nullptr, "Parameters", createParameters()) 
 {
+    m_delayEffect.setTraceRing(&m_traceRing);
+    m_isBypassOnValue = m_apvts.getRawParameterValue("IS_BYPASS_ON");
+    m_delayTimeValue = m_apvts.getRawParameterValue("DELAY_TIME");
 }
 
 AudioPluginAudioProcessor::~AudioPluginAudioProcessor()
 {
+    cancelPendingUpdate();
 }
 
 //==============================================================================
@@ -56,9 +60,11 @@ bool AudioPluginAudioProcessor::isMidiEffect() const
    #endif
 }
 
+// The echoes go on after the input stops (and play out under a bypass 
+// with trails), so the host keeps calling processBlock() until they are done
 double AudioPluginAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    return m_delayEffect.getTailLengthSeconds(m_apvts);
 }
 
 int AudioPluginAudioProcessor::getNumPrograms()
@@ -91,10 +97,21 @@ void AudioPluginAudioProcessor::changeProgramName (int index, const juce::String
 //==============================================================================
 void AudioPluginAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    // Initialization before playback 
+    // Trace memory is only allocated once the plugin is actually used
+    m_traceRing.allocate();
+
+    // Initialization before playback. Parameters are read first so that the
+    // delay lines are sized for the current delay time from the start.
+    m_delayEffect.setParametersFromAPVTS(m_apvts);
     m_delayEffect.prepareToPlay(static_cast<float>(sampleRate));
-    
-    juce::ignoreUnused(samplesPerBlock);
+
+    // Not on the audio thread here, so the host can be told directly
+    cancelPendingUpdate();
+    m_pendingLatencySamples = m_delayEffect.getLatencySamples();
+    setLatencySamples(m_pendingLatencySamples);
+
+    // Each block's processing time is measured against its audio duration
+    m_loadMeter.reset(sampleRate, samplesPerBlock);
 }
 
 void AudioPluginAudioProcessor::releaseResources()
@@ -135,13 +152,116 @@ void AudioPluginAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
 {
     juce::ignoreUnused(midiMessages);
     juce::ScopedNoDenormals noDenormals;
+    BlockLoadMeter::ScopedTimer loadTimer(m_loadMeter, buffer.getNumSamples());
+    TraceScope trace(&m_traceRing, "processBlock", buffer.getNumSamples());
+
+    processDelay(buffer, false);
+}
+
+// Called instead of processBlock() by hosts that bypass the plugin without 
+// going through getBypassParameter(). The delay fades out (or trails) just 
+// as it does for the parameter.
+void AudioPluginAudioProcessor::processBlockBypassed (juce::AudioBuffer<float>& buffer,
+                                                      juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+    juce::ScopedNoDenormals noDenormals;
+    BlockLoadMeter::ScopedTimer loadTimer(m_loadMeter, buffer.getNumSamples());
+    TraceScope trace(&m_traceRing, "processBlockBypassed", buffer.getNumSamples());
+
+    processDelay(buffer, true);
+}
+
+// IS_BYPASS_ON is the host's bypass switch, so the host's bypass gets the 
+// same click-free fade as the editor's
+juce::AudioProcessorParameter* AudioPluginAudioProcessor::getBypassParameter() const
+{
+    return m_apvts.getParameter("IS_BYPASS_ON");
+}
+
+// Run the delay on a block, bypassed if either the parameter or the host 
+// says so
+void AudioPluginAudioProcessor::processDelay (juce::AudioBuffer<float>& buffer, 
+                                              bool isHostBypassed)
+{
+    // Once a bypass has faded out the delay has nothing to do, and the 
+    // audio passes through untouched without reading any other parameter
+    const bool isBypassOn = isHostBypassed || m_isBypassOnValue->load() >= 0.5f;
+
+    if (isBypassOn && m_delayEffect.isFullyBypassed())
+        return;
 
     m_delayEffect.setParametersFromAPVTS(m_apvts);
+
+    if (isHostBypassed)
+        m_delayEffect.forceBypass();
+
     m_delayEffect.update();
 
+    // Spectral mode adds latency, so the host is told whenever it is 
+    // switched on or off. Hosts expect that from the message thread, not 
+    // the audio thread, so it is passed on by handleAsyncUpdate().
+    const int latencySamples = m_delayEffect.getLatencySamples();
+
+    if (latencySamples != m_pendingLatencySamples.load(std::memory_order_relaxed))
+    {
+        m_pendingLatencySamples.store(latencySamples, std::memory_order_relaxed);
+        triggerAsyncUpdate();
+    }
+
     // Delay effect requires two audio channels
-    if (buffer.getNumChannels() == 2)
-        m_delayEffect.processAudioBuffer(buffer);
+    if (buffer.getNumChannels() != 2)
+        return;
+
+    const bool isTelemetryEnabled = m_isTelemetryEnabled.load(std::memory_order_relaxed);
+    TelemetryFrame frame {};
+
+    if (isTelemetryEnabled)
+        measureLevels(buffer, frame.inputPeak, frame.inputRms);
+
+    m_delayEffect.processAudioBuffer(buffer);
+
+    // Publish this block's levels for the editor. Dropped if the editor 
+    // has fallen behind.
+    if (isTelemetryEnabled)
+    {
+        const auto telemetry = m_delayEffect.getBlockTelemetry(buffer.getNumSamples());
+
+        measureLevels(buffer, frame.outputPeak, frame.outputRms);
+        frame.feedbackRms = telemetry.feedbackRms;
+        frame.delayLineMin = telemetry.delayLineMin;
+        frame.delayLineMax = telemetry.delayLineMax;
+        frame.delayTimeMs = m_delayTimeValue->load();
+        frame.sampleRate = static_cast<float>(getSampleRate());
+        frame.numSamples = buffer.getNumSamples();
+
+        m_telemetryQueue.push(frame);
+    }
+}
+
+// Peak and RMS level across both channels of a buffer
+void AudioPluginAudioProcessor::measureLevels(const juce::AudioBuffer<float>& buffer, 
+                                              float& peak, float& rms) const
+{
+    const int numSamples = buffer.getNumSamples();
+    float sumSquares = 0.0f;
+    peak = 0.0f;
+
+    for (int channel = 0; channel < buffer.getNumChannels(); channel++)
+    {
+        peak = juce::jmax(peak, buffer.getMagnitude(channel, 0, numSamples));
+
+        const float channelRms = buffer.getRMSLevel(channel, 0, numSamples);
+        sumSquares += channelRms * channelRms;
+    }
+
+    rms = std::sqrt(sumSquares / static_cast<float>(juce::jmax(1, buffer.getNumChannels())));
+}
+
+// Runs on the message thread after processDelay() finds the latency changed
+void AudioPluginAudioProcessor::handleAsyncUpdate()
+{
+    setLatencySamples(m_pendingLatencySamples.load(std::memory_order_relaxed));
 }
 
 //==============================================================================
@@ -213,10 +333,18 @@ juce::AudioProcessorValueTreeState::ParameterLayout AudioPluginAudioProcessor::c
                 "Ping Pong", 
                 false));
 
+    // Also the host's bypass switch (see getBypassParameter())
     params.push_back(std::make_unique<juce::AudioParameterBool>(
                 "IS_BYPASS_ON", 
                 "Bypass", 
                 false));
+
+    // Let the delay's tail play out while bypassed, instead of fading it 
+    // out with the rest of the effect. Takes effect when bypass engages.
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+                "BYPASS_TRAILS", 
+                "Trails", 
+                false));
     
     // Cutoff frequency slider requires a logarithmic slider.
     // For logarithmic slider that works with APVTS, need to use a 
@@ -233,9 +361,19 @@ juce::AudioProcessorValueTreeState::ParameterLayout AudioPluginAudioProcessor::c
     params.push_back(std::make_unique<juce::AudioParameterChoice>(
                 "LOOP_FILTER_TYPE", 
                 "Filter Type", 
-                juce::StringArray{"Low Pass", "High Pass", "None"}, 
+                juce::StringArray{"Low Pass", "High Pass", "None", 
+                                  "SVF Low Pass", "SVF High Pass", 
+                                  "SVF Band Pass", "SVF Notch"}, 
                 2));
 
+    // Only affects the SVF filter types
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+                "LOOP_FILTER_RESONANCE", 
+                "Resonance", 
+                0.0f, 
+                1.0f, 
+                0.0f));
+
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
                 "DIFFUSION", 
                 "Diffusion", 
@@ -243,6 +381,65 @@ juce::AudioProcessorValueTreeState::ParameterLayout AudioPluginAudioProcessor::c
                 1.0f, 
                 0.0f));
 
+    // Scales the diffuser's stage lengths. Changes crossfade to a new set of 
+    // diffusers rather than resizing the running ones.
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+                "DIFFUSION_SIZE", 
+                "Size", 
+                0.5f, 
+                2.0f, 
+                1.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+                "SATURATION_TYPE", 
+                "Saturation", 
+                juce::StringArray{"Off", "Soft Clip", "Tape", "Tube"}, 
+                0));
+
+    // Input gain into the feedback saturator, in dB. Higher drive lowers 
+    // the level the feedback can build up to.
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+                "SATURATION_DRIVE", 
+                "Drive", 
+                0.0f, 
+                24.0f, 
+                6.0f));
+
+    // Plays each delay time's worth of the delay lines backwards
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+                "IS_REVERSE_ON", 
+                "Reverse", 
+                false));
+
+    // Loops what is in the delay lines, without feeding anything back in
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+                "IS_FREEZE_ON", 
+                "Freeze", 
+                false));
+
+    // Per-bin STFT delay instead of the delay lines. Adds one FFT frame of
+    // latency.
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+                "IS_SPECTRAL_ON", 
+                "Spectral", 
+                false));
+
+    // Spectral mode only. Positive tilts give high frequencies longer 
+    // delays / more feedback than low ones, negative the reverse.
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+                "SPECTRAL_DELAY_TILT", 
+                "Delay Tilt", 
+                -1.0f, 
+                1.0f, 
+                0.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+                "SPECTRAL_FEEDBACK_TILT", 
+                "Feedback Tilt", 
+                -1.0f, 
+                1.0f, 
+                0.0f));
+
     return { params.begin(), params.end() };
 }
 
@@ -250,3 +447,41 @@ juce::AudioProcessorValueTreeState& AudioPluginAudioProcessor::getAPVTS()
 {
     return m_apvts;
 }
+
+// Bytes of DSP sample memory held by this instance. Any thread.
+size_t AudioPluginAudioProcessor::getMemoryUsageBytes() const
+{
+    return m_delayEffect.getMemoryUsageBytes();
+}
+
+// Realtime load of this instance's processBlock(). Safe to call from any
+// thread.
+const BlockLoadMeter& AudioPluginAudioProcessor::getLoadMeter() const
+{
+    return m_loadMeter;
+}
+
+BlockLoadMeter::Statistics AudioPluginAudioProcessor::getLoadStatistics() const
+{
+    return m_loadMeter.getStatistics();
+}
+
+// Timeline of this instance's audio thread activity. Call
+// getTraceRing().writeChromeTrace(path) to dump it for a trace viewer.
+TraceRing& AudioPluginAudioProcessor::getTraceRing()
+{
+    return m_traceRing;
+}
+
+// Turn the audio-to-editor level stream on or off. The editor turns it on
+// while it is open, so a closed editor costs the audio thread nothing.
+void AudioPluginAudioProcessor::setTelemetryEnabled(bool shouldBeEnabled)
+{
+    m_isTelemetryEnabled.store(shouldBeEnabled, std::memory_order_relaxed);
+}
+
+// Levels published by processBlock(). Only the editor may pop from it.
+TelemetryQueue& AudioPluginAudioProcessor::getTelemetryQueue()
+{
+    return m_telemetryQueue;
+}
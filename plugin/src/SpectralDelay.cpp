@@ -0,0 +1,392 @@
+///
+///     @file SpectralDelay.cpp
+///     @brief Per-bin delay and feedback on a short-time Fourier transform.
+///     @date October 18, 2026
+///
+///     CPU budget: at most 5% of one core for stereo at 48 kHz, i.e. about
+///     1 us of work per stereo sample. A 1024-point frame every 256 samples
+///     per channel is one forward and one inverse transform plus 513 bin
+///     updates. SpectralDelayBenchmark measures it: 155-270 ns per stereo
+///     sample (0.8-1.3% of a core) on a shared x86-64 machine, with the
+///     rings for a 2 s maximum delay taking 3.1 MB.
+///
+
+#include "DelayPlugin/DSP/SpectralDelay.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+
+SpectralDelay::SpectralDelay() : m_sampleRate{0.0f}, m_fftSize{0},
+    m_numBins{0}, m_hopSize{0}, m_numRingFrames{0}, m_channels{},
+    m_ring{nullptr}, m_inputGain{1.0f}, m_delayTimeMs{-1.0f}, m_feedback{-1.0f},
+    m_delayTilt{0.0f}, m_feedbackTilt{0.0f}
+{
+}
+
+
+SpectralDelay::~SpectralDelay()
+{
+}
+
+
+/**
+ * Size everything for a sample rate and clear it. Allocates, so call it
+ * from prepareToPlay(). Ring memory set before must be set again, since
+ * the size it needs changes with the sample rate.
+ */
+void SpectralDelay::prepare(float sampleRate)
+{
+    m_sampleRate = sampleRate;
+
+    // Keep the frame about 21 ms long whatever the sample rate
+    m_fftSize = 1024;
+
+    while (static_cast<float>(m_fftSize) < sampleRate * (1024.0f / 48000.0f)
+            && m_fftSize < 8192)
+        m_fftSize *= 2;
+
+    m_numBins = m_fftSize / 2 + 1;
+    m_hopSize = static_cast<int>(m_fftSize / 4);
+    m_numRingFrames = static_cast<size_t>(std::ceil(
+                    MAX_DELAY_SECONDS * sampleRate / static_cast<float>(m_hopSize)));
+
+    m_fft.prepare(m_fftSize);
+    m_frame.assign(m_fftSize, Complex());
+
+    // Periodic square-root Hann, used for analysis and synthesis. The
+    // squared windows at 75% overlap sum to 2, which process() divides out.
+    const double TWO_PI = 6.283185307179586;
+    m_window.resize(m_fftSize);
+
+    for (size_t i = 0; i < m_fftSize; i++)
+    {
+        double hann = 0.5 - 0.5 * std::cos(TWO_PI * static_cast<double>(i)
+                                            / static_cast<double>(m_fftSize));
+        m_window[i] = static_cast<float>(std::sqrt(hann));
+    }
+
+    for (Channel& channel : m_channels)
+    {
+        channel.inputFifo.assign(m_fftSize, 0.0f);
+        channel.outputFifo.assign(m_fftSize, 0.0f);
+    }
+
+    m_binOctaves.resize(m_numBins);
+
+    for (size_t bin = 0; bin < m_numBins; bin++)
+    {
+        // DC gets the first bin's setting
+        float frequency = static_cast<float>(std::max<size_t>(bin, 1))
+                            * sampleRate / static_cast<float>(m_fftSize);
+        m_binOctaves[bin] = std::log2(frequency / 1000.0f);
+    }
+
+    m_binDelayFrames.assign(m_numBins, 1);
+    m_binFeedback.assign(m_numBins, 0.0f);
+
+    // Force the per-bin settings to be worked out again
+    m_delayTimeMs = -1.0f;
+
+    m_ring = nullptr;
+    clear();
+}
+
+
+// Bytes of ring memory needed for both channels at the prepared rate
+size_t SpectralDelay::getRingBytes() const
+{
+    return NUM_CHANNELS * m_numRingFrames * m_numBins * sizeof(Complex);
+}
+
+
+/**
+ * Use memory owned by someone else for the per-bin delay rings. It must be
+ * zeroed, 16-byte aligned, and hold getRingBytes(). Anything smaller
+ * (including nullptr) leaves the engine without rings, and the wet signal
+ * is silent until memory is set.
+ */
+void SpectralDelay::setRingMemory(std::byte* memory, size_t numBytes)
+{
+    m_ring = memory != nullptr && numBytes >= getRingBytes()
+                ? reinterpret_cast<Complex*>(memory) : nullptr;
+
+    // Zeroed memory can be read in full
+    for (Channel& channel : m_channels)
+        channel.numLiveFrames = m_numRingFrames;
+}
+
+
+/**
+ * Set the delay and feedback. Works out each bin's settings only when
+ * something has changed.
+ *
+ * @param delayTimeMs   Delay at 1 kHz
+ * @param feedback      Feedback gain at 1 kHz
+ * @param delayTilt     -1 to 1. Positive makes high bins echo later.
+ * @param feedbackTilt  -1 to 1. Positive makes high bins repeat longer.
+ */
+void SpectralDelay::setParameters(float delayTimeMs, float feedback,
+                                    float delayTilt, float feedbackTilt)
+{
+    if (delayTimeMs == m_delayTimeMs && feedback == m_feedback
+            && delayTilt == m_delayTilt && feedbackTilt == m_feedbackTilt)
+        return;
+
+    m_delayTimeMs = delayTimeMs;
+    m_feedback = feedback;
+    m_delayTilt = delayTilt;
+    m_feedbackTilt = feedbackTilt;
+
+    const float hopsPerMs = m_sampleRate * 0.001f / static_cast<float>(m_hopSize);
+    const int maxDelayFrames = static_cast<int>(m_numRingFrames);
+
+    for (size_t bin = 0; bin < m_numBins; bin++)
+    {
+        float octaves = m_binOctaves[bin];
+
+        float binDelayMs = delayTimeMs * std::exp2(0.5f * delayTilt * octaves);
+        int delayFrames = static_cast<int>(std::lround(binDelayMs * hopsPerMs));
+        m_binDelayFrames[bin] = std::clamp(delayFrames, 1, maxDelayFrames);
+
+        // tilt * 3 dB per octave
+        float binFeedback = feedback * std::pow(10.0f, 0.15f * feedbackTilt * octaves);
+        m_binFeedback[bin] = std::min(binFeedback, MAX_FEEDBACK);
+    }
+}
+
+
+/**
+ * Process one channel's block in place: the output is the dry signal and
+ * the wet signal, both delayed by getLatencySamples(), mixed by mix.
+ */
+void SpectralDelay::process(int channelIndex, float* data, int numSamples,
+                                float mix)
+{
+    Channel& channel = m_channels[channelIndex];
+    Complex* ring = m_ring == nullptr ? nullptr
+                        : m_ring + channelIndex * m_numRingFrames * m_numBins;
+
+    const size_t mask = m_fftSize - 1;
+    const float dryGain = 1.0f - mix;
+
+    for (int sample = 0; sample < numSamples; sample++)
+    {
+        // The fifo slot about to be overwritten holds the input from one
+        // FFT length ago, and the output that has just been completed
+        size_t position = channel.position;
+        float delayedDry = channel.inputFifo[position];
+        float wet = channel.outputFifo[position];
+
+        channel.inputFifo[position] = data[sample];
+        channel.outputFifo[position] = 0.0f;
+        channel.position = (position + 1) & mask;
+
+        data[sample] = dryGain * delayedDry + mix * wet;
+
+        if (--channel.samplesUntilFrame == 0)
+        {
+            channel.samplesUntilFrame = m_hopSize;
+            processFrame(channel, ring);
+        }
+    }
+}
+
+
+/**
+ * Process one channel's block in place through the input fifo alone: the
+ * output is the input delayed by getLatencySamples(), and no frames are
+ * run, so nothing reaches the rings. For a bypass that keeps the latency.
+ */
+void SpectralDelay::processDry(int channelIndex, float* data, int numSamples)
+{
+    Channel& channel = m_channels[channelIndex];
+    const size_t mask = m_fftSize - 1;
+
+    for (int sample = 0; sample < numSamples; sample++)
+    {
+        size_t position = channel.position;
+        float delayedDry = channel.inputFifo[position];
+
+        channel.inputFifo[position] = data[sample];
+        channel.outputFifo[position] = 0.0f;
+        channel.position = (position + 1) & mask;
+
+        data[sample] = delayedDry;
+    }
+}
+
+
+/**
+ * Copy the dry signal the next numSamples samples of process() or
+ * processDry() will output for a channel: the input from one FFT length
+ * before each of them. Requires numSamples <= getLatencySamples().
+ */
+void SpectralDelay::readDelayedInput(int channelIndex, float* destination,
+                                        int numSamples) const
+{
+    const Channel& channel = m_channels[channelIndex];
+    const size_t mask = m_fftSize - 1;
+
+    assert(static_cast<size_t>(numSamples) <= m_fftSize);
+
+    for (int sample = 0; sample < numSamples; sample++)
+        destination[sample] = channel.inputFifo[(channel.position 
+                                        + static_cast<size_t>(sample)) & mask];
+}
+
+
+// Scale the input going into the rings from the next frame on, leaving 
+// the dry signal alone. Ramping it to 0 lets what is already in the delay 
+// play out with nothing new added. clear() sets it back to 1.
+void SpectralDelay::setInputGain(float gain)
+{
+    m_inputGain = gain;
+}
+
+
+// Clear the fifos, and mark the rings' contents stale (they read as 
+// silence until written again). Zeroing the rings instead would take 
+// milliseconds at high sample rates.
+void SpectralDelay::clear()
+{
+    for (Channel& channel : m_channels)
+    {
+        std::fill(channel.inputFifo.begin(), channel.inputFifo.end(), 0.0f);
+        channel.position = 0;
+        channel.samplesUntilFrame = m_hopSize;
+    }
+
+    clearWet();
+}
+
+
+// Clear the wet signal and mark the rings stale, but keep the last FFT 
+// length of input, which the dry signal is still to come out of
+void SpectralDelay::clearWet()
+{
+    for (Channel& channel : m_channels)
+    {
+        std::fill(channel.outputFifo.begin(), channel.outputFifo.end(), 0.0f);
+        channel.ringFrame = 0;
+        channel.numLiveFrames = 0;
+    }
+
+    m_inputGain = 1.0f;
+}
+
+
+// Samples by which the output (wet and dry) lags the input
+int SpectralDelay::getLatencySamples() const
+{
+    return static_cast<int>(m_fftSize);
+}
+
+
+// Samples between frames. Delay times are multiples of this.
+int SpectralDelay::getHopSize() const
+{
+    return m_hopSize;
+}
+
+
+/**
+ * Work out how long the wet signal goes on after the input stops, for the
+ * bin whose echoes last longest, with the same per-bin delay and feedback
+ * setParameters() would give. Doesn't include the latency. Only reads what
+ * prepare() sets, so it can be called from any thread but not during
+ * prepare().
+ *
+ * @param decayDb   How far the echoes must fall, in dB (positive).
+ *
+ * @return          Seconds, or 0 before prepare().
+ */
+double SpectralDelay::getTailSeconds(float delayTimeMs, float feedback,
+                                        float delayTilt, float feedbackTilt,
+                                        double decayDb) const
+{
+    if (m_sampleRate <= 0.0f)
+        return 0.0;
+
+    const double hopSeconds = m_hopSize / static_cast<double>(m_sampleRate);
+    const double maxDelaySeconds = static_cast<double>(m_numRingFrames) * hopSeconds;
+    double tailSeconds = 0.0;
+
+    for (float octaves : m_binOctaves)
+    {
+        double binDelaySeconds = std::clamp(0.001 * delayTimeMs 
+                                    * std::exp2(0.5 * delayTilt * octaves),
+                                    hopSeconds, maxDelaySeconds);
+        double binFeedback = std::min(feedback * std::pow(10.0, 0.15 * feedbackTilt * octaves),
+                                      static_cast<double>(MAX_FEEDBACK));
+
+        // The first echo, then enough repeats to fall by decayDb
+        double numEchoes = 1.0;
+
+        if (binFeedback > 0.0)
+            numEchoes += std::ceil(-decayDb / (20.0 * std::log10(binFeedback)));
+
+        tailSeconds = std::max(tailSeconds, numEchoes * binDelaySeconds);
+    }
+
+    return tailSeconds;
+}
+
+
+// Transform the last FFT length of input, run every bin's delay line, and
+// overlap-add the result into the output fifo
+void SpectralDelay::processFrame(Channel& channel, Complex* ring)
+{
+    // Without rings the wet signal is silent, so skip the transforms too
+    if (ring == nullptr)
+        return;
+
+    const size_t mask = m_fftSize - 1;
+
+    for (size_t i = 0; i < m_fftSize; i++)
+    {
+        float x = m_inputGain * channel.inputFifo[(channel.position + i) & mask];
+        m_frame[i] = Complex(x * m_window[i], 0.0f);
+    }
+
+    m_fft.forward(m_frame.data());
+
+    Complex* writeFrame = ring + channel.ringFrame * m_numBins;
+
+    for (size_t bin = 0; bin < m_numBins; bin++)
+    {
+        size_t readFrame = (channel.ringFrame + m_numRingFrames
+                            - static_cast<size_t>(m_binDelayFrames[bin]))
+                                % m_numRingFrames;
+
+        // Read before writing, so a delay of the whole ring still works
+        Complex wet = static_cast<size_t>(m_binDelayFrames[bin])
+                                <= channel.numLiveFrames
+                        ? ring[readFrame * m_numBins + bin] : Complex();
+        float feedback = m_binFeedback[bin];
+
+        writeFrame[bin] = Complex(m_frame[bin].real() + feedback * wet.real(),
+                                  m_frame[bin].imag() + feedback * wet.imag());
+        m_frame[bin] = wet;
+    }
+
+    channel.ringFrame = (channel.ringFrame + 1) % m_numRingFrames;
+    channel.numLiveFrames = std::min(channel.numLiveFrames + 1, 
+                                     m_numRingFrames);
+
+    // The input was real, so the upper half of the spectrum mirrors the
+    // lower half
+    for (size_t bin = 1; bin < m_numBins - 1; bin++)
+        m_frame[m_fftSize - bin] = std::conj(m_frame[bin]);
+
+    m_fft.inverse(m_frame.data());
+
+    // Undo the inverse transform's gain of N and the windows' sum of 2
+    const float scale = 0.5f / static_cast<float>(m_fftSize);
+
+    for (size_t i = 0; i < m_fftSize; i++)
+    {
+        channel.outputFifo[(channel.position + i) & mask]
+                += m_frame[i].real() * m_window[i] * scale;
+    }
+}
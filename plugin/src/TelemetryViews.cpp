@@ -0,0 +1,190 @@
+///
+///     @file TelemetryViews.cpp
+///     @brief Level meters and delay line scope for the editor.
+///     @date October 18, 2026
+///
+
+#include "DelayPlugin/TelemetryViews.h"
+
+//==============================================================================
+LevelMeter::LevelMeter (const juce::String& captionText)
+    : caption (captionText)
+{
+    setOpaque (false);
+}
+
+/**
+ * Show new levels. Peaks are held and released smoothly, and nothing is
+ * repainted unless a bar moves by at least a pixel.
+ *
+ * @param peak  Linear peak level since the last update.
+ * @param rms   Linear RMS level since the last update.
+ */
+void LevelMeter::setLevels (float peak, float rms)
+{
+    displayedPeak = juce::jmax (peak, displayedPeak * RELEASE);
+    displayedRms = juce::jmax (rms, displayedRms * RELEASE);
+
+    const int newPeakHeight = getBarHeight (displayedPeak);
+    const int newRmsHeight = getBarHeight (displayedRms);
+
+    if (newPeakHeight == peakHeight && newRmsHeight == rmsHeight)
+        return;
+
+    // Only the rows between the old and new bar tops changed
+    const auto bar = getBarArea();
+    const int top = bar.getBottom() - juce::jmax (newPeakHeight, peakHeight, newRmsHeight, rmsHeight);
+    const int bottom = bar.getBottom() - juce::jmin (newPeakHeight, peakHeight, newRmsHeight, rmsHeight);
+
+    peakHeight = newPeakHeight;
+    rmsHeight = newRmsHeight;
+
+    repaint (bar.getX(), top - 1, bar.getWidth(), bottom - top + 2);
+}
+
+void LevelMeter::paint (juce::Graphics& g)
+{
+    const auto bar = getBarArea();
+
+    g.setColour (juce::Colours::black.withAlpha (0.5f));
+    g.fillRect (bar);
+
+    // RMS as a solid bar, peak as a lighter bar behind it
+    g.setColour (juce::Colours::white.withAlpha (0.35f));
+    g.fillRect (bar.withTop (bar.getBottom() - peakHeight));
+
+    g.setColour (juce::Colours::white.withAlpha (0.8f));
+    g.fillRect (bar.withTop (bar.getBottom() - rmsHeight));
+
+    g.setColour (juce::Colours::white);
+    g.setFont (juce::FontOptions (12.0f));
+    g.drawText (caption, getLocalBounds().removeFromBottom (CAPTION_HEIGHT),
+                juce::Justification::centred);
+}
+
+int LevelMeter::getBarHeight (float level) const
+{
+    const float db = juce::Decibels::gainToDecibels (level, MIN_DB);
+    const float proportion = juce::jlimit (0.0f, 1.0f, (db - MIN_DB) / -MIN_DB);
+
+    return juce::roundToInt (proportion * static_cast<float> (getBarArea().getHeight()));
+}
+
+juce::Rectangle<int> LevelMeter::getBarArea() const
+{
+    return getLocalBounds().withTrimmedBottom (CAPTION_HEIGHT + 2).reduced (4, 0);
+}
+
+//==============================================================================
+DelayScope::DelayScope()
+{
+    setOpaque (false);
+}
+
+/**
+ * Add the range of one block of delay line input. Columns are completed
+ * once they cover delayTime / width of audio, and drawn into the image.
+ * Call repaintDirtyArea() once all pending blocks are added.
+ */
+void DelayScope::addBlock (float minimum, float maximum, int numSamples,
+                           float sampleRate, float delayTimeMs)
+{
+    if (! image.isValid() || numSamples <= 0)
+        return;
+
+    samplesPerColumn = juce::jmax (1.0e-3, static_cast<double> (delayTimeMs) * 0.001
+                                               * sampleRate / image.getWidth());
+
+    columnMin = isColumnEmpty ? minimum : juce::jmin (columnMin, minimum);
+    columnMax = isColumnEmpty ? maximum : juce::jmax (columnMax, maximum);
+    isColumnEmpty = false;
+    columnSamples += numSamples;
+
+    // A block longer than a column fills several columns with its range.
+    // There's no point drawing more than the whole width.
+    int numColumns = 0;
+
+    while (columnSamples >= samplesPerColumn && numColumns < image.getWidth())
+    {
+        drawColumn (columnMin, columnMax);
+        columnSamples -= samplesPerColumn;
+        numColumns++;
+    }
+
+    if (numColumns == image.getWidth())
+        columnSamples = 0.0;
+
+    if (numColumns > 0)
+        isColumnEmpty = columnSamples <= 0.0;
+}
+
+// Repaint the columns drawn since the last call, and the sweep cursor
+void DelayScope::repaintDirtyArea()
+{
+    if (numDirtyColumns == 0)
+        return;
+
+    const int width = getWidth();
+
+    // The cursor sits just after the last column, so include it
+    const int numColumns = juce::jmin (numDirtyColumns + 1, width);
+
+    if (firstDirtyX + numColumns <= width)
+    {
+        repaint (firstDirtyX, 0, numColumns, getHeight());
+    }
+    else
+    {
+        repaint (firstDirtyX, 0, width - firstDirtyX, getHeight());
+        repaint (0, 0, firstDirtyX + numColumns - width, getHeight());
+    }
+
+    firstDirtyX = -1;
+    numDirtyColumns = 0;
+}
+
+void DelayScope::paint (juce::Graphics& g)
+{
+    g.setColour (juce::Colours::black.withAlpha (0.5f));
+    g.fillRect (getLocalBounds());
+
+    g.drawImageAt (image, 0, 0);
+
+    g.setColour (juce::Colours::white.withAlpha (0.6f));
+    g.fillRect (writeX, 0, 1, getHeight());
+}
+
+void DelayScope::resized()
+{
+    image = juce::Image (juce::Image::ARGB, juce::jmax (1, getWidth()),
+                         juce::jmax (1, getHeight()), true);
+    writeX = 0;
+    columnSamples = 0.0;
+    isColumnEmpty = true;
+    firstDirtyX = -1;
+    numDirtyColumns = 0;
+}
+
+void DelayScope::drawColumn (float minimum, float maximum)
+{
+    const int height = image.getHeight();
+    const float centre = static_cast<float> (height) * 0.5f;
+
+    // +-1 fills the height. Feedback can push the delay line past that.
+    const int top = juce::jlimit (0, height - 1, static_cast<int> (centre - juce::jmin (maximum, 1.0f) * centre));
+    const int bottom = juce::jlimit (0, height - 1, static_cast<int> (centre - juce::jmax (minimum, -1.0f) * centre));
+
+    image.clear ({ writeX, 0, 1, height });
+
+    {
+        juce::Graphics g (image);
+        g.setColour (juce::Colours::white);
+        g.fillRect (writeX, top, 1, bottom - top + 1);
+    }
+
+    if (numDirtyColumns == 0)
+        firstDirtyX = writeX;
+
+    numDirtyColumns++;
+    writeX = (writeX + 1) % image.getWidth();
+}
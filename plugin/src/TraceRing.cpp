@@ -0,0 +1,172 @@
+///
+///     @file TraceRing.cpp
+///     @brief Wait-free ring of timestamped trace events.
+///     @date October 18, 2026
+///
+
+#include "DelayPlugin/DSP/TraceRing.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+
+
+TraceRing::TraceRing(std::string trackName) : m_slots{nullptr}, m_writeCount{0},
+    m_isEnabled{true}, m_trackName{std::move(trackName)}
+{
+    // Each ring gets its own track in the trace viewer
+    static std::atomic<int> nextTrackId{1};
+    m_trackId = nextTrackId++;
+}
+
+
+// Allocate the ring, if it isn't already. Must not be called while the 
+// producer thread is recording (e.g. call it from prepareToPlay()).
+void TraceRing::allocate()
+{
+    if (m_slotStorage != nullptr)
+        return;
+
+    m_slotStorage = std::make_unique<Slot[]>(CAPACITY);
+    m_slots.store(m_slotStorage.get(), std::memory_order_release);
+}
+
+
+// Turn recording on or off. Events already in the ring are kept.
+void TraceRing::setEnabled(bool shouldBeEnabled)
+{
+    m_isEnabled.store(shouldBeEnabled, std::memory_order_relaxed);
+}
+
+
+bool TraceRing::isEnabled() const
+{
+    return m_isEnabled.load(std::memory_order_relaxed);
+}
+
+
+// Set the name shown for this ring's track in the trace viewer. Not while
+// a dump is in progress.
+void TraceRing::setTrackName(std::string trackName)
+{
+    m_trackName = std::move(trackName);
+}
+
+
+/**
+ * Copy out the events currently in the ring, oldest first. Events the
+ * producer overwrote while they were being copied are left out.
+ */
+std::vector<TraceRing::Event> TraceRing::getSnapshot() const
+{
+    const Slot* slots = m_slots.load(std::memory_order_acquire);
+
+    if (slots == nullptr)
+        return {};
+
+    std::uint64_t endIndex = m_writeCount.load(std::memory_order_acquire);
+    std::uint64_t startIndex = endIndex > CAPACITY ? endIndex - CAPACITY : 0;
+
+    std::vector<Event> events;
+    events.reserve(static_cast<size_t>(endIndex - startIndex));
+
+    for (std::uint64_t index = startIndex; index < endIndex; index++)
+    {
+        const Slot& slot = slots[index & (CAPACITY - 1)];
+
+        events.push_back({ slot.timestampNs.load(std::memory_order_relaxed),
+                           slot.name.load(std::memory_order_relaxed),
+                           static_cast<Phase>(slot.phase.load(std::memory_order_relaxed)),
+                           slot.value.load(std::memory_order_relaxed) });
+    }
+
+    // Anything the producer may have reached since (including the slot it
+    // could be in the middle of writing) is unreliable, so drop it
+    std::atomic_thread_fence(std::memory_order_acquire);
+    std::uint64_t newEndIndex = m_writeCount.load(std::memory_order_relaxed);
+    std::uint64_t firstValidIndex = newEndIndex + 1 > CAPACITY
+                                        ? newEndIndex + 1 - CAPACITY : 0;
+
+    if (firstValidIndex > startIndex)
+    {
+        size_t numStale = static_cast<size_t>(
+                            std::min(firstValidIndex - startIndex,
+                                     static_cast<std::uint64_t>(events.size())));
+        events.erase(events.begin(), events.begin() + numStale);
+    }
+
+    return events;
+}
+
+
+/**
+ * Format the ring as Chrome trace-event JSON ("JSON Object Format"). Each
+ * ring gets its own track, named with setTrackName().
+ */
+std::string TraceRing::toChromeTraceJson() const
+{
+    std::vector<Event> events = getSnapshot();
+
+    std::string json = "{\"traceEvents\":[\n";
+    char line[256];
+
+    std::snprintf(line, sizeof(line),
+            "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+            "\"args\":{\"name\":\"", m_trackId);
+    json += line;
+
+    // Track names come from the host or the user, so escape them
+    for (char c : m_trackName)
+    {
+        if (c == '"' || c == '\\')
+            json += '\\';
+
+        if (static_cast<unsigned char>(c) >= 0x20)
+            json += c;
+    }
+
+    json += "\"}}";
+
+    for (const Event& event : events)
+    {
+        // Event names are string literals in the plugin, so need no escaping
+        std::snprintf(line, sizeof(line),
+                ",\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%" PRId64 ".%03d,"
+                "\"pid\":1,\"tid\":%d",
+                event.name != nullptr ? event.name : "?",
+                static_cast<char>(event.phase),
+                event.timestampNs / 1000,
+                static_cast<int>(event.timestampNs % 1000), m_trackId);
+        json += line;
+
+        if (event.phase == Phase::instant)
+            json += ",\"s\":\"t\"";
+
+        if (event.value != 0)
+        {
+            std::snprintf(line, sizeof(line), ",\"args\":{\"value\":%" PRId64 "}",
+                            event.value);
+            json += line;
+        }
+
+        json += "}";
+    }
+
+    json += "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    return json;
+}
+
+
+// Write toChromeTraceJson() to a file. Returns false if it couldn't be written.
+bool TraceRing::writeChromeTrace(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::binary);
+
+    if (! file)
+        return false;
+
+    file << toChromeTraceJson();
+
+    return static_cast<bool>(file);
+}
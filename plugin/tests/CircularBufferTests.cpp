@@ -0,0 +1,232 @@
+///
+///     @file CircularBufferTests.cpp
+///     @brief Tests for CircularBuffer's indexing and block access.
+///     @date October 18, 2026
+///
+///     operator() counts from the oldest element and operator[] from the
+///     newest. The block functions must agree with the per-element ones
+///     wherever the range wraps, with both backends: the plain vector, and
+///     the mirrored region, where the wrap needs no split. The fixed-capacity
+///     specialization must behave exactly like a run-time sized buffer.
+///
+
+#include "DelayPlugin/DSP/CircularBuffer.h"
+#include "DelayPlugin/DSP/MirroredMemory.h"
+#include <juce_core/juce_core.h>
+#include <algorithm>
+#include <vector>
+
+
+namespace
+{
+    constexpr size_t BUFFER_SIZE = 16;
+
+    // Mirroring needs a whole number of pages (the page size is 0 where
+    // mirroring isn't supported)
+    size_t getMirrorableSize()
+    {
+        return std::max(MirroredMemory::getPageSize() / sizeof(float), size_t(1024));
+    }
+}
+
+
+class CircularBufferTests : public juce::UnitTest
+{
+public:
+    CircularBufferTests() : juce::UnitTest("CircularBuffer", "DSP")
+    {
+    }
+
+    void runTest() override
+    {
+        beginTest("shift() returns the element shifted out");
+        {
+            CircularBuffer<float> buffer(BUFFER_SIZE);
+
+            for (int i = 1; i <= 3 * static_cast<int>(BUFFER_SIZE); i++)
+            {
+                const float expected = i > static_cast<int>(BUFFER_SIZE)
+                                        ? static_cast<float>(i - static_cast<int>(BUFFER_SIZE))
+                                        : 0.0f;
+                expectEquals(buffer.shift(static_cast<float>(i)), expected);
+            }
+        }
+
+        beginTest("operator[] counts back from the newest element");
+        {
+            CircularBuffer<float> buffer(BUFFER_SIZE);
+
+            for (int i = 0; i < 20; i++)
+                buffer.push(static_cast<float>(i));
+
+            expectEquals(buffer[0], 19.0f);
+            expectEquals(buffer[5], 14.0f);
+            expectEquals(buffer(0), 4.0f);
+        }
+
+        beginTest("Block reads and writes match element access across the wrap");
+        {
+            for (size_t offset = 0; offset < BUFFER_SIZE; offset++)
+            {
+                CircularBuffer<float> buffer(BUFFER_SIZE);
+
+                for (size_t i = 0; i < offset; i++)
+                    buffer.push(-1.0f);
+
+                std::vector<float> block(BUFFER_SIZE);
+
+                for (size_t i = 0; i < block.size(); i++)
+                    block[i] = static_cast<float>(i);
+
+                buffer.pushBlock(block.data(), block.size());
+
+                std::vector<float> read(BUFFER_SIZE);
+                buffer.readBlock(0, read.data(), read.size());
+
+                expect(read == block, "Block round trip differs at offset " + juce::String(offset));
+
+                for (size_t i = 0; i < BUFFER_SIZE; i++)
+                    expectEquals(buffer(i), block[i]);
+            }
+        }
+
+        testMirroredAliasing();
+        testMirroringFallback();
+        testBackendsAgree();
+        testFixedCapacity();
+    }
+
+private:
+    void testMirroredAliasing()
+    {
+        beginTest("A mirrored buffer's two halves alias");
+        {
+            const size_t size = getMirrorableSize();
+            CircularBuffer<float> buffer(size, 0.0f, true);
+
+            if (! MirroredMemory::canMirror(size * sizeof(float)))
+            {
+                expect(! buffer.isMirrored());
+                logMessage("Mirroring isn't supported here; only the fallback is tested");
+                return;
+            }
+
+            expect(buffer.isMirrored(), "The mapping failed");
+            expect(! buffer.usesExternalStorage());
+            expectEquals(buffer.getMemoryBytes(), size * sizeof(float));
+
+            // Leave the oldest element three before the end of the storage
+            for (size_t i = 0; i < size + size - 3; i++)
+                buffer.push(static_cast<float>(i));
+
+            const float* range = buffer.getContiguousRange(0, size);
+            expect(range != nullptr, "A mirrored range spanning the wrap was split");
+
+            if (range != nullptr)
+            {
+                for (size_t i = 0; i < size; i++)
+                    expectEquals(range[i], buffer(i));
+            }
+        }
+    }
+
+    void testMirroringFallback()
+    {
+        beginTest("A size that isn't whole pages falls back to a vector");
+        {
+            CircularBuffer<float> buffer(BUFFER_SIZE, 0.0f, true);
+
+            expect(! buffer.isMirrored());
+            expectEquals(buffer.getSize(), BUFFER_SIZE);
+
+            for (size_t i = 0; i < BUFFER_SIZE + 3; i++)
+                buffer.push(static_cast<float>(i));
+
+            expect(buffer.getContiguousRange(0, BUFFER_SIZE) == nullptr,
+                   "A vector range spanning the wrap came back contiguous");
+        }
+    }
+
+    void testBackendsAgree()
+    {
+        beginTest("Both backends read and write the same");
+        {
+            const size_t size = getMirrorableSize();
+            CircularBuffer<float> mirrored(size, 0.0f, true);
+            CircularBuffer<float> masked(size);
+            juce::Random random(7);
+            std::vector<float> block(size / 3);
+
+            for (int round = 0; round < 20; round++)
+            {
+                for (auto& sample : block)
+                    sample = random.nextFloat();
+
+                mirrored.pushBlock(block.data(), block.size());
+                masked.pushBlock(block.data(), block.size());
+
+                for (size_t x : { size_t(0), size / 2, size - block.size() })
+                {
+                    std::vector<float> fromMirrored(block.size()), fromMasked(block.size());
+                    mirrored.readBlock(x, fromMirrored.data(), block.size());
+                    masked.readBlock(x, fromMasked.data(), block.size());
+
+                    expect(fromMirrored == fromMasked, "readBlock() differs at " + juce::String(x));
+                }
+
+                const float delay = random.nextFloat() * static_cast<float>(size - 2);
+                expectEquals(mirrored.interpolate(delay), masked.interpolate(delay));
+            }
+
+            // Copies keep their backend and contents
+            CircularBuffer<float> copy(mirrored);
+            expect(copy.isMirrored() == mirrored.isMirrored());
+
+            for (size_t i = 0; i < size; i++)
+                expectEquals(copy(i), masked(i));
+        }
+    }
+
+    void testFixedCapacity()
+    {
+        beginTest("A fixed-capacity buffer matches a run-time sized one");
+        {
+            CircularBuffer<float, FixedCapacity<BUFFER_SIZE>> fixed;
+            CircularBuffer<float> sized(BUFFER_SIZE);
+
+            // Held inline, with nothing else to point at
+            static_assert(sizeof(fixed) <= BUFFER_SIZE * sizeof(float) + sizeof(size_t));
+            expectEquals(fixed.getSize(), BUFFER_SIZE);
+
+            juce::Random random(11);
+            std::vector<float> block(5);
+
+            for (int round = 0; round < 20; round++)
+            {
+                for (auto& sample : block)
+                    sample = random.nextFloat();
+
+                fixed.pushBlock(block.data(), block.size());
+                sized.pushBlock(block.data(), block.size());
+
+                const float sample = random.nextFloat();
+                expectEquals(fixed.shift(sample), sized.shift(sample));
+
+                std::vector<float> fromFixed(BUFFER_SIZE), fromSized(BUFFER_SIZE);
+                fixed.readBlock(0, fromFixed.data(), BUFFER_SIZE);
+                sized.readBlock(0, fromSized.data(), BUFFER_SIZE);
+                expect(fromFixed == fromSized, "readBlock() differs in round " + juce::String(round));
+
+                const float delay = random.nextFloat() * static_cast<float>(BUFFER_SIZE - 2);
+                expectEquals(fixed.interpolate(delay), sized.interpolate(delay));
+                expectEquals(fixed[3], sized[3]);
+            }
+
+            fixed.clear();
+            expectEquals(fixed[0], 0.0f);
+        }
+    }
+};
+
+
+static CircularBufferTests circularBufferTests;
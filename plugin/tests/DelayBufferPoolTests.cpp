@@ -0,0 +1,130 @@
+///
+///     @file DelayBufferPoolTests.cpp
+///     @brief Tests for DelayBufferPool when memory runs out.
+///     @date October 18, 2026
+///
+///     A block the pool can't allocate must not take anything down: not
+///     the caller of acquireNow() (prepareToPlay()), and not the service
+///     thread, which has nobody to throw to. The lease keeps what it had,
+///     the pool's books balance, and the next reasonable request is served.
+///
+///     The impossible size is more than a 64-bit address space can map.
+///     Under AddressSanitizer the tests need allocator_may_return_null=1,
+///     which the test target sets when sanitizers are on.
+///
+
+#include "DelayPlugin/DSP/DelayBufferPool.h"
+#include <juce_core/juce_core.h>
+#include <chrono>
+#include <new>
+#include <thread>
+
+
+namespace
+{
+    constexpr std::size_t IMPOSSIBLE_BYTES = std::size_t(1) << 60;
+    constexpr std::size_t SMALL_BYTES = 4096;
+
+    // Long enough for the service thread to have looked many times
+    constexpr auto SERVICE_WAIT = std::chrono::milliseconds(50);
+    constexpr auto SERVICE_TIMEOUT = std::chrono::seconds(5);
+}
+
+
+class DelayBufferPoolTests : public juce::UnitTest
+{
+public:
+    DelayBufferPoolTests() : juce::UnitTest("DelayBufferPool", "DSP")
+    {
+    }
+
+    void runTest() override
+    {
+        auto& pool = DelayBufferPool::getInstance();
+
+        beginTest("acquire() throws bad_alloc and keeps the books");
+        {
+            const auto before = pool.getStatistics();
+            bool hasThrown = false;
+
+            try
+            {
+                pool.acquire(IMPOSSIBLE_BYTES);
+            }
+            catch (const std::bad_alloc&)
+            {
+                hasThrown = true;
+            }
+
+            expect(hasThrown, "Expected std::bad_alloc");
+            expectBooksUnchanged(before, pool.getStatistics());
+        }
+
+        beginTest("acquireNow() leaves the lease empty");
+        {
+            const auto before = pool.getStatistics();
+            DelayBufferLease lease;
+            lease.acquireNow(IMPOSSIBLE_BYTES);
+
+            expectEquals(lease.getCurrentBytes(), std::size_t(0));
+            expect(lease.getCurrentBlock().data == nullptr);
+            expectBooksUnchanged(before, pool.getStatistics());
+
+            // Then a size that fits works as usual
+            lease.acquireNow(SMALL_BYTES);
+            expectEquals(lease.getCurrentBytes(), SMALL_BYTES);
+        }
+
+        beginTest("The service thread survives a failed request");
+        {
+            DelayBufferLease lease;
+            lease.acquireNow(SMALL_BYTES);
+            const auto* current = lease.getCurrentBlock().data;
+
+            // As the audio thread would
+            lease.request(IMPOSSIBLE_BYTES);
+            std::this_thread::sleep_for(SERVICE_WAIT);
+
+            expect(lease.getPendingBlock() == nullptr, "A block was published");
+            expect(lease.getCurrentBlock().data == current, "The current block changed");
+
+            // Nothing is retried until the request changes; then it is served
+            lease.request(2 * SMALL_BYTES);
+            const auto* pending = waitForPendingBlock(lease);
+
+            expect(pending != nullptr, "The service thread stopped serving requests");
+
+            if (pending != nullptr)
+            {
+                expectEquals(pending->numBytes, 2 * SMALL_BYTES);
+                lease.acceptPendingBlock();
+            }
+        }
+    }
+
+private:
+    void expectBooksUnchanged(const DelayBufferPool::Statistics& before,
+                              const DelayBufferPool::Statistics& after)
+    {
+        expectEquals(after.inUseBytes, before.inUseBytes, "In-use bytes changed");
+        expectEquals(after.inUseBlocks, before.inUseBlocks, "In-use blocks changed");
+    }
+
+    const DelayBufferLease::Block* waitForPendingBlock(const DelayBufferLease& lease)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + SERVICE_TIMEOUT;
+
+        while (std::chrono::steady_clock::now() < deadline)
+        {
+            if (const auto* pending = lease.getPendingBlock())
+                return pending;
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        return nullptr;
+    }
+};
+
+
+static DelayBufferPoolTests delayBufferPoolTests;
@@ -0,0 +1,363 @@
+///
+///     @file DualMonoTests.cpp
+///     @brief Tests that the shared dual-mono path sounds like the normal one.
+///     @date October 18, 2026
+///
+///     With ping pong off the channels never mix, so each output channel
+///     depends only on its own input. When both inputs are bit-identical
+///     DelayEffect runs only the left path and copies its output to the
+///     right (see selectNumPaths()). These tests check that this changes
+///     nothing: the dual-mono render's left channel must match, bit for
+///     bit, a render whose left input is the same but whose right input is
+///     different noise (so both paths always run), and likewise for the
+///     right channel.
+///
+///     The input goes dual mono, stereo, silent (long enough for the tails
+///     to die away, so the channels can share a path again) and dual mono
+///     again, which takes the shared path in and out, through the copy of
+///     the left channel's state and the incremental sync check. Freezing
+///     while the channels share a path, just after a clear, must still 
+///     loop the delay.
+///
+
+#include "TestUtilities.h"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+
+namespace
+{
+    constexpr double SAMPLE_RATE = 44100.0;
+    constexpr int BLOCK_SIZE = 256;
+    constexpr int IRREGULAR_BLOCK_SIZES[] = { 1, 7, 64, 333, 512, 2, 128 };
+
+    // The input's sections, in seconds
+    constexpr double STEREO_START = 0.5;
+    constexpr double SILENCE_START = 1.0;
+    constexpr double DUAL_MONO_AGAIN_START = 3.0;
+    constexpr double DURATION = 4.0;
+
+    struct ParameterValue
+    {
+        const char* parameterID;
+        float value;
+    };
+
+    // Sets parameters at the start of a block, given the time in seconds
+    using Automation = void (*)(juce::AudioProcessorValueTreeState&, double time);
+
+    struct DualMonoCase
+    {
+        const char* name;
+        std::vector<ParameterValue> parameters;
+        Automation automation;
+    };
+
+    const std::vector<ParameterValue> BASE_PARAMETERS {
+        { "DELAY_TIME", 20.0f },
+        { "FEEDBACK", 0.5f },
+        { "MIX", 0.5f },
+        { "IS_PING_PONG_ON", 0.0f },
+        { "LOOP_FILTER_TYPE", 2.0f },
+        { "DIFFUSION", 0.0f },
+        { "SATURATION_TYPE", 0.0f },
+        { "IS_REVERSE_ON", 0.0f },
+        { "IS_FREEZE_ON", 0.0f },
+        { "IS_SPECTRAL_ON", 0.0f }
+    };
+
+    std::vector<DualMonoCase> makeCases()
+    {
+        return {
+            { "Plain", {}, nullptr },
+
+            { "One-pole low pass",
+                { { "LOOP_FILTER_TYPE", 0.0f }, { "LOOP_FILTER_CUTOFF", 2000.0f } },
+                nullptr },
+
+            { "SVF band pass",
+                { { "LOOP_FILTER_TYPE", 5.0f }, { "LOOP_FILTER_CUTOFF", 1500.0f },
+                  { "LOOP_FILTER_RESONANCE", 0.7f } },
+                nullptr },
+
+            { "Diffusion", { { "DIFFUSION", 0.8f } }, nullptr },
+
+            { "Tape saturation",
+                { { "SATURATION_TYPE", 2.0f }, { "SATURATION_DRIVE", 12.0f } },
+                nullptr },
+
+            { "Reverse", { { "IS_REVERSE_ON", 1.0f } }, nullptr },
+
+            // Frozen while dual mono, released while stereo
+            { "Freeze", {},
+                [](juce::AudioProcessorValueTreeState& apvts, double time)
+                {
+                    setParameter(apvts, "IS_FREEZE_ON",
+                                 time >= 0.3 && time < 0.8 ? 1.0f : 0.0f);
+                } },
+
+            // Moves while the channels share a path and while they don't
+            { "Automation", { { "LOOP_FILTER_TYPE", 0.0f } },
+                [](juce::AudioProcessorValueTreeState& apvts, double time)
+                {
+                    const float progress = static_cast<float>(time / DURATION);
+
+                    setParameter(apvts, "MIX", 0.2f + 0.7f * progress);
+                    setParameter(apvts, "FEEDBACK", 0.6f - 0.3f * progress);
+                    setParameter(apvts, "LOOP_FILTER_CUTOFF", 8000.0f - 7000.0f * progress);
+                } }
+        };
+    }
+
+    struct NoiseGenerator
+    {
+        std::uint32_t state;
+
+        float getNextSample(float amplitude)
+        {
+            state = state * 1664525u + 1013904223u;
+            return amplitude * (static_cast<float>(state >> 8) / 8388608.0f - 1.0f);
+        }
+    };
+
+    // The input for one channel of the dual-mono render. Both channels get
+    // the same noise except in the stereo section, where the right gets
+    // its own.
+    std::vector<float> makeDualMonoInput(int channel, int numSamples)
+    {
+        std::vector<float> input(static_cast<size_t>(numSamples));
+        NoiseGenerator shared { 1 };
+        NoiseGenerator rightOnly { 2 };
+
+        for (int i = 0; i < numSamples; i++)
+        {
+            const double time = i / SAMPLE_RATE;
+            const float sample = shared.getNextSample(0.5f);
+
+            if (time >= SILENCE_START && time < DUAL_MONO_AGAIN_START)
+                continue;
+
+            const bool isStereo = time >= STEREO_START && time < SILENCE_START;
+            input[static_cast<size_t>(i)] = channel == 1 && isStereo
+                                            ? rightOnly.getNextSample(0.5f) : sample;
+        }
+
+        return input;
+    }
+
+    // Noise that differs from the other input in every block, so the
+    // channels are never dual mono
+    std::vector<float> makeOtherInput(int numSamples)
+    {
+        std::vector<float> input(static_cast<size_t>(numSamples));
+        NoiseGenerator noise { 3 };
+
+        for (auto& sample : input)
+            sample = noise.getNextSample(0.25f);
+
+        return input;
+    }
+
+    struct Render
+    {
+        juce::AudioBuffer<float> output;
+        int numTimesShared;     // times the channels started sharing a path
+        int numTimesUnshared;   // and stopped
+    };
+}
+
+
+class DualMonoTests : public juce::UnitTest
+{
+public:
+    DualMonoTests() : juce::UnitTest("Dual mono", "DSP")
+    {
+    }
+
+    void runTest() override
+    {
+        const int numSamples = static_cast<int>(DURATION * SAMPLE_RATE);
+        const auto left = makeDualMonoInput(0, numSamples);
+        const auto right = makeDualMonoInput(1, numSamples);
+        const auto other = makeOtherInput(numSamples);
+
+        for (const auto& dualMonoCase : makeCases())
+        {
+            for (bool hasIrregularBlocks : { false, true })
+            {
+                beginTest(juce::String(dualMonoCase.name)
+                            + (hasIrregularBlocks ? ", irregular blocks" : ""));
+
+                const auto dualMono = render(dualMonoCase, left, right, hasIrregularBlocks);
+                const auto leftReference = render(dualMonoCase, left, other, hasIrregularBlocks);
+                const auto rightReference = render(dualMonoCase, other, right, hasIrregularBlocks);
+
+                // Otherwise there is nothing to compare
+                expect(dualMono.numTimesShared > 0, "The channels never shared a path");
+                expect(dualMono.numTimesUnshared > 0, "The channels never stopped sharing a path");
+                expect(leftReference.numTimesShared == 0 && rightReference.numTimesShared == 0,
+                       "A reference render shared a path");
+
+                expectChannelsMatch(dualMono.output, 0, leftReference.output, "Left");
+                expectChannelsMatch(dualMono.output, 1, rightReference.output, "Right");
+
+                logMessage(juce::String(dualMonoCase.name) + ": shared a path "
+                            + juce::String(dualMono.numTimesShared) + " times");
+            }
+        }
+
+        testFreezeAfterClear();
+    }
+
+private:
+    // After a clear, only the left channel's delay line is written while the
+    // channels share a path. Freezing then must loop the left's audio, not
+    // give up because the stale right channel has nothing live.
+    void testFreezeAfterClear()
+    {
+        beginTest("Freeze after a clear, while dual mono");
+
+        AudioPluginAudioProcessor processor;
+        auto& apvts = processor.getAPVTS();
+
+        for (const auto& parameter : BASE_PARAMETERS)
+            setParameter(apvts, parameter.parameterID, parameter.value);
+
+        setParameter(apvts, "IS_PING_PONG_ON", 1.0f);
+        prepareProcessor(processor, SAMPLE_RATE, BLOCK_SIZE);
+
+        const int numBlocks = static_cast<int>(0.5 * SAMPLE_RATE) / BLOCK_SIZE;
+        NoiseGenerator noise { 1 };
+        juce::AudioBuffer<float> buffer(2, BLOCK_SIZE);
+        juce::MidiBuffer midi;
+        float frozenPeak = 0.0f;
+
+        for (int block = 0; block < 3 * numBlocks; block++)
+        {
+            // Ping pong off clears the delay, then dual-mono input runs one
+            // path for a while before freezing, and after that the input 
+            // is silent
+            if (block == numBlocks)
+                setParameter(apvts, "IS_PING_PONG_ON", 0.0f);
+
+            if (block == 2 * numBlocks)
+                setParameter(apvts, "IS_FREEZE_ON", 1.0f);
+
+            for (int i = 0; i < BLOCK_SIZE; i++)
+            {
+                const float sample = block < 2 * numBlocks ? noise.getNextSample(0.5f) : 0.0f;
+                buffer.setSample(0, i, sample);
+                buffer.setSample(1, i, sample);
+            }
+
+            processor.processBlock(buffer, midi);
+
+            if (block >= 2 * numBlocks)
+            {
+                for (int channel = 0; channel < 2; channel++)
+                    frozenPeak = std::max(frozenPeak, buffer.getMagnitude(channel, 0, BLOCK_SIZE));
+            }
+        }
+
+        expectGreaterThan(frozenPeak, 0.01f, "The frozen loop is silent");
+    }
+
+    Render render(const DualMonoCase& dualMonoCase, const std::vector<float>& left,
+                  const std::vector<float>& right, bool hasIrregularBlocks)
+    {
+        AudioPluginAudioProcessor processor;
+        auto& apvts = processor.getAPVTS();
+
+        for (const auto& parameter : BASE_PARAMETERS)
+            setParameter(apvts, parameter.parameterID, parameter.value);
+
+        for (const auto& parameter : dualMonoCase.parameters)
+            setParameter(apvts, parameter.parameterID, parameter.value);
+
+        if (dualMonoCase.automation != nullptr)
+            dualMonoCase.automation(apvts, 0.0);
+
+        prepareProcessor(processor, SAMPLE_RATE, BLOCK_SIZE);
+
+        // Path changes are counted from the trace
+        auto& traceRing = processor.getTraceRing();
+        traceRing.setEnabled(true);
+
+        const int numSamples = static_cast<int>(left.size());
+        Render result { juce::AudioBuffer<float>(2, numSamples), 0, 0 };
+        std::memcpy(result.output.getWritePointer(0), left.data(), left.size() * sizeof(float));
+        std::memcpy(result.output.getWritePointer(1), right.data(), right.size() * sizeof(float));
+
+        juce::MidiBuffer midi;
+        size_t blockIndex = 0;
+        std::int64_t lastTraceTime = 0;
+
+        for (int start = 0; start < numSamples; blockIndex++)
+        {
+            const int blockSize = hasIrregularBlocks
+                ? IRREGULAR_BLOCK_SIZES[blockIndex % std::size(IRREGULAR_BLOCK_SIZES)]
+                : BLOCK_SIZE;
+            const int blockSamples = std::min(blockSize, numSamples - start);
+
+            if (dualMonoCase.automation != nullptr)
+                dualMonoCase.automation(apvts, start / SAMPLE_RATE);
+
+            juce::AudioBuffer<float> block(result.output.getArrayOfWritePointers(), 2,
+                                           start, blockSamples);
+            processor.processBlock(block, midi);
+
+            start += blockSamples;
+
+            // Read the trace often enough that it never wraps
+            if (blockIndex % 256 == 255 || start == numSamples)
+                countPathChanges(traceRing, lastTraceTime, result);
+        }
+
+        return result;
+    }
+
+    void countPathChanges(const TraceRing& traceRing, std::int64_t& lastTraceTime,
+                          Render& result)
+    {
+        // Events up to the last read were counted then. A path change is
+        // never the first event of a block, so it can't share a timestamp
+        // with the last one read.
+        const std::int64_t countedUpTo = lastTraceTime;
+
+        for (const auto& event : traceRing.getSnapshot())
+        {
+            if (event.timestampNs <= countedUpTo)
+                continue;
+
+            lastTraceTime = event.timestampNs;
+
+            if (std::strcmp(event.name, "channels shared") == 0)
+                (event.value != 0 ? result.numTimesShared : result.numTimesUnshared)++;
+        }
+    }
+
+    void expectChannelsMatch(const juce::AudioBuffer<float>& output, int channel,
+                             const juce::AudioBuffer<float>& reference,
+                             const juce::String& channelName)
+    {
+        const auto* actual = output.getReadPointer(channel);
+        const auto* expected = reference.getReadPointer(channel);
+
+        for (int i = 0; i < output.getNumSamples(); i++)
+        {
+            if (std::memcmp(&actual[i], &expected[i], sizeof(float)) != 0)
+            {
+                expect(false, channelName + " channel differs from the normal path first at "
+                                "sample " + juce::String(i) + " (" + juce::String(actual[i])
+                                + " vs " + juce::String(expected[i]) + ")");
+                return;
+            }
+        }
+
+        expect(true);
+    }
+};
+
+
+static DualMonoTests dualMonoTests;
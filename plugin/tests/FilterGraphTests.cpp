@@ -0,0 +1,336 @@
+///
+///     @file FilterGraphTests.cpp
+///     @brief Tests for FilterGraph's schedule against hand-written loops.
+///     @date October 18, 2026
+///
+///     Each graph is checked against the same signal chain written out a
+///     sample at a time: serial filters, parallel paths mixed with gains,
+///     delays, a feedback comb, and the DelayEffect-shaped chain from the
+///     header. The result must not depend on how process() calls are split
+///     into blocks, or on the sub-blocks the graph splits them into.
+///
+
+#include "DelayPlugin/DSP/Diffuser.h"
+#include "DelayPlugin/DSP/FilterGraph.h"
+#include "DelayPlugin/DSP/OnePole.h"
+#include <juce_core/juce_core.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+
+namespace
+{
+    constexpr size_t NUM_SAMPLES = 4096;
+    constexpr size_t MAX_BLOCK_SIZE = 256;
+
+    // Sums are formed in the same order as the graph's, but a compiler
+    // may contract a * b + c differently in the two
+    constexpr float TOLERANCE = 1.0e-5f;
+
+    std::vector<float> makeNoise(size_t numSamples)
+    {
+        std::vector<float> noise(numSamples);
+        std::uint32_t state = 1;
+
+        for (auto& sample : noise)
+        {
+            state = state * 1664525u + 1013904223u;
+            sample = static_cast<float>(state >> 8) / 8388608.0f - 1.0f;
+        }
+
+        return noise;
+    }
+
+    // Run a one-in, one-out graph over input in process() calls of blockSize
+    std::vector<float> processGraph(FilterGraph<float>& graph, const std::vector<float>& input,
+                                    size_t blockSize)
+    {
+        std::vector<float> output(input.size());
+
+        for (size_t offset = 0; offset < input.size(); offset += blockSize)
+        {
+            const size_t n = std::min(blockSize, input.size() - offset);
+            const float* in = input.data() + offset;
+            float* out = output.data() + offset;
+            graph.process(&in, &out, n);
+        }
+
+        return output;
+    }
+}
+
+
+class FilterGraphTests : public juce::UnitTest
+{
+public:
+    FilterGraphTests() : juce::UnitTest("FilterGraph", "DSP")
+    {
+    }
+
+    void runTest() override
+    {
+        const auto input = makeNoise(NUM_SAMPLES);
+
+        beginTest("Serial filters run as if called directly");
+        {
+            OnePole<float> lowPass(FilterType::lowPass, 48000.0f, 2000.0f);
+            OnePole<float> highPass(FilterType::highPass, 48000.0f, 200.0f);
+
+            FilterGraph<float> graph;
+            const auto in = graph.addInput();
+            const auto low = graph.addFilter(lowPass);
+            const auto high = graph.addFilter(highPass);
+            const auto out = graph.addOutput();
+            graph.connect(in, low);
+            graph.connect(low, high);
+            graph.connect(high, out);
+            graph.compile(MAX_BLOCK_SIZE);
+
+            expectEquals(graph.getNumSteps(), size_t(4));
+
+            const auto output = processGraph(graph, input, MAX_BLOCK_SIZE);
+
+            OnePole<float> referenceLow(FilterType::lowPass, 48000.0f, 2000.0f);
+            OnePole<float> referenceHigh(FilterType::highPass, 48000.0f, 200.0f);
+
+            expectMatches(input, output, [&](float x) {
+                return referenceHigh.getNextSample(referenceLow.getNextSample(x));
+            });
+        }
+
+        beginTest("Parallel paths are mixed with their edge gains");
+        {
+            OnePole<float> lowPass(FilterType::lowPass, 48000.0f, 1000.0f);
+            OnePole<float> highPass(FilterType::highPass, 48000.0f, 1000.0f);
+
+            FilterGraph<float> graph;
+            const auto in = graph.addInput();
+            const auto low = graph.addFilter(lowPass);
+            const auto high = graph.addFilter(highPass);
+            const auto out = graph.addOutput();
+            graph.connect(in, low);
+            graph.connect(in, high);
+            const auto lowEdge = graph.connect(low, out, 0.25f);
+            graph.connect(high, out, 0.75f);
+            graph.compile(MAX_BLOCK_SIZE);
+
+            auto output = processGraph(graph, input, MAX_BLOCK_SIZE);
+
+            OnePole<float> referenceLow(FilterType::lowPass, 48000.0f, 1000.0f);
+            OnePole<float> referenceHigh(FilterType::highPass, 48000.0f, 1000.0f);
+
+            expectMatches(input, output, [&](float x) {
+                return 0.25f * referenceLow.getNextSample(x) + 0.75f * referenceHigh.getNextSample(x);
+            });
+
+            // A gain change takes effect on the next process()
+            graph.setGain(lowEdge, 0.5f);
+            output = processGraph(graph, input, MAX_BLOCK_SIZE);
+
+            expectMatches(input, output, [&](float x) {
+                return 0.5f * referenceLow.getNextSample(x) + 0.75f * referenceHigh.getNextSample(x);
+            });
+        }
+
+        beginTest("A delay outputs its input from delay samples ago");
+        {
+            for (size_t delay : { size_t(1), size_t(37), size_t(300) })
+            {
+                FilterGraph<float> graph;
+                const auto in = graph.addInput();
+                const auto line = graph.addDelay(512);
+                const auto out = graph.addOutput();
+                graph.connect(in, line);
+                graph.connect(line, out);
+                graph.compile(MAX_BLOCK_SIZE);
+                graph.setDelay(line, delay);
+
+                const auto output = processGraph(graph, input, MAX_BLOCK_SIZE);
+
+                for (size_t i = 0; i < output.size(); i++)
+                {
+                    const float expected = i < delay ? 0.0f : input[i - delay];
+
+                    if (output[i] != expected)
+                    {
+                        expect(false, "Delay " + juce::String(delay) + " is wrong at sample "
+                                        + juce::String(i));
+                        break;
+                    }
+                }
+            }
+        }
+
+        beginTest("A feedback comb, in any block size");
+        {
+            constexpr size_t delay = 100;
+            constexpr float feedback = 0.7f;
+
+            // s[n] = x[n] + feedback * s[n - delay], out[n] = s[n - delay]
+            std::vector<float> reference(input.size());
+            std::vector<float> written(input.size());
+
+            for (size_t i = 0; i < input.size(); i++)
+            {
+                const float delayed = i < delay ? 0.0f : written[i - delay];
+                written[i] = 1.0f * input[i] + feedback * delayed;
+                reference[i] = delayed;
+            }
+
+            for (size_t blockSize : { size_t(1), size_t(64), size_t(100), size_t(1000) })
+            {
+                FilterGraph<float> graph;
+                const auto in = graph.addInput();
+                const auto sum = graph.addMixer();
+                const auto line = graph.addDelay(delay);
+                const auto out = graph.addOutput();
+                graph.connect(in, sum);
+                graph.connect(line, sum, feedback);
+                graph.connect(sum, line);
+                graph.connect(line, out);
+                graph.compile(MAX_BLOCK_SIZE);
+
+                const auto output = processGraph(graph, input, blockSize);
+
+                expectWithin(output, reference, "block size " + juce::String(blockSize));
+            }
+        }
+
+        beginTest("The DelayEffect chain from the header");
+        {
+            testDelayEffectChain(input);
+        }
+
+        beginTest("A cycle without a delay is rejected");
+        {
+            OnePole<float> filter;
+
+            FilterGraph<float> graph;
+            const auto in = graph.addInput();
+            const auto sum = graph.addMixer();
+            const auto node = graph.addFilter(filter);
+            graph.connect(in, sum);
+            graph.connect(sum, node);
+            graph.connect(node, sum, 0.5f);
+
+            expectThrowsInvalidArgument([&] { graph.compile(MAX_BLOCK_SIZE); });
+            expect(! graph.isCompiled());
+        }
+
+        beginTest("Bad nodes and edges are rejected");
+        {
+            FilterGraph<float> graph;
+            const auto in = graph.addInput();
+            const auto out = graph.addOutput();
+
+            expectThrowsInvalidArgument([&] { graph.addDelay(0); });
+            expectThrowsInvalidArgument([&] { graph.connect(out, in); });
+            expectThrowsInvalidArgument([&] { graph.connect(in, 99); });
+            expectThrowsInvalidArgument([&] { graph.compile(0); });
+        }
+    }
+
+private:
+    // in -> delay -> loopFilter -> (diffuser crossfade) -> wet -> delay,
+    // with a dry/wet mix to the output
+    void testDelayEffectChain(const std::vector<float>& input)
+    {
+        constexpr size_t delay = 480;
+        constexpr float feedback = 0.6f;
+        constexpr float diffusion = 0.4f;
+        constexpr float mix = 0.5f;
+
+        const std::vector<unsigned int> lengths { 225, 556, 441, 341 };
+        const std::vector<float> gains { 0.5f, 0.5f, 0.5f, 0.5f };
+
+        OnePole<float> loopFilter(FilterType::lowPass, 48000.0f, 3000.0f);
+        Diffuser<float> diffuser(4, lengths, gains);
+
+        FilterGraph<float> graph;
+        const auto in = graph.addInput();
+        const auto line = graph.addDelay(delay);
+        const auto filterNode = graph.addFilter(loopFilter);
+        const auto diffuserNode = graph.addFilter(diffuser);
+        const auto wet = graph.addMixer();
+        const auto out = graph.addOutput();
+        graph.connect(in, line);
+        graph.connect(line, filterNode);
+        graph.connect(filterNode, diffuserNode);
+        graph.connect(filterNode, wet, 1.0f - diffusion);
+        graph.connect(diffuserNode, wet, diffusion);
+        graph.connect(wet, line, feedback);
+        graph.connect(in, out, 1.0f - mix);
+        graph.connect(wet, out, mix);
+        graph.compile(MAX_BLOCK_SIZE);
+
+        const auto output = processGraph(graph, input, 128);
+
+        OnePole<float> referenceFilter(FilterType::lowPass, 48000.0f, 3000.0f);
+        Diffuser<float> referenceDiffuser(4, lengths, gains);
+        std::vector<float> written(input.size());
+        std::vector<float> reference(input.size());
+
+        for (size_t i = 0; i < input.size(); i++)
+        {
+            const float delayed = i < delay ? 0.0f : written[i - delay];
+            const float filtered = referenceFilter.getNextSample(delayed);
+            const float diffused = referenceDiffuser.getNextSample(filtered);
+            const float wetSample = (1.0f - diffusion) * filtered + diffusion * diffused;
+
+            written[i] = 1.0f * input[i] + feedback * wetSample;
+            reference[i] = (1.0f - mix) * input[i] + mix * wetSample;
+        }
+
+        expectWithin(output, reference, "DelayEffect chain");
+    }
+
+    // Check output against reference() run on each input sample in turn
+    void expectMatches(const std::vector<float>& input, const std::vector<float>& output,
+                       const std::function<float(float)>& reference)
+    {
+        std::vector<float> expected(output.size());
+
+        for (size_t i = 0; i < output.size(); i++)
+            expected[i] = reference(input[i]);
+
+        expectWithin(output, expected, "serial/parallel chain");
+    }
+
+    void expectWithin(const std::vector<float>& output, const std::vector<float>& expected,
+                      const juce::String& what)
+    {
+        for (size_t i = 0; i < output.size(); i++)
+        {
+            if (std::abs(output[i] - expected[i]) > TOLERANCE)
+            {
+                expect(false, what + " differs at sample " + juce::String(i) + ": "
+                                + juce::String(output[i]) + " vs " + juce::String(expected[i]));
+                return;
+            }
+        }
+    }
+
+    template<typename Function>
+    void expectThrowsInvalidArgument(Function&& function)
+    {
+        bool hasThrown = false;
+
+        try
+        {
+            function();
+        }
+        catch (const std::invalid_argument&)
+        {
+            hasThrown = true;
+        }
+
+        expect(hasThrown, "Expected std::invalid_argument");
+    }
+};
+
+
+static FilterGraphTests filterGraphTests;
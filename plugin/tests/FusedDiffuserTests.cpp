@@ -0,0 +1,308 @@
+///
+///     @file FusedDiffuserTests.cpp
+///     @brief Tests for FusedDiffuser's stage layout and reconfiguration.
+///     @date October 18, 2026
+///
+///     Diffuser (a chain of separate Schroeder sections) is the reference:
+///     with the same stage lengths and gains, the fused ring must give the
+///     same output bit for bit, however it got to those lengths (sample 
+///     rate, setDelayLengths(), setLengthScale() or setLayout()). The
+///     reference's own setDelayLengths() is checked as well, and so is a
+///     Schroeder section with a fixed Capacity against a run-time sized one.
+///
+
+#include "DelayPlugin/DSP/Diffuser.h"
+#include "DelayPlugin/DSP/FusedDiffuser.h"
+#include <juce_core/juce_core.h>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+
+namespace
+{
+    const std::vector<unsigned int> FREEVERB_LENGTHS { 225, 556, 441, 341 };
+    const std::vector<float> FREEVERB_GAINS { 0.5f, 0.5f, 0.5f, 0.5f };
+
+    constexpr int NUM_SAMPLES = 8192;
+
+    std::vector<float> makeNoise(int numSamples)
+    {
+        std::vector<float> noise(static_cast<size_t>(numSamples));
+        std::uint32_t state = 1;
+
+        for (auto& sample : noise)
+        {
+            state = state * 1664525u + 1013904223u;
+            sample = static_cast<float>(state >> 8) / 8388608.0f - 1.0f;
+        }
+
+        return noise;
+    }
+
+    template<typename Filter>
+    std::vector<float> process(Filter& filter, const std::vector<float>& input)
+    {
+        std::vector<float> output(input.size());
+
+        for (size_t i = 0; i < input.size(); i++)
+            output[i] = filter.getNextSample(input[i]);
+
+        return output;
+    }
+
+    bool isBitIdentical(const std::vector<float>& a, const std::vector<float>& b)
+    {
+        return a.size() == b.size() 
+                && std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+    }
+
+    // Stage lengths FusedDiffuser should end up with at a sample rate
+    std::vector<unsigned int> scaleLengths(const std::vector<unsigned int>& lengths, 
+                                           double scale)
+    {
+        std::vector<unsigned int> scaled;
+
+        for (unsigned int length : lengths)
+            scaled.push_back(static_cast<unsigned int>(std::lround(length * scale)));
+
+        return scaled;
+    }
+
+    std::vector<unsigned int> getDelaySamples(const FusedDiffuser<float>& diffuser)
+    {
+        std::vector<unsigned int> lengths;
+
+        for (size_t stage = 0; stage < diffuser.getNumStages(); stage++)
+            lengths.push_back(diffuser.getDelaySamples(stage));
+
+        return lengths;
+    }
+
+    // Output of a Diffuser with the given lengths and the Freeverb gains, 
+    // from empty
+    std::vector<float> processReference(const std::vector<unsigned int>& lengths, 
+                                        const std::vector<float>& input)
+    {
+        std::vector<float> gains(lengths.size(), 0.5f);
+        Diffuser<float> reference(static_cast<unsigned int>(lengths.size()), 
+                                  lengths, gains);
+
+        return process(reference, input);
+    }
+}
+
+
+class FusedDiffuserTests : public juce::UnitTest
+{
+public:
+    FusedDiffuserTests() : juce::UnitTest("FusedDiffuser", "DSP")
+    {
+    }
+
+    void runTest() override
+    {
+        const auto input = makeNoise(NUM_SAMPLES);
+
+        beginTest("Matches a Diffuser at the reference rate");
+        {
+            FusedDiffuser<float> diffuser(FREEVERB_LENGTHS, FREEVERB_GAINS);
+            diffuser.setSampleRate(44100.0f);
+
+            expect(getDelaySamples(diffuser) == FREEVERB_LENGTHS);
+            expect(isBitIdentical(process(diffuser, input), 
+                                  processReference(FREEVERB_LENGTHS, input)));
+        }
+
+        beginTest("Stage lengths scale with the sample rate");
+        {
+            FusedDiffuser<float> diffuser(FREEVERB_LENGTHS, FREEVERB_GAINS);
+
+            for (float sampleRate : { 48000.0f, 88200.0f, 96000.0f, 192000.0f, 22050.0f })
+            {
+                diffuser.setSampleRate(sampleRate);
+                const auto lengths = scaleLengths(FREEVERB_LENGTHS, sampleRate / 44100.0);
+
+                expect(getDelaySamples(diffuser) == lengths, 
+                       "Wrong stage lengths at " + juce::String(sampleRate) + " Hz");
+                expect(isBitIdentical(process(diffuser, input), processReference(lengths, input)),
+                       "Output differs at " + juce::String(sampleRate) + " Hz");
+            }
+        }
+
+        beginTest("setDelayLengths() reconfigures a running diffuser");
+        {
+            FusedDiffuser<float> diffuser(FREEVERB_LENGTHS, FREEVERB_GAINS);
+            diffuser.setSampleRate(48000.0f);
+            process(diffuser, input);
+
+            // Longer and shorter stages than before; the ring is cleared
+            const std::vector<unsigned int> newLengths { 1000, 3, 700, 1 };
+            diffuser.setDelayLengths(newLengths);
+
+            const auto lengths = scaleLengths(newLengths, 48000.0 / 44100.0);
+            expect(getDelaySamples(diffuser) == lengths);
+            expect(isBitIdentical(process(diffuser, input), processReference(lengths, input)));
+
+            // Then back to the reference rate, which keeps the new lengths
+            diffuser.setSampleRate(44100.0f);
+            expect(getDelaySamples(diffuser) == newLengths);
+            expect(isBitIdentical(process(diffuser, input), processReference(newLengths, input)));
+        }
+
+        beginTest("Diffuser::setDelayLengths() grows its stages");
+        {
+            // The first echo is one sample after the delay, as for a new
+            // Diffuser. 256 needs a 512-sample ring; a 256-sample one wraps
+            // the read onto the sample just written, so the echo comes at 1.
+            Diffuser<float> diffuser(1, { 225 }, { 0.5f });
+            diffuser.setDelayLengths({ 256 });
+
+            std::vector<float> impulse(1024, 0.0f);
+            impulse[0] = 1.0f;
+            const auto output = process(diffuser, impulse);
+
+            for (size_t i = 1; i < 257; i++)
+            {
+                if (output[i] != 0.0f)
+                {
+                    expect(false, "Echo at sample " + juce::String(i) + " instead of 257");
+                    break;
+                }
+            }
+
+            expect(output[257] != 0.0f, "No echo at sample 257");
+
+            // Every stage, against a Diffuser built with the new lengths
+            const std::vector<unsigned int> newLengths { 256, 1024, 512, 2048 };
+            Diffuser<float> grown(4, FREEVERB_LENGTHS, FREEVERB_GAINS);
+            grown.setDelayLengths(newLengths);
+
+            expect(isBitIdentical(process(grown, input), processReference(newLengths, input)));
+        }
+
+        beginTest("A fixed-capacity Schroeder matches a run-time sized one");
+        {
+            Schroeder<float> sized(225, 0.5f);
+            Schroeder<float, 256> fixed(225, 0.5f);
+
+            expect(isBitIdentical(process(fixed, input), process(sized, input)));
+
+            // It can shorten its delay, but not grow past Capacity
+            sized.setDelaySamples(100);
+            fixed.setDelaySamples(100);
+            expect(isBitIdentical(process(fixed, input), process(sized, input)));
+
+            expectThrowsInvalidArgument([&] { fixed.setDelaySamples(256); });
+            expectThrowsInvalidArgument([&] { Schroeder<float, 256>(256, 0.5f); });
+        }
+
+        beginTest("setDelayLengths() rejects bad lengths");
+        {
+            FusedDiffuser<float> diffuser(FREEVERB_LENGTHS, FREEVERB_GAINS);
+            diffuser.setSampleRate(44100.0f);
+
+            const std::vector<unsigned int> tooFew { 100, 200 };
+            const std::vector<unsigned int> zeroLength { 100, 0, 200, 300 };
+
+            expectThrowsInvalidArgument([&] { diffuser.setDelayLengths(tooFew); });
+            expectThrowsInvalidArgument([&] { diffuser.setDelayLengths(zeroLength); });
+
+            // and leaves the diffuser as it was
+            expect(getDelaySamples(diffuser) == FREEVERB_LENGTHS);
+        }
+
+        beginTest("setLengthScale() scales every stage");
+        {
+            FusedDiffuser<float> diffuser(FREEVERB_LENGTHS, FREEVERB_GAINS);
+            diffuser.setSampleRate(96000.0f);
+            diffuser.setLengthScale(1.5f);
+
+            const auto lengths = scaleLengths(FREEVERB_LENGTHS, 96000.0 * 1.5 / 44100.0);
+            expect(getDelaySamples(diffuser) == lengths);
+            expect(isBitIdentical(process(diffuser, input), processReference(lengths, input)));
+
+            expectThrowsInvalidArgument([&] { diffuser.setLengthScale(0.0f); });
+        }
+
+        beginTest("setLayout() runs in the memory it is given");
+        {
+            FusedDiffuser<float> diffuser(FREEVERB_LENGTHS, FREEVERB_GAINS);
+            diffuser.setSampleRate(44100.0f);
+
+            const size_t ringBytes = diffuser.getRingBytes(48000.0f, 0.5f);
+            expect(ringBytes % FusedDiffuser<float>::RING_ALIGNMENT == 0);
+
+            // Filled with garbage, which setLayout() has to clear
+            std::vector<float> ring(ringBytes / sizeof(float), 123.0f);
+            diffuser.setLayout(48000.0f, 0.5f, ring.data());
+
+            expectEquals(diffuser.getMemoryBytes(), size_t(0), 
+                         "The diffuser should no longer own a ring");
+
+            const auto lengths = scaleLengths(FREEVERB_LENGTHS, 48000.0 * 0.5 / 44100.0);
+            expect(getDelaySamples(diffuser) == lengths);
+            expect(isBitIdentical(process(diffuser, input), processReference(lengths, input)));
+        }
+
+        beginTest("Any number of stages up to MAX_STAGES");
+        {
+            for (size_t numStages : { size_t(1), size_t(2), FusedDiffuser<float>::MAX_STAGES })
+            {
+                std::vector<unsigned int> lengths;
+                
+                for (size_t stage = 0; stage < numStages; stage++)
+                    lengths.push_back(static_cast<unsigned int>(101 + 37 * stage));
+
+                const std::vector<float> gains(numStages, 0.5f);
+                FusedDiffuser<float> diffuser(lengths, gains);
+                diffuser.setSampleRate(44100.0f);
+
+                expectEquals(diffuser.getNumStages(), numStages);
+                expect(isBitIdentical(process(diffuser, input), processReference(lengths, input)),
+                       "Output differs with " + juce::String(numStages) + " stages");
+            }
+
+            const std::vector<unsigned int> tooMany(FusedDiffuser<float>::MAX_STAGES + 1, 100);
+            const std::vector<float> gains(tooMany.size(), 0.5f);
+
+            expectThrowsInvalidArgument([&] { FusedDiffuser<float> diffuser(tooMany, gains); });
+        }
+
+        beginTest("Passes the energy of an impulse (all-pass)");
+        {
+            FusedDiffuser<float> diffuser(FREEVERB_LENGTHS, FREEVERB_GAINS);
+            diffuser.setSampleRate(96000.0f);
+
+            double energy = 0.0;
+
+            for (int i = 0; i < 1 << 17; i++)
+            {
+                const double y = diffuser.getNextSample(i == 0 ? 1.0f : 0.0f);
+                energy += y * y;
+            }
+
+            expectWithinAbsoluteError(energy, 1.0, 1.0e-3);
+        }
+    }
+
+private:
+    template<typename Function>
+    void expectThrowsInvalidArgument(Function&& function)
+    {
+        bool hasThrown = false;
+
+        try
+        {
+            function();
+        }
+        catch (const std::invalid_argument&)
+        {
+            hasThrown = true;
+        }
+
+        expect(hasThrown, "Expected std::invalid_argument");
+    }
+};
+
+static FusedDiffuserTests fusedDiffuserTests;
@@ -0,0 +1,394 @@
+///
+///     @file FuzzTests.cpp
+///     @brief Randomised stress tests over block sizes, sample rates and
+///            parameter jumps.
+///     @date October 18, 2026
+///
+///     Each seed plays a processor the way an unkind host would: sample
+///     rates from 8 kHz to 384 kHz, changed part way through (release and
+///     prepare again), blocks of 0, 1 and up to 8192 samples that change
+///     from block to block, the host's bypass, and every parameter jumping
+///     to its limits or anywhere in between, toggles included. The input
+///     switches between noise, full-scale square waves, DC, silence and
+///     denormal-level noise. Every output sample must be finite and within
+///     MAX_OUTPUT_MAGNITUDE, so a runaway loop fails as well as a NaN. An
+///     empty block carrying parameter changes ahead of each block must
+///     leave the output bit for bit as it was.
+///
+///     Out-of-range reads only show up under a sanitizer: configure with
+///     -DDELAY_PLUGIN_ENABLE_SANITIZERS=ON and run "DelayPluginTests Fuzz".
+///
+///     The timing checks are in TimingTests.cpp, which only runs on
+///     request.
+///
+///     Also logged: memory per instance at each rate in each mode, for
+///     capacity planning.
+///
+
+#include "TestUtilities.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <span>
+#include <vector>
+
+
+namespace
+{
+    constexpr double SAMPLE_RATES[] = { 8000.0, 22050.0, 44100.0, 48000.0, 88200.0,
+                                        96000.0, 176400.0, 192000.0, 352800.0, 384000.0 };
+    constexpr int MAX_BLOCK_SIZE = 8192;
+
+    // Fixed, so a failure can be reproduced. Small seeds make juce::Random
+    // start out with small numbers.
+    constexpr juce::int64 SEEDS[] = { 0x2f6b1a3c, 0x51d0e7a9, 0x7c3e9b42, 0x13a8f5d6 };
+
+    // Rates played per seed, and seconds of audio at each
+    constexpr int NUM_RATES_PER_SEED = 3;
+    constexpr double SECONDS_PER_RATE = 0.5;
+
+    // Chance, per block, of each parameter jumping
+    constexpr float PARAMETER_JUMP_CHANCE = 0.03f;
+
+    // Largest output magnitude allowed. Full-scale input recirculating at
+    // the highest feedback (0.99) builds up to about 100 times the input;
+    // anything far past that is a loop running away.
+    constexpr float MAX_OUTPUT_MAGNITUDE = 1000.0f;
+
+    const char* const PARAMETER_IDS[] = {
+        "DELAY_TIME", "FEEDBACK", "MIX", "IS_PING_PONG_ON", "IS_BYPASS_ON",
+        "BYPASS_TRAILS", "LOOP_FILTER_CUTOFF", "LOOP_FILTER_TYPE",
+        "LOOP_FILTER_RESONANCE", "DIFFUSION", "DIFFUSION_SIZE", "SATURATION_TYPE",
+        "SATURATION_DRIVE", "IS_REVERSE_ON", "IS_FREEZE_ON", "IS_SPECTRAL_ON",
+        "SPECTRAL_DELAY_TILT", "SPECTRAL_FEEDBACK_TILT"
+    };
+
+    // Parameters that never change how much delay memory is in use. Memory
+    // arrives from the pool's thread a block or more after it is asked
+    // for, so renders that change the others can't be compared bit for bit.
+    const char* const MEMORY_NEUTRAL_PARAMETER_IDS[] = {
+        "FEEDBACK", "MIX", "IS_PING_PONG_ON", "BYPASS_TRAILS", "LOOP_FILTER_CUTOFF",
+        "LOOP_FILTER_TYPE", "LOOP_FILTER_RESONANCE", "SATURATION_TYPE", "SATURATION_DRIVE"
+    };
+
+    enum class InputType { noise, square, dc, silence, denormal, numTypes };
+
+    struct ParameterValue
+    {
+        const char* parameterID;
+        float value;
+    };
+
+    void setParameters(juce::AudioProcessorValueTreeState& apvts,
+                       const std::vector<ParameterValue>& parameters)
+    {
+        for (const auto& parameter : parameters)
+            setParameter(apvts, parameter.parameterID, parameter.value);
+    }
+
+    // Fill a block with one kind of input. phase carries the square wave
+    // across blocks.
+    void fillInput(juce::AudioBuffer<float>& block, InputType type,
+                   juce::Random& random, int& phase)
+    {
+        for (int channel = 0; channel < block.getNumChannels(); channel++)
+        {
+            float* data = block.getWritePointer(channel);
+
+            for (int i = 0; i < block.getNumSamples(); i++)
+            {
+                switch (type)
+                {
+                    case InputType::noise:
+                        data[i] = random.nextFloat() * 2.0f - 1.0f;
+                        break;
+
+                    case InputType::square:
+                        data[i] = (phase + i) % 100 < 50 ? 1.0f : -1.0f;
+                        break;
+
+                    case InputType::dc:
+                        data[i] = 1.0f;
+                        break;
+
+                    case InputType::silence:
+                    case InputType::numTypes:
+                        data[i] = 0.0f;
+                        break;
+
+                    // Smaller than the smallest normal float (about 1.2e-38)
+                    case InputType::denormal:
+                        data[i] = (random.nextFloat() * 2.0f - 1.0f) * 1.0e-39f;
+                        break;
+                }
+            }
+        }
+
+        phase += block.getNumSamples();
+    }
+
+    // Mostly any size up to the maximum, but with plenty of the sizes
+    // hosts get wrong: empty, 1 sample, and small odd sizes
+    int nextBlockSize(juce::Random& random)
+    {
+        const int choice = random.nextInt(20);
+
+        if (choice == 0)
+            return 0;
+
+        if (choice < 4)
+            return 1;
+
+        if (choice < 8)
+            return 1 + random.nextInt(31);
+
+        return 1 + random.nextInt(MAX_BLOCK_SIZE);
+    }
+
+    // Jump some parameters: to one end of their range or the other, or
+    // anywhere in between
+    void jumpParameters(juce::AudioProcessorValueTreeState& apvts, juce::Random& random,
+                        std::span<const char* const> parameterIDs = PARAMETER_IDS)
+    {
+        for (const char* parameterID : parameterIDs)
+        {
+            if (random.nextFloat() >= PARAMETER_JUMP_CHANCE)
+                continue;
+
+            const int choice = random.nextInt(3);
+            const float value = choice == 0 ? 0.0f : choice == 1 ? 1.0f : random.nextFloat();
+
+            apvts.getParameter(parameterID)->setValueNotifyingHost(value);
+        }
+    }
+
+    juce::AudioBuffer<float> makeNoise(int numSamples, float amplitude, juce::int64 seed)
+    {
+        juce::AudioBuffer<float> buffer(2, numSamples);
+        juce::Random random(seed);
+
+        for (int channel = 0; channel < 2; channel++)
+        {
+            for (int i = 0; i < numSamples; i++)
+                buffer.setSample(channel, i, amplitude * (random.nextFloat() * 2.0f - 1.0f));
+        }
+
+        return buffer;
+    }
+}
+
+
+class FuzzTests : public juce::UnitTest
+{
+public:
+    FuzzTests() : juce::UnitTest("Fuzz", "Fuzz")
+    {
+    }
+
+    void runTest() override
+    {
+        for (juce::int64 seed : SEEDS)
+            testRandomised(seed);
+
+        testEmptyBlocks();
+        reportMemory();
+    }
+
+private:
+    void testRandomised(juce::int64 seed)
+    {
+        beginTest("Randomised, seed 0x" + juce::String::toHexString(seed));
+
+        juce::Random random(seed);
+        AudioPluginAudioProcessor processor;
+        auto& apvts = processor.getAPVTS();
+        juce::AudioBuffer<float> buffer(2, MAX_BLOCK_SIZE);
+        juce::MidiBuffer midi;
+        int phase = 0;
+
+        for (int rateIndex = 0; rateIndex < NUM_RATES_PER_SEED; rateIndex++)
+        {
+            const double sampleRate = SAMPLE_RATES[random.nextInt(
+                                        static_cast<int>(std::size(SAMPLE_RATES)))];
+            const int numSamples = static_cast<int>(SECONDS_PER_RATE * sampleRate);
+
+            // A rate change, as hosts do it
+            if (rateIndex > 0)
+                processor.releaseResources();
+
+            prepareProcessor(processor, sampleRate, MAX_BLOCK_SIZE);
+
+            auto inputType = InputType::noise;
+            float peak = 0.0f;
+
+            for (int processed = 0; processed < numSamples; )
+            {
+                const int blockSize = std::min(nextBlockSize(random), numSamples - processed);
+
+                if (random.nextInt(50) == 0)
+                    inputType = static_cast<InputType>(random.nextInt(static_cast<int>(InputType::numTypes)));
+
+                jumpParameters(apvts, random);
+
+                juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), 2, 0, blockSize);
+                fillInput(block, inputType, random, phase);
+
+                if (random.nextInt(200) == 0)
+                    processor.processBlockBypassed(block, midi);
+                else
+                    processor.processBlock(block, midi);
+
+                if (! expectValidOutput(block, sampleRate, processed, peak))
+                    return;
+
+                processed += blockSize;
+            }
+
+            logMessage(juce::String(sampleRate / 1000.0, 1) + " kHz: peak output "
+                        + juce::String(peak, 2));
+        }
+    }
+
+    void testEmptyBlocks()
+    {
+        beginTest("Empty blocks change nothing");
+
+        // Hosts pass parameter changes in empty blocks. One in front of
+        // every block, seeing the block's changes first, must leave the
+        // output bit for bit as it was.
+        const std::vector<ParameterValue> parameters {
+            { "DELAY_TIME", 30.0f }, { "FEEDBACK", 0.7f }, { "MIX", 0.5f },
+            { "BYPASS_TRAILS", 1.0f }, { "LOOP_FILTER_TYPE", 3.0f },
+            { "DIFFUSION", 0.5f }, { "SATURATION_TYPE", 2.0f }
+        };
+
+        const auto input = makeNoise(48000, 0.5f, 1);
+        const auto withoutEmpty = renderWithChanges(parameters, input, false);
+        const auto withEmpty = renderWithChanges(parameters, input, true);
+
+        for (int channel = 0; channel < 2; channel++)
+        {
+            const float* expected = withoutEmpty.getReadPointer(channel);
+            const float* actual = withEmpty.getReadPointer(channel);
+
+            const bool isSame = std::memcmp(expected, actual, static_cast<size_t>(input.getNumSamples())
+                                                                * sizeof(float)) == 0;
+            expect(isSame, "Empty blocks changed channel " + juce::String(channel));
+        }
+    }
+
+    // Render at 48 kHz in blocks of 64, jumping parameters every few blocks
+    // and bypassing for a moment now and then, optionally with an empty
+    // block first each time. The bypass is off again before it has faded
+    // out, so its memory is never given back.
+    juce::AudioBuffer<float> renderWithChanges(const std::vector<ParameterValue>& parameters,
+                                               const juce::AudioBuffer<float>& input,
+                                               bool hasEmptyBlocks)
+    {
+        constexpr int blockSize = 64;
+
+        AudioPluginAudioProcessor processor;
+        auto& apvts = processor.getAPVTS();
+        setParameters(apvts, parameters);
+        prepareProcessor(processor, 48000.0, blockSize);
+
+        juce::Random random(2);
+        auto output = input;
+        juce::MidiBuffer midi;
+
+        for (int start = 0; start + blockSize <= output.getNumSamples(); start += blockSize)
+        {
+            const int blockIndex = start / blockSize;
+
+            if (blockIndex % 4 == 0)
+                jumpParameters(apvts, random, MEMORY_NEUTRAL_PARAMETER_IDS);
+
+            setParameter(apvts, "IS_BYPASS_ON", blockIndex % 32 < 4 ? 1.0f : 0.0f);
+
+            if (hasEmptyBlocks)
+            {
+                juce::AudioBuffer<float> empty(output.getArrayOfWritePointers(), 2, start, 0);
+                processor.processBlock(empty, midi);
+            }
+
+            juce::AudioBuffer<float> block(output.getArrayOfWritePointers(), 2, start, blockSize);
+            processor.processBlock(block, midi);
+        }
+
+        return output;
+    }
+
+    void reportMemory()
+    {
+        beginTest("Memory per instance");
+
+        // At the default delay time, with the largest diffusers
+        struct Mode
+        {
+            const char* name;
+            std::vector<ParameterValue> parameters;
+        };
+
+        const Mode modes[] = {
+            { "forward", {} },
+            { "reverse", { { "IS_REVERSE_ON", 1.0f } } },
+            { "spectral", { { "IS_SPECTRAL_ON", 1.0f } } }
+        };
+
+        logMessage("rate       forward   reverse   spectral  (KiB)");
+
+        for (double sampleRate : SAMPLE_RATES)
+        {
+            juce::String line = juce::String(sampleRate / 1000.0, 1).paddedRight(' ', 10);
+
+            for (const auto& mode : modes)
+            {
+                AudioPluginAudioProcessor processor;
+                auto& apvts = processor.getAPVTS();
+                setParameter(apvts, "DIFFUSION", 0.5f);
+                setParameter(apvts, "DIFFUSION_SIZE", 2.0f);
+                setParameters(apvts, mode.parameters);
+                prepareProcessor(processor, sampleRate, 512);
+
+                const size_t bytes = processor.getMemoryUsageBytes();
+                expect(bytes > 0, juce::String("No memory in ") + mode.name + " mode");
+
+                line << juce::String(static_cast<int>(bytes / 1024)).paddedRight(' ', 10);
+            }
+
+            logMessage(line);
+        }
+    }
+
+    // Every sample finite and within MAX_OUTPUT_MAGNITUDE. Keeps the peak.
+    bool expectValidOutput(const juce::AudioBuffer<float>& block, double sampleRate,
+                           int position, float& peak)
+    {
+        for (int channel = 0; channel < block.getNumChannels(); channel++)
+        {
+            const float* data = block.getReadPointer(channel);
+
+            for (int i = 0; i < block.getNumSamples(); i++)
+            {
+                const bool isFinite = std::isfinite(data[i]);
+
+                if (! isFinite || std::abs(data[i]) > MAX_OUTPUT_MAGNITUDE)
+                {
+                    expect(false, juce::String(isFinite ? "Runaway" : "Non-finite")
+                                    + " output (" + juce::String(data[i]) + ") at "
+                                    + juce::String(sampleRate) + " Hz, sample "
+                                    + juce::String(position + i) + " of channel "
+                                    + juce::String(channel));
+                    return false;
+                }
+
+                peak = std::max(peak, std::abs(data[i]));
+            }
+        }
+
+        return true;
+    }
+};
+
+
+static FuzzTests fuzzTests;
@@ -0,0 +1,511 @@
+///
+///     @file GoldenOutputTests.cpp
+///     @brief Golden-output regression tests for the delay.
+///     @date October 18, 2026
+///
+///     A fixed corpus of test signals (impulses, a sine sweep, noise 
+///     bursts, parameter automation) is rendered through the processor in 
+///     each mode and compared with the reference renders in reference/. 
+///     A change that is meant to leave the sound alone (a speedup, a 
+///     refactor) must pass these as they are; one that changes the sound 
+///     on purpose regenerates them (DelayPluginTests --regenerate) in the 
+///     same commit.
+///
+///     Each case has its own tolerance. Paths that are plain arithmetic 
+///     (the delay lines, ping pong, diffusion, the state variable filters, 
+///     saturation, freeze, bypass) must match bit for bit. Paths whose 
+///     coefficients come from libm (exp() in the one-pole coefficient 
+///     table, sin()/cos() in the reverse windows and the FFT) may differ 
+///     by an ULP or so between C libraries, and are allowed an error below
+///     a level in dBFS. Every case logs a one-line diff report either way.
+///
+///     The references are x86-64 renders (SSE2, no FMA contraction), which
+///     every x86-64 compiler should reproduce. Elsewhere compilers may fuse
+///     multiplies and adds, so the bit-exact cases get a tolerance too.
+///
+///     Reference files are raw little-endian float32, the left channel's 
+///     samples followed by the right's.
+///
+
+#include "TestUtilities.h"
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+
+
+namespace
+{
+    constexpr double SAMPLE_RATE = 44100.0;
+    constexpr int NUM_SAMPLES = 8192;
+    constexpr int BLOCK_SIZE = 256;
+
+    // Block sizes cycled through by the irregular-block cases
+    constexpr int IRREGULAR_BLOCK_SIZES[] = { 1, 7, 64, 333, 512, 2, 128 };
+
+#if defined(__x86_64__) || defined(_M_X64)
+    constexpr bool CAN_MATCH_BIT_FOR_BIT = true;
+#else
+    constexpr bool CAN_MATCH_BIT_FOR_BIT = false;
+#endif
+
+    // Allowed error for the bit-exact cases where they cannot be (see above)
+    constexpr double NON_X86_ERROR_DB = -120.0;
+
+    enum class Signal
+    {
+        impulse,        // a different impulse in each channel
+        sweep,          // exponential sine sweep, 90 degrees apart
+        noiseBurst,     // independent white noise, then silence
+        dualMonoNoise   // the same noise burst in both channels
+    };
+
+    struct Tolerance
+    {
+        bool isBitExact;
+        double maxErrorDb;      // largest allowed error otherwise
+    };
+
+    constexpr Tolerance BIT_EXACT { true, 0.0 };
+    constexpr Tolerance LIBM_COEFFICIENTS { false, -100.0 };
+    constexpr Tolerance WINDOWED { false, -100.0 };
+    constexpr Tolerance SPECTRAL { false, -90.0 };
+
+    struct ParameterValue
+    {
+        const char* parameterID;
+        float value;
+    };
+
+    // Sets parameters at the start of a block, given how far through the 
+    // render it is (0 to 1). Only parameters that never resize the delay's
+    // memory are automated, since new pool blocks arrive asynchronously 
+    // and would make the render depend on timing.
+    using Automation = void (*)(juce::AudioProcessorValueTreeState&, float progress);
+
+    struct GoldenCase
+    {
+        const char* name;
+        const char* fileName;
+        Signal signal;
+        std::vector<ParameterValue> parameters;
+        Automation automation;
+        bool hasIrregularBlocks;
+        Tolerance tolerance;
+    };
+
+    // Parameters every case starts from, before its own
+    const std::vector<ParameterValue> BASE_PARAMETERS {
+        { "DELAY_TIME", 40.0f },
+        { "FEEDBACK", 0.5f },
+        { "MIX", 0.5f },
+        { "IS_PING_PONG_ON", 0.0f },
+        { "IS_BYPASS_ON", 0.0f },
+        { "BYPASS_TRAILS", 0.0f },
+        { "LOOP_FILTER_CUTOFF", 1000.0f },
+        { "LOOP_FILTER_TYPE", 2.0f },
+        { "LOOP_FILTER_RESONANCE", 0.0f },
+        { "DIFFUSION", 0.0f },
+        { "DIFFUSION_SIZE", 1.0f },
+        { "SATURATION_TYPE", 0.0f },
+        { "SATURATION_DRIVE", 6.0f },
+        { "IS_REVERSE_ON", 0.0f },
+        { "IS_FREEZE_ON", 0.0f },
+        { "IS_SPECTRAL_ON", 0.0f },
+        { "SPECTRAL_DELAY_TILT", 0.0f },
+        { "SPECTRAL_FEEDBACK_TILT", 0.0f }
+    };
+
+    std::vector<GoldenCase> makeCases()
+    {
+        return {
+            { "Plain, impulse", "plain_impulse", Signal::impulse, 
+                {}, nullptr, false, BIT_EXACT },
+
+            { "Ping pong, impulse", "ping_pong_impulse", Signal::impulse, 
+                { { "IS_PING_PONG_ON", 1.0f } }, nullptr, false, BIT_EXACT },
+
+            { "Dual mono, noise burst", "dual_mono_noise", Signal::dualMonoNoise, 
+                {}, nullptr, false, BIT_EXACT },
+
+            { "Irregular blocks, sweep", "irregular_blocks_sweep", Signal::sweep, 
+                { { "FEEDBACK", 0.7f } }, nullptr, true, BIT_EXACT },
+
+            { "One-pole low pass, sweep", "one_pole_low_pass_sweep", Signal::sweep, 
+                { { "LOOP_FILTER_TYPE", 0.0f }, { "LOOP_FILTER_CUTOFF", 2000.0f }, 
+                  { "FEEDBACK", 0.7f } }, 
+                nullptr, false, LIBM_COEFFICIENTS },
+
+            { "One-pole high pass, noise burst", "one_pole_high_pass_noise", Signal::noiseBurst, 
+                { { "LOOP_FILTER_TYPE", 1.0f }, { "LOOP_FILTER_CUTOFF", 300.0f } }, 
+                nullptr, false, LIBM_COEFFICIENTS },
+
+            { "SVF band pass, noise burst", "svf_band_pass_noise", Signal::noiseBurst, 
+                { { "LOOP_FILTER_TYPE", 5.0f }, { "LOOP_FILTER_CUTOFF", 1500.0f }, 
+                  { "LOOP_FILTER_RESONANCE", 0.7f }, { "FEEDBACK", 0.8f } }, 
+                nullptr, false, BIT_EXACT },
+
+            { "Diffusion, impulse", "diffusion_impulse", Signal::impulse, 
+                { { "DIFFUSION", 0.8f }, { "DIFFUSION_SIZE", 1.3f } }, 
+                nullptr, false, BIT_EXACT },
+
+            { "Tape saturation, sweep", "tape_saturation_sweep", Signal::sweep, 
+                { { "SATURATION_TYPE", 2.0f }, { "SATURATION_DRIVE", 12.0f }, 
+                  { "FEEDBACK", 0.85f } }, 
+                nullptr, false, BIT_EXACT },
+
+            { "Reverse, noise burst", "reverse_noise", Signal::noiseBurst, 
+                { { "IS_REVERSE_ON", 1.0f } }, nullptr, false, WINDOWED },
+
+            { "Freeze, noise burst", "freeze_noise", Signal::noiseBurst, {},
+                [](juce::AudioProcessorValueTreeState& apvts, float progress)
+                {
+                    setParameter(apvts, "IS_FREEZE_ON", progress >= 0.4f ? 1.0f : 0.0f);
+                }, 
+                false, BIT_EXACT },
+
+            { "Spectral, impulse", "spectral_impulse", Signal::impulse, 
+                { { "IS_SPECTRAL_ON", 1.0f }, { "SPECTRAL_DELAY_TILT", 0.5f }, 
+                  { "SPECTRAL_FEEDBACK_TILT", -0.3f } }, 
+                nullptr, false, SPECTRAL },
+
+            { "Automation, sweep", "automation_sweep", Signal::sweep, 
+                { { "LOOP_FILTER_TYPE", 0.0f }, { "DELAY_TIME", 60.0f } },
+                [](juce::AudioProcessorValueTreeState& apvts, float progress)
+                {
+                    setParameter(apvts, "MIX", 0.2f + 0.7f * progress);
+                    setParameter(apvts, "FEEDBACK", 0.3f + 0.5f * progress);
+                    setParameter(apvts, "DELAY_TIME", 60.0f - 40.0f * progress);
+                    setParameter(apvts, "LOOP_FILTER_CUTOFF", 8000.0f - 7000.0f * progress);
+                }, 
+                false, LIBM_COEFFICIENTS },
+
+            { "Bypass with trails, noise burst", "bypass_trails_noise", Signal::noiseBurst, 
+                { { "BYPASS_TRAILS", 1.0f } },
+                [](juce::AudioProcessorValueTreeState& apvts, float progress)
+                {
+                    setParameter(apvts, "IS_BYPASS_ON", progress >= 0.3f ? 1.0f : 0.0f);
+                }, 
+                false, BIT_EXACT },
+
+            { "Bypass, sweep", "bypass_sweep", Signal::sweep, {},
+                [](juce::AudioProcessorValueTreeState& apvts, float progress)
+                {
+                    setParameter(apvts, "IS_BYPASS_ON", progress >= 0.5f ? 1.0f : 0.0f);
+                }, 
+                false, BIT_EXACT }
+        };
+    }
+
+    // Sine from a polynomial rather than std::sin, so the input is the 
+    // same on every platform. Accurate to about 1e-6, which is plenty for 
+    // a test signal.
+    double polynomialSine(double phase)
+    {
+        const double PI = 3.141592653589793;
+
+        // Fold into -pi/2..pi/2, where the series converges quickly
+        double x = phase - 2.0 * PI * std::floor(phase / (2.0 * PI) + 0.5);
+
+        if (x > PI / 2.0)
+            x = PI - x;
+        else if (x < -PI / 2.0)
+            x = -PI - x;
+
+        const double x2 = x * x;
+
+        return x * (1.0 - x2 / 6.0 * (1.0 - x2 / 20.0 * (1.0 - x2 / 42.0 
+                    * (1.0 - x2 / 72.0 * (1.0 - x2 / 110.0)))));
+    }
+
+    // White noise from -amplitude to amplitude, from a 32-bit LCG
+    struct NoiseGenerator
+    {
+        std::uint32_t state;
+
+        float getNextSample(float amplitude)
+        {
+            state = state * 1664525u + 1013904223u;
+            return amplitude * (static_cast<float>(state >> 8) / 8388608.0f - 1.0f);
+        }
+    };
+
+    juce::AudioBuffer<float> makeSignal(Signal signal)
+    {
+        juce::AudioBuffer<float> buffer(2, NUM_SAMPLES);
+        buffer.clear();
+
+        auto* left = buffer.getWritePointer(0);
+        auto* right = buffer.getWritePointer(1);
+
+        switch (signal)
+        {
+            case Signal::impulse:
+                left[0] = 1.0f;
+                right[100] = 0.5f;
+                break;
+
+            case Signal::sweep:
+            {
+                // 40 Hz to 16 kHz over the whole render
+                const double PI = 3.141592653589793;
+                const double startFrequency = 40.0;
+                const double ratio = std::log(16000.0 / startFrequency);
+                const double duration = NUM_SAMPLES / SAMPLE_RATE;
+
+                for (int i = 0; i < NUM_SAMPLES; i++)
+                {
+                    const double t = i / SAMPLE_RATE;
+                    const double phase = 2.0 * PI * startFrequency * duration / ratio 
+                                            * (std::exp(t / duration * ratio) - 1.0);
+
+                    left[i] = static_cast<float>(0.5 * polynomialSine(phase));
+                    right[i] = static_cast<float>(0.5 * polynomialSine(phase + PI / 2.0));
+                }
+                break;
+            }
+
+            case Signal::noiseBurst:
+            case Signal::dualMonoNoise:
+            {
+                NoiseGenerator leftNoise { 1 };
+                NoiseGenerator rightNoise { 2 };
+
+                for (int i = 0; i < 2048; i++)
+                {
+                    left[i] = leftNoise.getNextSample(0.5f);
+                    right[i] = signal == Signal::dualMonoNoise 
+                                ? left[i] : rightNoise.getNextSample(0.5f);
+                }
+                break;
+            }
+        }
+
+        return buffer;
+    }
+
+    // Float bits mapped so that adjacent floats are adjacent integers
+    std::int64_t toOrderedBits(float value)
+    {
+        const auto bits = static_cast<std::int64_t>(std::bit_cast<std::int32_t>(value));
+        return bits < 0 ? std::int64_t(INT32_MIN) - bits : bits;
+    }
+
+    struct DiffReport
+    {
+        float maxAbsoluteDiff;
+        int maxDiffSample;
+        int maxDiffChannel;
+        std::int64_t maxUlps;
+        bool isOutputFinite;
+    };
+
+    DiffReport compare(const juce::AudioBuffer<float>& output, 
+                       const juce::AudioBuffer<float>& reference)
+    {
+        DiffReport report { 0.0f, 0, 0, 0, true };
+
+        for (int channel = 0; channel < output.getNumChannels(); channel++)
+        {
+            const auto* actual = output.getReadPointer(channel);
+            const auto* expected = reference.getReadPointer(channel);
+
+            for (int i = 0; i < output.getNumSamples(); i++)
+            {
+                if (! std::isfinite(actual[i]))
+                {
+                    report.isOutputFinite = false;
+                    continue;
+                }
+
+                const float diff = std::abs(actual[i] - expected[i]);
+                const auto ulps = std::abs(toOrderedBits(actual[i]) - toOrderedBits(expected[i]));
+
+                if (diff > report.maxAbsoluteDiff)
+                {
+                    report.maxAbsoluteDiff = diff;
+                    report.maxDiffSample = i;
+                    report.maxDiffChannel = channel;
+                }
+
+                report.maxUlps = std::max(report.maxUlps, ulps);
+            }
+        }
+
+        return report;
+    }
+
+    juce::String toDecibelString(double gain)
+    {
+        return gain > 0.0 ? juce::String(20.0 * std::log10(gain), 1) + " dBFS" 
+                          : juce::String("-inf dBFS");
+    }
+}
+
+
+class GoldenOutputTests : public juce::UnitTest
+{
+public:
+    GoldenOutputTests() : juce::UnitTest("Golden output", "Regression")
+    {
+    }
+
+    void runTest() override
+    {
+        const juce::File referenceDirectory(DELAY_PLUGIN_REFERENCE_DIR);
+
+        for (const auto& goldenCase : makeCases())
+        {
+            beginTest(goldenCase.name);
+
+            const auto output = render(goldenCase);
+            const auto file = referenceDirectory.getChildFile(
+                                    juce::String(goldenCase.fileName) + ".f32");
+
+            if (TestOptions::shouldRegenerateReferences)
+            {
+                expect(writeReference(file, output), "Could not write " + file.getFullPathName());
+                logMessage("Wrote " + file.getFullPathName());
+                continue;
+            }
+
+            // The references are renders with float delay lines
+            if (! std::is_same_v<DELAY_LINE_STORAGE, float>)
+            {
+                logMessage(juce::String(goldenCase.name) + ": skipped, the delay lines"
+                            " are not float");
+                continue;
+            }
+
+            juce::AudioBuffer<float> reference;
+
+            if (! readReference(file, reference))
+            {
+                expect(false, "No reference render at " + file.getFullPathName() 
+                                + " (DelayPluginTests --regenerate writes one)");
+                continue;
+            }
+
+            checkAgainstReference(goldenCase, output, reference);
+        }
+    }
+
+private:
+    juce::AudioBuffer<float> render(const GoldenCase& goldenCase)
+    {
+        AudioPluginAudioProcessor processor;
+        auto& apvts = processor.getAPVTS();
+
+        for (const auto& parameter : BASE_PARAMETERS)
+            setParameter(apvts, parameter.parameterID, parameter.value);
+
+        for (const auto& parameter : goldenCase.parameters)
+            setParameter(apvts, parameter.parameterID, parameter.value);
+
+        if (goldenCase.automation != nullptr)
+            goldenCase.automation(apvts, 0.0f);
+
+        prepareProcessor(processor, SAMPLE_RATE, BLOCK_SIZE);
+
+        auto buffer = makeSignal(goldenCase.signal);
+        juce::MidiBuffer midi;
+        size_t blockIndex = 0;
+
+        for (int start = 0; start < NUM_SAMPLES; blockIndex++)
+        {
+            const int blockSize = goldenCase.hasIrregularBlocks 
+                ? IRREGULAR_BLOCK_SIZES[blockIndex % std::size(IRREGULAR_BLOCK_SIZES)] 
+                : BLOCK_SIZE;
+            const int numSamples = std::min(blockSize, NUM_SAMPLES - start);
+
+            if (goldenCase.automation != nullptr)
+                goldenCase.automation(apvts, static_cast<float>(start) / NUM_SAMPLES);
+
+            juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), 2, 
+                                           start, numSamples);
+            processor.processBlock(block, midi);
+
+            start += numSamples;
+        }
+
+        return buffer;
+    }
+
+    void checkAgainstReference(const GoldenCase& goldenCase, 
+                               const juce::AudioBuffer<float>& output, 
+                               const juce::AudioBuffer<float>& reference)
+    {
+        if (reference.getNumSamples() != output.getNumSamples())
+        {
+            expect(false, juce::String(goldenCase.name) + ": the reference has " 
+                            + juce::String(reference.getNumSamples()) + " samples, not " 
+                            + juce::String(output.getNumSamples()));
+            return;
+        }
+
+        bool isBitExact = goldenCase.tolerance.isBitExact;
+        double maxErrorDb = goldenCase.tolerance.maxErrorDb;
+
+        if (isBitExact && ! CAN_MATCH_BIT_FOR_BIT)
+        {
+            isBitExact = false;
+            maxErrorDb = NON_X86_ERROR_DB;
+        }
+
+        const auto report = compare(output, reference);
+        const double maxDiff = report.maxAbsoluteDiff;
+
+        juce::String message = juce::String(goldenCase.name) + ": max diff ";
+
+        if (report.maxUlps == 0)
+            message += "0 (bit-exact)";
+        else
+            message += juce::String(maxDiff, 9) + " (" + toDecibelString(maxDiff) 
+                        + ", " + juce::String(report.maxUlps) + " ULP) at sample " 
+                        + juce::String(report.maxDiffSample) + ", channel " 
+                        + juce::String(report.maxDiffChannel);
+
+        message += isBitExact ? ", allowed: bit-exact" 
+                              : ", allowed: " + juce::String(maxErrorDb, 1) + " dBFS";
+
+        logMessage(message);
+
+        expect(report.isOutputFinite, juce::String(goldenCase.name) + ": output is not finite");
+
+        if (isBitExact)
+            expect(report.maxUlps == 0, message);
+        else
+            expect(maxDiff <= juce::Decibels::decibelsToGain(maxErrorDb, -1000.0), message);
+    }
+
+    static bool writeReference(const juce::File& file, const juce::AudioBuffer<float>& buffer)
+    {
+        juce::MemoryBlock data;
+
+        for (int channel = 0; channel < buffer.getNumChannels(); channel++)
+            data.append(buffer.getReadPointer(channel), 
+                        sizeof(float) * static_cast<size_t>(buffer.getNumSamples()));
+
+        return file.getParentDirectory().createDirectory() 
+                && file.replaceWithData(data.getData(), data.getSize());
+    }
+
+    static bool readReference(const juce::File& file, juce::AudioBuffer<float>& buffer)
+    {
+        juce::MemoryBlock data;
+
+        if (! file.existsAsFile() || ! file.loadFileAsData(data))
+            return false;
+
+        const int numSamples = static_cast<int>(data.getSize() / (2 * sizeof(float)));
+        buffer.setSize(2, numSamples);
+
+        for (int channel = 0; channel < 2; channel++)
+            std::memcpy(buffer.getWritePointer(channel), 
+                        static_cast<const float*>(data.getData()) + channel * numSamples, 
+                        sizeof(float) * static_cast<size_t>(numSamples));
+
+        return true;
+    }
+};
+
+static GoldenOutputTests goldenOutputTests;
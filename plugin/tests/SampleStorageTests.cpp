@@ -0,0 +1,161 @@
+///
+///     @file SampleStorageTests.cpp
+///     @brief Tests for the compact delay-line sample formats.
+///     @date October 18, 2026
+///
+///     Measures each format's noise floor the way SampleStorage.h's table
+///     was measured (a -6 dBFS 1 kHz sine at 48 kHz pushed through a
+///     CircularBuffer, error RMS relative to a full scale of 1.0) and checks
+///     it against the table. Then checks Fixed16's ceiling: input beyond
+///     its scale, such as anything above +12 dBFS at the delay lines' scale
+///     of 4, is clamped to full scale, never wrapped.
+///
+
+#include "DelayPlugin/DSP/CircularBuffer.h"
+#include "DelayPlugin/DSP/SampleStorage.h"
+#include <juce_core/juce_core.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+
+namespace
+{
+    constexpr size_t BUFFER_SIZE = 4096;
+    constexpr double SAMPLE_RATE = 48000.0;
+    constexpr double FREQUENCY = 1000.0;
+    constexpr double AMPLITUDE = 0.5;       // -6 dBFS
+    constexpr double TWO_PI = 6.283185307179586;
+
+    // The table's figures are rounded; the measurement must land within
+    // this much of them
+    constexpr double NOISE_FLOOR_TOLERANCE_DB = 3.0;
+
+    constexpr float FIXED_SCALE = 4.0f;     // as DelayEffect's delay lines
+
+    // Round trip a sine through a buffer stored as StorageType and return
+    // the error RMS in dBFS
+    template<typename StorageType>
+    double measureNoiseFloor(float scale)
+    {
+        CircularBuffer<float, StorageType> buffer(BUFFER_SIZE);
+        buffer.setStorageScale(scale);
+
+        std::vector<float> input(BUFFER_SIZE);
+
+        for (size_t i = 0; i < input.size(); i++)
+            input[i] = static_cast<float>(AMPLITUDE * std::sin(TWO_PI * FREQUENCY
+                                                               * static_cast<double>(i) / SAMPLE_RATE));
+
+        buffer.pushBlock(input.data(), input.size());
+
+        std::vector<float> output(BUFFER_SIZE);
+        buffer.readBlock(0, output.data(), output.size());
+
+        double sumOfSquares = 0.0;
+
+        for (size_t i = 0; i < input.size(); i++)
+        {
+            const double error = static_cast<double>(output[i]) - static_cast<double>(input[i]);
+            sumOfSquares += error * error;
+        }
+
+        const double rms = std::sqrt(sumOfSquares / static_cast<double>(input.size()));
+
+        return 20.0 * std::log10(std::max(rms, 1.0e-20));
+    }
+}
+
+
+class SampleStorageTests : public juce::UnitTest
+{
+public:
+    SampleStorageTests() : juce::UnitTest("SampleStorage", "DSP")
+    {
+    }
+
+    void runTest() override
+    {
+        beginTest("Noise floors match SampleStorage.h");
+        {
+            expectNoiseFloor("float", measureNoiseFloor<float>(1.0f), -1000.0);
+            expectNoiseFloor("Fixed16, scale 1", measureNoiseFloor<Fixed16>(1.0f), -100.0);
+            expectNoiseFloor("Fixed16, scale 4", measureNoiseFloor<Fixed16>(FIXED_SCALE), -89.0);
+            expectNoiseFloor("Half", measureNoiseFloor<Half>(1.0f), -85.0);
+            expectNoiseFloor("BFloat16", measureNoiseFloor<BFloat16>(1.0f), -68.0);
+        }
+
+        beginTest("Fixed16 clamps input beyond its scale");
+        {
+            using Codec = SampleCodec<float, Fixed16>;
+
+            // Up to +24 dB over full scale (+36 dBFS at scale 4)
+            for (float gain : { 1.0f, 1.5f, 2.0f, 4.0f, 16.0f })
+            {
+                const float level = gain * FIXED_SCALE;
+
+                expectEquals(Codec::decode(Codec::encode(level, FIXED_SCALE), FIXED_SCALE), FIXED_SCALE);
+                expectEquals(Codec::decode(Codec::encode(-level, FIXED_SCALE), FIXED_SCALE), -FIXED_SCALE);
+            }
+
+            const float infinity = std::numeric_limits<float>::infinity();
+            expectEquals(Codec::decode(Codec::encode(infinity, FIXED_SCALE), FIXED_SCALE), FIXED_SCALE);
+            expectEquals(Codec::decode(Codec::encode(-infinity, FIXED_SCALE), FIXED_SCALE), -FIXED_SCALE);
+
+            const float nan = std::numeric_limits<float>::quiet_NaN();
+            expectEquals(Codec::decode(Codec::encode(nan, FIXED_SCALE), FIXED_SCALE), 0.0f);
+        }
+
+        beginTest("A Fixed16 delay line clamps a hot signal, block by block or sample by sample");
+        {
+            // A sine at +18 dBFS: everything past +/-4.0 (+12 dBFS) is flat
+            constexpr size_t size = 256;
+            const float amplitude = 2.0f * FIXED_SCALE;
+
+            std::vector<float> input(size);
+
+            for (size_t i = 0; i < size; i++)
+                input[i] = amplitude * static_cast<float>(std::sin(TWO_PI * static_cast<double>(i) / 64.0));
+
+            CircularBuffer<float, Fixed16> blockBuffer(size);
+            CircularBuffer<float, Fixed16> sampleBuffer(size);
+            blockBuffer.setStorageScale(FIXED_SCALE);
+            sampleBuffer.setStorageScale(FIXED_SCALE);
+
+            blockBuffer.pushBlock(input.data(), size);
+
+            for (float sample : input)
+                sampleBuffer.push(sample);
+
+            const float quantum = FIXED_SCALE / 32767.0f;
+
+            for (size_t i = 0; i < size; i++)
+            {
+                const float expected = juce::jlimit(-FIXED_SCALE, FIXED_SCALE, input[i]);
+
+                expectWithinAbsoluteError(blockBuffer(i), expected, quantum);
+                expectEquals(sampleBuffer(i), blockBuffer(i));
+            }
+        }
+    }
+
+private:
+    void expectNoiseFloor(const juce::String& format, double measuredDb, double tableDb)
+    {
+        logMessage(format + " noise floor: " + juce::String(measuredDb, 1) + " dBFS");
+
+        // float is the reference, and round trips exactly
+        if (tableDb <= -1000.0)
+        {
+            expectLessThan(measuredDb, -150.0, format + " isn't lossless");
+            return;
+        }
+
+        expectWithinAbsoluteError(measuredDb, tableDb, NOISE_FLOOR_TOLERANCE_DB,
+                                  format + " noise floor differs from the table");
+    }
+};
+
+
+static SampleStorageTests sampleStorageTests;
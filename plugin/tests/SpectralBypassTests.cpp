@@ -0,0 +1,284 @@
+///
+///     @file SpectralBypassTests.cpp
+///     @brief Tests for spectral mode's latency through a bypass, and the
+///            reported tail length.
+///     @date October 18, 2026
+///
+///     Spectral mode delays its output by one FFT length and reports that
+///     to the host. The latency must not change when bypass engages or
+///     settles, so the bypassed signal has to be the input delayed by the
+///     same amount: with the mix at 0 (the processed signal is then only
+///     the delayed dry signal) the output must be exactly the delayed input
+///     before, during and after a bypass.
+///
+
+#include "TestUtilities.h"
+#include <cmath>
+#include <limits>
+
+
+namespace
+{
+    constexpr double SAMPLE_RATE = 44100.0;
+    constexpr int BLOCK_SIZE = 256;
+    constexpr int IRREGULAR_BLOCK_SIZES[] = { 1, 7, 64, 333, 512, 2, 128 };
+
+    // When bypass is on, in seconds. A tail is only over once it has been
+    // silent for longer than the delay can hold (2 s), so the render with
+    // trails is long enough for that.
+    struct Timeline
+    {
+        double bypassStart;
+        double bypassEnd;
+        double duration;
+    };
+
+    constexpr Timeline SHORT_TIMELINE { 0.25, 0.6, 1.0 };
+    constexpr Timeline TRAILS_TIMELINE { 0.25, 4.5, 5.0 };
+
+    juce::AudioBuffer<float> makeNoise(int numSamples)
+    {
+        juce::AudioBuffer<float> buffer(2, numSamples);
+        std::uint32_t state = 1;
+
+        for (int channel = 0; channel < 2; channel++)
+        {
+            for (int i = 0; i < numSamples; i++)
+            {
+                state = state * 1664525u + 1013904223u;
+                buffer.setSample(channel, i, 0.5f * (static_cast<float>(state >> 8)
+                                                        / 8388608.0f - 1.0f));
+            }
+        }
+
+        return buffer;
+    }
+
+    void setUpSpectral(AudioPluginAudioProcessor& processor, float mix, bool isTrailsOn)
+    {
+        auto& apvts = processor.getAPVTS();
+
+        setParameter(apvts, "IS_SPECTRAL_ON", 1.0f);
+        setParameter(apvts, "DELAY_TIME", 100.0f);
+        setParameter(apvts, "FEEDBACK", 0.6f);
+        setParameter(apvts, "MIX", mix);
+        setParameter(apvts, "BYPASS_TRAILS", isTrailsOn ? 1.0f : 0.0f);
+        setParameter(apvts, "IS_BYPASS_ON", 0.0f);
+    }
+
+    int toSamples(double seconds)
+    {
+        return static_cast<int>(seconds * SAMPLE_RATE);
+    }
+
+    // Process with bypass switched on and off part way through
+    void renderWithBypass(AudioPluginAudioProcessor& processor, const Timeline& timeline,
+                          juce::AudioBuffer<float>& buffer, bool hasIrregularBlocks)
+    {
+        auto& apvts = processor.getAPVTS();
+        juce::MidiBuffer midi;
+        size_t blockIndex = 0;
+
+        for (int start = 0; start < buffer.getNumSamples(); blockIndex++)
+        {
+            const int blockSize = hasIrregularBlocks
+                ? IRREGULAR_BLOCK_SIZES[blockIndex % std::size(IRREGULAR_BLOCK_SIZES)]
+                : BLOCK_SIZE;
+            const int numSamples = std::min(blockSize, buffer.getNumSamples() - start);
+            const bool isBypassOn = start >= toSamples(timeline.bypassStart)
+                                        && start < toSamples(timeline.bypassEnd);
+
+            setParameter(apvts, "IS_BYPASS_ON", isBypassOn ? 1.0f : 0.0f);
+
+            juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), 2,
+                                           start, numSamples);
+            processor.processBlock(block, midi);
+
+            start += numSamples;
+        }
+    }
+}
+
+
+class SpectralBypassTests : public juce::UnitTest
+{
+public:
+    SpectralBypassTests() : juce::UnitTest("Spectral bypass", "DSP")
+    {
+    }
+
+    void runTest() override
+    {
+        testLatencyHolds();
+
+        for (bool hasIrregularBlocks : { false, true })
+        {
+            for (bool isTrailsOn : { false, true })
+                testBypassedSignalIsDelayed(isTrailsOn, hasIrregularBlocks);
+        }
+
+        testTailPlaysOutThenStaysDelayed();
+        testTailLength();
+    }
+
+private:
+    void testLatencyHolds()
+    {
+        beginTest("Latency holds through a bypass");
+
+        // The processor only reports latency changes from the message
+        // thread, so the delay effect is driven directly, with the
+        // processor's parameters
+        AudioPluginAudioProcessor processor;
+        auto& apvts = processor.getAPVTS();
+        setUpSpectral(processor, 0.5f, false);
+
+        DelayEffect delayEffect;
+        delayEffect.setParametersFromAPVTS(apvts);
+        delayEffect.prepareToPlay(static_cast<float>(SAMPLE_RATE));
+        delayEffect.update();
+
+        const int latency = delayEffect.getLatencySamples();
+        expect(latency > 0, "Spectral mode has no latency");
+
+        constexpr int NUM_BLOCKS = 100;
+        const auto input = makeNoise(NUM_BLOCKS * BLOCK_SIZE);
+        auto output = input;
+
+        // On long enough to settle, then off again
+        for (int block = 0; block < NUM_BLOCKS; block++)
+        {
+            setParameter(apvts, "IS_BYPASS_ON", block < NUM_BLOCKS / 2 ? 1.0f : 0.0f);
+
+            delayEffect.setParametersFromAPVTS(apvts);
+            delayEffect.update();
+
+            juce::AudioBuffer<float> buffer(output.getArrayOfWritePointers(), 2,
+                                            block * BLOCK_SIZE, BLOCK_SIZE);
+            delayEffect.processAudioBuffer(buffer);
+
+            expectEquals(delayEffect.getLatencySamples(), latency,
+                         "Latency changed at block " + juce::String(block));
+            expect(! delayEffect.isFullyBypassed(),
+                   "Spectral mode can't skip processing while bypassed");
+        }
+
+        // Settled, the bypass passes the input delayed by the latency
+        expectDelayedFrom(input, output, latency, (NUM_BLOCKS / 2 - 10) * BLOCK_SIZE,
+                          NUM_BLOCKS / 2 * BLOCK_SIZE);
+    }
+
+    void testBypassedSignalIsDelayed(bool isTrailsOn, bool hasIrregularBlocks)
+    {
+        beginTest(juce::String("Bypassed signal is delayed by the latency")
+                    + (isTrailsOn ? ", trails" : "")
+                    + (hasIrregularBlocks ? ", irregular blocks" : ""));
+
+        AudioPluginAudioProcessor processor;
+        setUpSpectral(processor, 0.0f, isTrailsOn);
+        prepareProcessor(processor, SAMPLE_RATE, BLOCK_SIZE);
+
+        const int latency = processor.getLatencySamples();
+        const auto input = makeNoise(toSamples(SHORT_TIMELINE.duration));
+        auto output = input;
+
+        renderWithBypass(processor, SHORT_TIMELINE, output, hasIrregularBlocks);
+
+        expect(latency > 0, "Spectral mode reported no latency");
+        expectDelayedFrom(input, output, latency, 0);
+    }
+
+    void testTailPlaysOutThenStaysDelayed()
+    {
+        beginTest("Trails play out, then the bypassed signal is delayed");
+
+        AudioPluginAudioProcessor processor;
+        setUpSpectral(processor, 0.5f, true);
+        setParameter(processor.getAPVTS(), "FEEDBACK", 0.3f);
+        prepareProcessor(processor, SAMPLE_RATE, BLOCK_SIZE);
+
+        const int latency = processor.getLatencySamples();
+        const auto input = makeNoise(toSamples(TRAILS_TIMELINE.duration));
+        auto output = input;
+
+        renderWithBypass(processor, TRAILS_TIMELINE, output, false);
+
+        const int bypassStart = toSamples(TRAILS_TIMELINE.bypassStart);
+        const int bypassEnd = toSamples(TRAILS_TIMELINE.bypassEnd);
+
+        // The tail is heard over the delayed dry signal just after bypass
+        // engages
+        float tailPeak = 0.0f;
+
+        for (int i = bypassStart; i < bypassStart + BLOCK_SIZE; i++)
+        {
+            tailPeak = std::max(tailPeak, std::abs(output.getSample(0, i)
+                                                    - input.getSample(0, i - latency)));
+        }
+
+        expectGreaterThan(tailPeak, 0.01f, "No tail after bypass engaged");
+
+        // Once it has died away, only the delayed dry signal is left
+        expectDelayedFrom(input, output, latency, bypassEnd - toSamples(0.5), bypassEnd);
+    }
+
+    void testTailLength()
+    {
+        beginTest("Tail length");
+
+        AudioPluginAudioProcessor processor;
+        auto& apvts = processor.getAPVTS();
+        setParameter(apvts, "DELAY_TIME", 500.0f);
+        setParameter(apvts, "FEEDBACK", 0.5f);
+        setParameter(apvts, "DIFFUSION", 0.0f);
+        prepareProcessor(processor, SAMPLE_RATE, BLOCK_SIZE);
+
+        // The first echo, then 10 repeats to fall by 60 dB (0.5^10 < 0.001)
+        expectWithinAbsoluteError(processor.getTailLengthSeconds(), 5.5, 1.0e-6);
+
+        setParameter(apvts, "FEEDBACK", 0.0f);
+        expectWithinAbsoluteError(processor.getTailLengthSeconds(), 0.5, 1.0e-6);
+
+        setParameter(apvts, "FEEDBACK", 0.5f);
+        setParameter(apvts, "DIFFUSION", 0.5f);
+        expectGreaterThan(processor.getTailLengthSeconds(), 5.5);
+
+        setParameter(apvts, "DIFFUSION", 0.0f);
+        setParameter(apvts, "IS_SPECTRAL_ON", 1.0f);
+        expectGreaterThan(processor.getTailLengthSeconds(), 5.5,
+                          "Spectral tail leaves out the latency");
+
+        setParameter(apvts, "IS_FREEZE_ON", 1.0f);
+        expect(std::isinf(processor.getTailLengthSeconds()), "A frozen tail should never end");
+    }
+
+    // Check output[i] == input[i - latency] over [start, end)
+    void expectDelayedFrom(const juce::AudioBuffer<float>& input,
+                           const juce::AudioBuffer<float>& output, int latency,
+                           int start, int end = std::numeric_limits<int>::max())
+    {
+        end = std::min(end, output.getNumSamples());
+
+        for (int channel = 0; channel < 2; channel++)
+        {
+            for (int i = start; i < end; i++)
+            {
+                const float expected = i >= latency ? input.getSample(channel, i - latency) : 0.0f;
+
+                if (output.getSample(channel, i) != expected)
+                {
+                    expect(false, "Output isn't the input delayed by " + juce::String(latency)
+                                    + " samples at sample " + juce::String(i) + " of channel "
+                                    + juce::String(channel) + " (" + juce::String(output.getSample(channel, i))
+                                    + " vs " + juce::String(expected) + ")");
+                    return;
+                }
+            }
+        }
+
+        expect(true);
+    }
+};
+
+
+static SpectralBypassTests spectralBypassTests;
@@ -0,0 +1,64 @@
+///
+///     @file TestMain.cpp
+///     @brief Runs the DSP tests.
+///     @date October 18, 2026
+///
+///     Usage: DelayPluginTests [--regenerate] [category]
+///
+///     With a category (e.g. Regression), only that category's tests run. 
+///     Without one, every category runs except Timing, whose wall-clock 
+///     checks only run when asked for by name.
+///     --regenerate writes new reference renders for the golden-output 
+///     tests instead of checking against them: only for changes that are 
+///     meant to change the sound.
+///
+///     Returns non-zero if any test failed, for ctest.
+///
+
+#include "TestUtilities.h"
+#include <juce_events/juce_events.h>
+
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::String category;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const juce::String argument(argv[i]);
+
+        if (argument == "--regenerate")
+            TestOptions::shouldRegenerateReferences = true;
+        else
+            category = argument;
+    }
+
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+
+    if (category.isEmpty())
+    {
+        juce::Array<juce::UnitTest*> tests;
+
+        for (auto* test : juce::UnitTest::getAllTests())
+        {
+            if (test->getCategory() != "Timing")
+                tests.add(test);
+        }
+
+        runner.runTests(tests);
+    }
+    else
+    {
+        runner.runTestsInCategory(category);
+    }
+
+    int numFailures = 0;
+
+    for (int i = 0; i < runner.getNumResults(); i++)
+        numFailures += runner.getResult(i)->failures;
+
+    return numFailures == 0 ? 0 : 1;
+}
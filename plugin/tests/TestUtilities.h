@@ -0,0 +1,58 @@
+///
+///     @file TestUtilities.h
+///     @brief Helpers shared by the DSP tests.
+///     @date October 18, 2026
+///
+
+#pragma once
+
+#include "DelayPlugin/PluginProcessor.h"
+#include <juce_core/juce_core.h>
+#include <algorithm>
+
+
+// Set from the command line (see TestMain.cpp)
+struct TestOptions
+{
+    // Write new reference renders instead of comparing against them
+    static inline bool shouldRegenerateReferences = false;
+};
+
+
+// Set a parameter the way the host or editor would, so the value goes 
+// through the parameter's range (and snapping) and reaches the raw values
+// DelayEffect reads
+inline void setParameter(juce::AudioProcessorValueTreeState& apvts, 
+                         const juce::String& parameterID, float value)
+{
+    auto* parameter = apvts.getParameter(parameterID);
+    jassert(parameter != nullptr);
+
+    parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+}
+
+
+// Get a processor ready to play stereo at the given rate and block size
+inline void prepareProcessor(AudioPluginAudioProcessor& processor, 
+                             double sampleRate, int blockSize)
+{
+    processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+}
+
+
+// Process a buffer in place, a block at a time
+inline void processInBlocks(AudioPluginAudioProcessor& processor,
+                            juce::AudioBuffer<float>& buffer, int blockSize)
+{
+    juce::MidiBuffer midi;
+
+    for (int start = 0; start < buffer.getNumSamples(); start += blockSize)
+    {
+        const int numSamples = std::min(blockSize, buffer.getNumSamples() - start);
+        juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), 
+                                       buffer.getNumChannels(), start, numSamples);
+
+        processor.processBlock(block, midi);
+    }
+}
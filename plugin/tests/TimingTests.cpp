@@ -0,0 +1,279 @@
+///
+///     @file TimingTests.cpp
+///     @brief Timing checks for the real-time paths. Opt-in: run
+///            "DelayPluginTests Timing".
+///     @date October 18, 2026
+///
+///     These compare blocks with each other rather than with a fixed
+///     budget, so they hold on slow machines and in debug builds. They
+///     still measure wall-clock time, which a loaded machine or a
+///     sanitizer can skew, so they are not part of the default run (or
+///     ctest); run them by hand on a quiet machine, in a release build:
+///
+///     - Denormal input must cost about the same as normal input (the
+///       processor flushes denormals).
+///     - A clear() (from a ping pong toggle) must cost about what an
+///       ordinary block does. It only marks the delay lines and spectral
+///       rings stale; zeroing them took milliseconds at 384 kHz.
+///     - The dual-mono sync check must never land in one block. It is
+///       spread over blocks; comparing the whole delay lines at once took
+///       milliseconds at 384 kHz.
+///
+///     Each timed render runs a few times and keeps each block's fastest
+///     time, which takes out most of the noise from the rest of the system.
+///
+
+#include "TestUtilities.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+
+namespace
+{
+    // Runs per timed render (each block's fastest time is kept)
+    constexpr int NUM_TIMING_RUNS = 3;
+
+    // Limits, in median blocks. Denormals cost 10-100 times as much as
+    // normal numbers. At 384 kHz in blocks of 128, a clear() that zeroed
+    // the delay lines cost about 1000 blocks, and a sync check done in one
+    // block about 50.
+    constexpr double MAX_DENORMAL_COST_RATIO = 3.0;
+    constexpr double MAX_CLEAR_COST_BLOCKS = 50.0;
+    constexpr double MAX_SYNC_CHECK_COST_RATIO = 10.0;
+
+    struct ParameterValue
+    {
+        const char* parameterID;
+        float value;
+    };
+
+    void setParameters(juce::AudioProcessorValueTreeState& apvts,
+                       const std::vector<ParameterValue>& parameters)
+    {
+        for (const auto& parameter : parameters)
+            setParameter(apvts, parameter.parameterID, parameter.value);
+    }
+
+    juce::AudioBuffer<float> makeNoise(int numSamples, float amplitude, juce::int64 seed)
+    {
+        juce::AudioBuffer<float> buffer(2, numSamples);
+        juce::Random random(seed);
+
+        for (int channel = 0; channel < 2; channel++)
+        {
+            for (int i = 0; i < numSamples; i++)
+                buffer.setSample(channel, i, amplitude * (random.nextFloat() * 2.0f - 1.0f));
+        }
+
+        return buffer;
+    }
+
+    double getMedian(std::vector<double> values)
+    {
+        auto middle = values.begin() + static_cast<std::ptrdiff_t>(values.size() / 2);
+        std::nth_element(values.begin(), middle, values.end());
+
+        return *middle;
+    }
+
+    // Count the times the channels started sharing a path, in trace
+    // events after the last ones counted (see DualMonoTests.cpp)
+    int countTimesShared(const TraceRing& traceRing, std::int64_t& lastTraceTime)
+    {
+        const std::int64_t countedUpTo = lastTraceTime;
+        int count = 0;
+
+        for (const auto& event : traceRing.getSnapshot())
+        {
+            if (event.timestampNs <= countedUpTo)
+                continue;
+
+            lastTraceTime = event.timestampNs;
+
+            if (std::strcmp(event.name, "channels shared") == 0 && event.value != 0)
+                count++;
+        }
+
+        return count;
+    }
+
+    struct TimedRender
+    {
+        std::vector<double> blockSeconds;
+        int numTimesShared = 0;     // times the channels started sharing a path
+    };
+
+    // Render one input a few times, each time with a new processor, and
+    // keep each block's fastest time (in seconds). The change is made at
+    // the start of changeBlock.
+    TimedRender renderTimed(const std::vector<ParameterValue>& parameters,
+                            double sampleRate, int blockSize,
+                            const juce::AudioBuffer<float>& input,
+                            const std::vector<ParameterValue>& change = {},
+                            int changeBlock = -1)
+    {
+        const int numBlocks = input.getNumSamples() / blockSize;
+        TimedRender result { std::vector<double>(static_cast<size_t>(numBlocks),
+                                                 std::numeric_limits<double>::max()) };
+
+        for (int run = 0; run < NUM_TIMING_RUNS; run++)
+        {
+            AudioPluginAudioProcessor processor;
+            auto& apvts = processor.getAPVTS();
+            setParameters(apvts, parameters);
+            prepareProcessor(processor, sampleRate, blockSize);
+
+            auto& traceRing = processor.getTraceRing();
+            traceRing.setEnabled(run == 0);
+
+            auto output = input;
+            juce::MidiBuffer midi;
+            std::int64_t lastTraceTime = 0;
+
+            for (int block = 0; block < numBlocks; block++)
+            {
+                if (block == changeBlock)
+                    setParameters(apvts, change);
+
+                juce::AudioBuffer<float> audio(output.getArrayOfWritePointers(), 2,
+                                               block * blockSize, blockSize);
+
+                const auto start = std::chrono::steady_clock::now();
+                processor.processBlock(audio, midi);
+                const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+                auto& fastest = result.blockSeconds[static_cast<size_t>(block)];
+                fastest = std::min(fastest, elapsed.count());
+
+                // Read the trace before it wraps
+                if (run == 0 && block % 256 == 255)
+                    result.numTimesShared += countTimesShared(traceRing, lastTraceTime);
+            }
+
+            if (run == 0)
+                result.numTimesShared += countTimesShared(traceRing, lastTraceTime);
+        }
+
+        return result;
+    }
+}
+
+
+class TimingTests : public juce::UnitTest
+{
+public:
+    TimingTests() : juce::UnitTest("Timing", "Timing")
+    {
+    }
+
+    void runTest() override
+    {
+        testDenormals();
+        testClearCost();
+        testSyncCheckCost();
+    }
+
+private:
+    void testDenormals()
+    {
+        beginTest("Denormal input costs no more than normal input");
+
+        // Short echoes through every stage that keeps state, so denormals
+        // would reach all of them
+        const std::vector<ParameterValue> parameters {
+            { "DELAY_TIME", 5.0f }, { "FEEDBACK", 0.9f }, { "MIX", 1.0f },
+            { "LOOP_FILTER_TYPE", 0.0f }, { "LOOP_FILTER_CUTOFF", 2000.0f },
+            { "DIFFUSION", 1.0f }, { "SATURATION_TYPE", 1.0f }
+        };
+
+        constexpr double sampleRate = 48000.0;
+        constexpr int blockSize = 256;
+        const int numSamples = static_cast<int>(sampleRate);
+
+        const auto normal = renderTimed(parameters, sampleRate, blockSize,
+                                        makeNoise(numSamples, 0.5f, 3));
+        const auto denormal = renderTimed(parameters, sampleRate, blockSize,
+                                          makeNoise(numSamples, 1.0e-39f, 3));
+
+        const double ratio = getMedian(denormal.blockSeconds) / getMedian(normal.blockSeconds);
+        logMessage("Denormal / normal input cost: " + juce::String(ratio, 2));
+
+        expectLessThan(ratio, MAX_DENORMAL_COST_RATIO, "Denormal input is slow");
+    }
+
+    void testClearCost()
+    {
+        for (bool isSpectralOn : { false, true })
+        {
+            beginTest(juce::String("A clear costs about an ordinary block")
+                        + (isSpectralOn ? ", spectral" : ""));
+
+            // The longest delay at the highest rate, with full delay lines
+            // by the time ping pong is switched on, which clears them
+            constexpr double sampleRate = 384000.0;
+            constexpr int blockSize = 128;
+            const int numBlocks = static_cast<int>(sampleRate) / blockSize;
+            const int toggleBlock = numBlocks / 2;
+
+            const std::vector<ParameterValue> parameters {
+                { "DELAY_TIME", 1000.0f }, { "FEEDBACK", 0.5f },
+                { "IS_SPECTRAL_ON", isSpectralOn ? 1.0f : 0.0f }
+            };
+
+            const auto input = makeNoise(numBlocks * blockSize, 0.5f, 4);
+            const auto toggled = renderTimed(parameters, sampleRate, blockSize, input,
+                                             { { "IS_PING_PONG_ON", 1.0f } }, toggleBlock);
+            const auto reference = renderTimed(parameters, sampleRate, blockSize, input);
+
+            // The clear's cost is what the toggle block takes over the same
+            // block without the toggle. In spectral mode some blocks run
+            // an FFT frame and others don't, so it is measured in median
+            // blocks rather than compared with one.
+            const size_t index = static_cast<size_t>(toggleBlock);
+            const double numBlocksCost = (toggled.blockSeconds[index] - reference.blockSeconds[index])
+                                            / getMedian(reference.blockSeconds);
+            logMessage("Clear cost, in median blocks: " + juce::String(numBlocksCost, 1));
+
+            expectLessThan(numBlocksCost, MAX_CLEAR_COST_BLOCKS, "The clear isn't O(1)");
+        }
+    }
+
+    void testSyncCheckCost()
+    {
+        beginTest("The dual-mono sync check is spread over blocks");
+
+        // Stereo for a moment, then dual mono until the stereo part has
+        // left the delay lines and the channels can share a path. Without
+        // feedback nothing stereo goes round again.
+        constexpr double sampleRate = 384000.0;
+        constexpr int blockSize = 128;
+        const int numBlocks = static_cast<int>(3.0 * sampleRate) / blockSize;
+        const int stereoSamples = static_cast<int>(0.01 * sampleRate);
+
+        auto input = makeNoise(numBlocks * blockSize, 0.5f, 5);
+        input.copyFrom(1, stereoSamples, input, 0, stereoSamples,
+                       input.getNumSamples() - stereoSamples);
+
+        const std::vector<ParameterValue> parameters {
+            { "DELAY_TIME", 1000.0f }, { "FEEDBACK", 0.0f }, { "IS_PING_PONG_ON", 0.0f }
+        };
+
+        const auto render = renderTimed(parameters, sampleRate, blockSize, input);
+
+        const double worst = *std::max_element(render.blockSeconds.begin(),
+                                               render.blockSeconds.end());
+        const double ratio = worst / getMedian(render.blockSeconds);
+        logMessage("Worst block / median block: " + juce::String(ratio, 1));
+
+        // Otherwise no check ever passed, and the test proves nothing
+        expect(render.numTimesShared > 0, "The channels never shared a path");
+        expectLessThan(ratio, MAX_SYNC_CHECK_COST_RATIO, "The sync check landed in one block");
+    }
+};
+
+
+static TimingTests timingTests;